@@ -0,0 +1,119 @@
+#include <string>
+#include <vector>
+
+#include <graphics/skyline_packer.hpp>
+#include <graphics/texture_atlas.hpp>
+
+#include "benchmark.hpp"
+
+namespace {
+
+    using namespace chrome;
+
+    struct image_size { std::uint32_t width, height; };
+
+    // A tab strip worth of UI images: mostly favicons, some toolbar icons and a few tab rasters.
+    auto make_ui_image_sizes(std::size_t const count) {
+
+        benchmark::random random;
+        std::vector<image_size> sizes;
+        sizes.reserve(count);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            auto kind = random.next(0, 9);
+            if (kind < 7) { auto side = random.next(1, 2) * 16; sizes.push_back({ side, side }); }
+            else if (kind < 9) sizes.push_back({ random.next(20, 48), random.next(20, 48) });
+            else sizes.push_back({ random.next(200, 462), random.next(28, 56) });
+        }
+
+        return sizes;
+
+    }
+
+    auto make_keys(std::size_t const count) {
+
+        std::vector<std::string> keys;
+        keys.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) keys.push_back("media/favicon_" + std::to_string(i) + ".png");
+
+        return keys;
+
+    }
+
+}
+
+auto register_atlas_benchmarks(benchmark::suite& suite) -> void {
+
+    suite.add("atlas/skyline_pack_500_ui_images", [sizes = make_ui_image_sizes(500)](benchmark::context& context) {
+
+        auto occupancy = 0.0f;
+        auto packed = 0u;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            graphics::skyline_packer packer { 2048, 2048 };
+            packed = 0;
+            for (auto& [width, height] : sizes) packed += packer.pack(width + 2, height + 2).has_value();
+
+            occupancy = packer.get_occupancy();
+            benchmark::do_not_optimize(occupancy);
+
+        }
+
+        context.set_counter("packed", packed);
+        context.set_counter("occupancy", occupancy);
+
+    });
+
+    suite.add("atlas/allocate_1000_ui_images_with_growth", [sizes = make_ui_image_sizes(1000), keys = make_keys(1000)](benchmark::context& context) {
+
+        graphics::texture_atlas atlas;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            atlas = graphics::texture_atlas { 512, 2048, 1 };
+            for (std::size_t k = 0; k < sizes.size(); ++k) atlas.allocate(keys[k], sizes[k].width, sizes[k].height);
+
+            benchmark::do_not_optimize(atlas);
+
+        }
+
+        context.set_counter("pages", atlas.get_page_count());
+        context.set_counter("occupancy", atlas.get_occupancy());
+
+    });
+
+    suite.add("atlas/repack_after_releasing_half", [sizes = make_ui_image_sizes(1000), keys = make_keys(1000)](benchmark::context& context) {
+
+        graphics::texture_atlas atlas;
+        auto occupancy_before = 0.0f;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            atlas = graphics::texture_atlas { 512, 2048, 1 };
+            for (std::size_t k = 0; k < sizes.size(); ++k) atlas.allocate(keys[k], sizes[k].width, sizes[k].height);
+            for (std::size_t k = 0; k < sizes.size(); k += 2) atlas.release(keys[k]);
+
+            occupancy_before = atlas.get_occupancy();
+            auto moves = atlas.repack();
+            benchmark::do_not_optimize(moves);
+
+        }
+
+        context.set_counter("occupancy_before", occupancy_before);
+        context.set_counter("occupancy_after", atlas.get_occupancy());
+        context.set_counter("pages", atlas.get_page_count());
+
+    });
+
+    suite.add("atlas/extrude_edges_462x56", [](benchmark::context& context) {
+
+        graphics::bitmap tab_raster { 462, 56 };
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            auto padded = graphics::extrude_edges(tab_raster, 1);
+            benchmark::do_not_optimize(padded);
+        }
+
+    });
+
+}
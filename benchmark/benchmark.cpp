@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+
+#include <utility/command_line.hpp>
+
+#include "benchmark.hpp"
+
+namespace benchmark {
+
+    namespace {
+
+        using clock = std::chrono::steady_clock;
+
+        auto time_run(function const& benchmark, context& run_context) {
+
+            auto start = clock::now();
+            benchmark(run_context);
+            return std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+        }
+
+        auto escape_json(std::string_view text) {
+
+            std::string result;
+            result.reserve(text.size());
+
+            for (auto character : text) {
+                if (character == '"' || character == '\\') { result += '\\'; result += character; }
+                else if (static_cast<unsigned char>(character) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(character));
+                    result += buffer;
+                }
+                else result += character;
+            }
+
+            return result;
+
+        }
+
+    }
+
+    auto context::set_counter(std::string name, double const value) -> void {
+
+        for (auto& [counter_name, counter_value] : counters)
+            if (counter_name == name) { counter_value = value; return; }
+
+        counters.emplace_back(std::move(name), value);
+
+    }
+
+    auto parse_options(int const argument_count, char const* const arguments[]) -> std::optional<options> {
+
+        options result;
+        auto has_filter = false;
+
+        for (auto i = 1; i < argument_count; ++i) {
+
+            auto argument = std::string_view { arguments[i] };
+            auto number = 0;
+
+            if (argument.substr(0, 7) == "--json=") result.json_path = argument.substr(7);
+            else if (utility::parse_number_argument(argument, "--repetitions=", number)) result.repetitions = number;
+            else if (utility::parse_number_argument(argument, "--min-time-ms=", number)) result.minimum_run_time = std::chrono::milliseconds(number);
+            else if (argument.substr(0, 2) != "--" && !has_filter) { result.filter = argument; has_filter = true; }
+            else return std::nullopt;
+
+        }
+
+        return result;
+
+    }
+
+    auto suite::add(std::string name, function benchmark) -> void {
+        _benchmarks.emplace_back(std::move(name), std::move(benchmark));
+    }
+
+    auto suite::add_check(std::string name, check correctness_check) -> void {
+        _checks.emplace_back(std::move(name), std::move(correctness_check));
+    }
+
+    auto suite::set_property(std::string name, std::string value) -> void {
+        _properties.emplace_back(std::move(name), std::move(value));
+    }
+
+    auto suite::run(options const& run_options) -> int {
+
+        // With JSON on standard output the table goes to standard error, so the output stays parseable.
+        auto table = run_options.json_path == "-" ? stderr : stdout;
+
+        _check_results.clear();
+        auto failed_checks = 0;
+
+        for (auto& [name, correctness_check] : _checks) {
+
+            if (name.find(run_options.filter) == std::string::npos) continue;
+
+            std::string failure;
+            auto passed = correctness_check(failure);
+
+            if (passed) std::fprintf(table, "%-48s %16s\n", name.c_str(), "ok");
+            else { std::fprintf(table, "%-48s %16s  %s\n", name.c_str(), "FAILED", failure.c_str()); ++failed_checks; }
+
+            _check_results.push_back({ name, passed, std::move(failure) });
+
+        }
+
+        std::fprintf(table, "%-48s %16s %12s\n", "benchmark", "ns/iteration", "iterations");
+
+        auto minimum_run_time = std::chrono::duration<double, std::nano>(run_options.minimum_run_time).count();
+        std::vector<result> results;
+
+        for (auto& [name, benchmark] : _benchmarks) {
+
+            if (name.find(run_options.filter) == std::string::npos) continue;
+
+            // Grow the iteration count until a run is long enough to be timed reliably.
+            context run_context;
+            while (time_run(benchmark, run_context) < minimum_run_time) run_context.iterations *= 2;
+
+            std::vector<double> samples;
+            for (auto i = 0; i < run_options.repetitions; ++i)
+                samples.push_back(time_run(benchmark, run_context) / static_cast<double>(run_context.iterations));
+
+            std::sort(samples.begin(), samples.end());
+
+            auto& benchmark_result = results.emplace_back(result {
+                name, run_context.iterations, samples[samples.size() / 2], samples.front(), samples.back(), run_context.counters
+            });
+
+            std::fprintf(table, "%-48s %16.1f %12llu", name.c_str(), benchmark_result.median_ns,
+                static_cast<unsigned long long>(benchmark_result.iterations));
+            for (auto& [counter_name, counter_value] : benchmark_result.counters)
+                std::fprintf(table, "  %s=%g", counter_name.c_str(), counter_value);
+            std::fprintf(table, "\n");
+
+        }
+
+        if (!run_options.json_path.empty() && !write_json(run_options, results)) {
+            std::fprintf(stderr, "Failed to write %s\n", run_options.json_path.c_str());
+            return 1;
+        }
+
+        return failed_checks > 0 ? 1 : 0;
+
+    }
+
+    auto suite::write_json(options const& run_options, std::vector<result> const& results) const -> bool {
+
+        auto to_stdout = run_options.json_path == "-";
+        auto file = to_stdout ? stdout : std::fopen(run_options.json_path.c_str(), "w");
+        if (file == nullptr) return false;
+
+        std::fprintf(file, "{\n  \"context\": {\n");
+        std::fprintf(file, "    \"repetitions\": %d,\n    \"minimum_run_time_ms\": %lld",
+            run_options.repetitions, static_cast<long long>(run_options.minimum_run_time.count()));
+        for (auto& [name, value] : _properties)
+            std::fprintf(file, ",\n    \"%s\": \"%s\"", escape_json(name).c_str(), escape_json(value).c_str());
+        std::fprintf(file, "\n  },\n");
+
+        std::fprintf(file, "  \"checks\": [");
+        auto first = true;
+        for (auto& [name, passed, failure] : _check_results) {
+            std::fprintf(file, "%s\n    { \"name\": \"%s\", \"passed\": %s", first ? "" : ",", escape_json(name).c_str(), passed ? "true" : "false");
+            if (!passed) std::fprintf(file, ", \"failure\": \"%s\"", escape_json(failure).c_str());
+            std::fprintf(file, " }");
+            first = false;
+        }
+        std::fprintf(file, "%s],\n", first ? "" : "\n  ");
+
+        std::fprintf(file, "  \"benchmarks\": [");
+        first = true;
+        for (auto& [name, iterations, median_ns, minimum_ns, maximum_ns, counters] : results) {
+
+            std::fprintf(file, "%s\n    {\n      \"name\": \"%s\",\n      \"iterations\": %llu,\n", first ? "" : ",",
+                escape_json(name).c_str(), static_cast<unsigned long long>(iterations));
+            std::fprintf(file, "      \"median_ns\": %.3f,\n      \"minimum_ns\": %.3f,\n      \"maximum_ns\": %.3f,\n",
+                median_ns, minimum_ns, maximum_ns);
+
+            std::fprintf(file, "      \"counters\": {");
+            auto first_counter = true;
+            for (auto& [counter_name, counter_value] : counters) {
+                std::fprintf(file, "%s \"%s\": %.17g", first_counter ? "" : ",", escape_json(counter_name).c_str(), counter_value);
+                first_counter = false;
+            }
+            std::fprintf(file, "%s}\n    }", first_counter ? "" : " ");
+
+            first = false;
+
+        }
+        std::fprintf(file, "%s]\n}\n", first ? "" : "\n  ");
+
+        if (to_stdout) return std::fflush(file) == 0;
+        return std::fclose(file) == 0;
+
+    }
+
+}
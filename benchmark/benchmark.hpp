@@ -0,0 +1,128 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Minimal benchmark harness, enough to time the portable parts of the renderer on any platform.
+// Every benchmark runs its workload context.iterations times, the harness picks the count.
+// Results go to the console as a table and optionally to a JSON file, for comparing builds.
+
+namespace benchmark {
+
+    struct context {
+
+        std::uint64_t iterations = 1;
+        std::vector<std::pair<std::string, double>> counters;
+
+        // Reported next to the timing, e.g. occupancy of a packed atlas. Last value wins.
+        auto set_counter(std::string name, double const value) -> void;
+
+    };
+
+    using function = std::function<void(context&)>;
+
+    // Returns false and describes what went wrong in failure, e.g. a SIMD kernel disagreeing with its reference.
+    using check = std::function<bool(std::string& failure)>;
+
+    struct options {
+        std::string filter;                 // Only names containing it run.
+        std::string json_path;              // Empty for none, "-" for standard output.
+        int repetitions = 5;                // The median of these is reported.
+        std::chrono::milliseconds minimum_run_time { 20 };
+    };
+
+    // Accepts [filter] [--json=path] [--repetitions=n] [--min-time-ms=n], nothing on anything else.
+    auto parse_options(int const argument_count, char const* const arguments[]) -> std::optional<options>;
+
+    struct result {
+        std::string name;
+        std::uint64_t iterations;
+        double median_ns, minimum_ns, maximum_ns;   // Per iteration, across repetitions.
+        std::vector<std::pair<std::string, double>> counters;
+    };
+
+    struct check_result {
+        std::string name;
+        bool passed;
+        std::string failure;
+    };
+
+    struct suite {
+
+        auto add(std::string name, function benchmark) -> void;
+
+        // Checks run ahead of the benchmarks, timing code that computes the wrong thing is pointless.
+        auto add_check(std::string name, check correctness_check) -> void;
+
+        // Written to the JSON context, e.g. the compiler or the instruction set the kernels picked.
+        auto set_property(std::string name, std::string value) -> void;
+
+        // Runs every matching check and benchmark, returns the process exit code.
+        // Any failed check makes it nonzero.
+        auto run(options const& run_options) -> int;
+
+    private:
+
+        auto write_json(options const& run_options, std::vector<result> const& results) const -> bool;
+
+        std::vector<std::pair<std::string, function>> _benchmarks;
+        std::vector<std::pair<std::string, check>> _checks;
+        std::vector<std::pair<std::string, std::string>> _properties;
+        std::vector<check_result> _check_results; // Filled by run.
+
+    };
+
+    // Keeps the optimizer from discarding work whose result is otherwise unused.
+    template <typename T>
+    inline auto do_not_optimize(T const& value) -> void {
+#if defined(_MSC_VER)
+        static_cast<void>(*static_cast<volatile char const*>(static_cast<void const*>(&value)));
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    // Fixed seed xorshift, unlike <random> distributions it produces the same sequence everywhere.
+    struct random {
+
+        explicit random(std::uint64_t const seed = 0x9e3779b97f4a7c15ull) : _state(seed ? seed : 1) {}
+
+        auto next() -> std::uint64_t {
+            _state ^= _state << 13; _state ^= _state >> 7; _state ^= _state << 17;
+            return _state;
+        }
+
+        // Uniform-ish integer in [minimum, maximum].
+        auto next(std::uint32_t const minimum, std::uint32_t const maximum) -> std::uint32_t {
+            return minimum + static_cast<std::uint32_t>(next() % (static_cast<std::uint64_t>(maximum) - minimum + 1));
+        }
+
+    private:
+
+        std::uint64_t _state;
+
+    };
+
+    // Stands in for steady_clock in anything taking its clock as a parameter, time only passes when told to.
+    struct manual_clock {
+
+        using duration = std::chrono::steady_clock::duration;
+        using time_point = std::chrono::steady_clock::time_point;
+
+        auto now() const { return current; }
+
+        time_point current {};
+
+    };
+
+}
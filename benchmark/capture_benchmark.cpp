@@ -0,0 +1,217 @@
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <graphics/bitmap.hpp>
+#include <graphics/frame_capture.hpp>
+#include <graphics/layer_tree.hpp>
+#include <graphics/software_compositor.hpp>
+#include <gui/mock_scene.hpp>
+
+#include "benchmark.hpp"
+#include "mock_scene_fixture.hpp"
+
+namespace {
+
+    using namespace chrome;
+
+    // A window's layers at 150%, the same tree window::render hands to the renderer.
+    struct captured_window {
+
+        static constexpr std::uint32_t width = 1500, height = 960;
+        static constexpr auto dpi = 144.0f;
+
+        gui::mock_scene scene;
+        graphics::layer_tree layers;
+
+        benchmark::mock_images images;
+
+        captured_window() {
+            scene.add_layers(layers);
+            scene.layout(layers, benchmark::make_client_area(width / 1.5f, height / 1.5f), benchmark::frame_height);
+            scene.record_layers(layers);
+        }
+
+        // By path rather than by pointer, so the images a capture reads back resolve the same.
+        auto image_provider() {
+            return [this](resource::image const& image) -> graphics::bitmap const* {
+                return image.get_file_path() == scene.get_tab_raster()->get_file_path() ? &images.tab_raster : &images.new_tab_symbol;
+            };
+        }
+
+        auto image_sizes() {
+            return [this](resource::image const& image) -> std::optional<measure::size<std::uint32_t>> {
+                auto& pixels = *image_provider()(image);
+                return measure::size<std::uint32_t> { pixels.width, pixels.height };
+            };
+        }
+
+        auto write() {
+            std::ostringstream output;
+            graphics::write_frame_capture(output, layers, { width, height }, dpi, image_sizes());
+            return output.str();
+        }
+
+        auto composite(graphics::layer_tree const& tree) {
+            graphics::software_compositor compositor { width, height, dpi };
+            compositor.set_image_provider(image_provider());
+            compositor.render_layers(tree);
+            return compositor.get_target().pixels;
+        }
+
+    };
+
+    auto read(std::string const& bytes) {
+        std::istringstream input { bytes };
+        return graphics::read_frame_capture(input);
+    }
+
+}
+
+auto register_capture_benchmarks(benchmark::suite& suite) -> void {
+
+    suite.add_check("frame_capture/roundtrip_composites_identically", [](std::string& failure) {
+
+        captured_window window;
+        auto bytes = window.write();
+        auto capture = read(bytes);
+
+        if (capture.surface_size.width != window.width || capture.surface_size.height != window.height || capture.dpi != window.dpi) {
+            failure = "surface size or dpi changed";
+            return false;
+        }
+
+        if (capture.images.size() != 2 || capture.images[0].size.width == 0) {
+            failure = "expected both mock images with their sizes";
+            return false;
+        }
+
+        if (window.composite(capture.layers) != window.composite(window.layers)) {
+            failure = "the replayed frame differs from the captured one";
+            return false;
+        }
+
+        // Writing what was read gives back the same file, nothing is lost or reordered.
+        std::ostringstream output;
+        graphics::write_frame_capture(output, capture.layers, capture.surface_size, capture.dpi, window.image_sizes());
+
+        if (output.str() != bytes) {
+            failure = "capturing the replayed tree gives a different file";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("frame_capture/rejects_damaged_files", [](std::string& failure) {
+
+        captured_window window;
+        auto bytes = window.write();
+
+        auto rejects = [](std::string const& damaged) {
+            try { read(damaged); }
+            catch (std::runtime_error const&) { return true; }
+            catch (...) {}
+            return false;
+        };
+
+        for (std::size_t length = 0; length < bytes.size(); length += 7) {
+            if (!rejects(bytes.substr(0, length))) {
+                failure = "a capture cut off after " + std::to_string(length) + " bytes was accepted";
+                return false;
+            }
+        }
+
+        auto wrong_magic = bytes;
+        wrong_magic[0] = 'X';
+
+        auto wrong_version = bytes;
+        wrong_version[4] = 9;
+
+        if (!rejects(wrong_magic) || !rejects(wrong_version)) {
+            failure = "a capture with a wrong magic or version was accepted";
+            return false;
+        }
+
+        // Hand built headers claiming far more than they hold: magic, version, surface size, DPI, then the
+        // image table and the font count.
+        auto make_header = [&](measure::size<std::uint32_t> const& surface_size, std::string_view tables) {
+
+            std::string header = bytes.substr(0, 8);
+            header.append(reinterpret_cast<char const*>(&surface_size), sizeof(surface_size));
+            header.append(bytes.substr(16, 4));
+
+            return header.append(tables);
+
+        };
+
+        auto as_bytes = [](auto const... values) {
+            std::string result;
+            (result.append(reinterpret_cast<char const*>(&values), sizeof(values)), ...);
+            return result;
+        };
+
+        struct damaged_case { std::string_view description; std::string capture; } cases[] = {
+            { "60 million fonts", make_header({ 1280, 720 }, as_bytes(0u, 60'000'000u)) },
+            { "4 billion fonts", make_header({ 1280, 720 }, as_bytes(0u, 0xfffffff0u)) },
+            { "4 billion images", make_header({ 1280, 720 }, as_bytes(0xfffffff0u)) },
+            { "a 4 billion pixel wide surface", make_header({ 0xffffffffu, 720 }, as_bytes(0u, 0u, 0u)) },
+            { "a 100000 pixel tall image", make_header({ 1280, 720 }, as_bytes(1u, 'a', 1000u, 100000u, 0u, 0u)) }
+        };
+
+        for (auto& [description, capture] : cases) {
+            if (!rejects(capture)) {
+                failure = "a capture with " + std::string { description } + " was accepted";
+                return false;
+            }
+        }
+
+        return true;
+
+    });
+
+    suite.add("frame_capture/write_mock_scene", [](benchmark::context& context) {
+
+        captured_window window;
+        auto sizes = window.image_sizes();
+        std::ostringstream output;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            output.str({});
+            graphics::write_frame_capture(output, window.layers, { window.width, window.height }, window.dpi, sizes);
+        }
+
+        benchmark::do_not_optimize(output);
+        context.set_counter("bytes", static_cast<double>(output.str().size()));
+
+    });
+
+    suite.add("frame_capture/read_mock_scene", [](benchmark::context& context) {
+
+        captured_window window;
+        auto bytes = window.write();
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            auto capture = read(bytes);
+            benchmark::do_not_optimize(capture.layers);
+        }
+
+    });
+
+    // Everything is pending in a capture that was just read, so every iteration is a full frame.
+    suite.add("frame_capture/replay_mock_scene_software_compositor", [](benchmark::context& context) {
+
+        captured_window window;
+        auto capture = read(window.write());
+
+        graphics::software_compositor compositor { window.width, window.height, window.dpi };
+        compositor.set_image_provider(window.image_provider());
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) compositor.render_layers(capture.layers);
+
+        benchmark::do_not_optimize(compositor.get_target().pixels.data());
+
+    });
+
+}
@@ -0,0 +1,153 @@
+#include <chrono>
+#include <string>
+
+#include <gui/frame_scheduler.hpp>
+
+#include "benchmark.hpp"
+
+namespace {
+
+    using namespace std::chrono_literals;
+
+    using scheduler = chrome::gui::basic_frame_scheduler<benchmark::manual_clock>;
+
+    // A round refresh interval keeps the expected timeouts exact.
+    auto make_scheduler() { return scheduler { {}, 16ms }; }
+
+    auto to_string(std::optional<scheduler::duration> const& timeout) -> std::string {
+        if (!timeout) return "forever";
+        return std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(*timeout).count()) + "us";
+    }
+
+}
+
+auto register_frame_scheduler_benchmarks(benchmark::suite& suite) -> void {
+
+    suite.add_check("frame_scheduler/coalesces_requests", [](std::string& failure) {
+
+        auto frames = make_scheduler();
+
+        if (frames.get_wait_timeout()) { failure = "an idle scheduler wakes the loop"; return false; }
+
+        frames.request_frame();
+        frames.request_frame();
+        frames.request_frame();
+
+        if (frames.get_wait_timeout() != scheduler::duration::zero()) { failure = "the first frame isn't due right away"; return false; }
+        if (!frames.begin_frame() || frames.begin_frame()) { failure = "three requests didn't make exactly one frame"; return false; }
+        if (frames.has_pending_frame() || frames.get_frame_count() != 1) { failure = "a frame is still pending after painting"; return false; }
+
+        return true;
+
+    });
+
+    suite.add_check("frame_scheduler/stays_on_refresh_slots", [](std::string& failure) {
+
+        auto frames = make_scheduler();
+        auto& clock = frames.get_clock();
+        auto start = clock.current;
+
+        frames.request_frame();
+        frames.begin_frame();
+
+        // Asked for 5ms into the slot, painted at its end.
+        clock.current += 5ms;
+        frames.request_frame();
+
+        if (frames.get_wait_timeout() != 11ms) { failure = "waits " + to_string(frames.get_wait_timeout()) + " for the next slot, expected 11ms"; return false; }
+        if (frames.begin_frame()) { failure = "painted ahead of the refresh slot"; return false; }
+
+        clock.current = start + 16ms;
+        if (!frames.begin_frame()) { failure = "didn't paint on the refresh slot"; return false; }
+
+        // Woken a millisecond late, the frame still counts for its slot so the next one isn't pushed back.
+        clock.current = start + 33ms;
+        frames.request_frame();
+        if (!frames.begin_frame()) { failure = "didn't paint a late frame"; return false; }
+
+        frames.request_frame();
+        if (frames.get_wait_timeout() != 15ms) { failure = "drifted off the cadence, waits " + to_string(frames.get_wait_timeout()); return false; }
+
+        return true;
+
+    });
+
+    suite.add_check("frame_scheduler/resyncs_after_idling", [](std::string& failure) {
+
+        auto frames = make_scheduler();
+        auto& clock = frames.get_clock();
+
+        frames.request_frame();
+        frames.begin_frame();
+
+        // Nothing to do for a while, the next request paints right away and starts a new cadence from there.
+        clock.current += 100ms;
+        frames.request_frame();
+
+        if (frames.get_wait_timeout() != scheduler::duration::zero()) { failure = "waits " + to_string(frames.get_wait_timeout()) + " after idling"; return false; }
+        if (!frames.begin_frame()) { failure = "didn't paint after idling"; return false; }
+
+        clock.current += 2ms;
+        frames.request_frame();
+        if (frames.get_wait_timeout() != 14ms) { failure = "the cadence wasn't restarted, waits " + to_string(frames.get_wait_timeout()); return false; }
+
+        return true;
+
+    });
+
+    suite.add_check("frame_scheduler/earliest_deadline_wins", [](std::string& failure) {
+
+        auto frames = make_scheduler();
+        auto& clock = frames.get_clock();
+
+        frames.request_frame();
+        frames.begin_frame();
+
+        auto start = clock.current;
+        frames.request_frame_at(start + 50ms);
+        frames.request_frame_at(start + 30ms);
+        frames.request_frame_at(start + 40ms);
+
+        if (frames.get_wait_timeout() != 30ms) { failure = "waits " + to_string(frames.get_wait_timeout()) + " for deadlines at 30, 40 and 50ms"; return false; }
+
+        clock.current = start + 29ms;
+        if (frames.begin_frame()) { failure = "painted ahead of the deadline"; return false; }
+
+        clock.current = start + 30ms;
+        if (!frames.begin_frame() || frames.has_pending_frame()) { failure = "the deadline didn't make exactly one frame"; return false; }
+
+        // That frame took the 16ms slot, so a deadline ahead of the next one at 32ms waits for it.
+        frames.request_frame_at(start + 31ms);
+        if (frames.get_wait_timeout() != 2ms) { failure = "a deadline jumped the refresh slot, waits " + to_string(frames.get_wait_timeout()); return false; }
+
+        return true;
+
+    });
+
+    suite.add_check("frame_scheduler/hidden_windows_idle", [](std::string& failure) {
+
+        auto frames = make_scheduler();
+        auto& clock = frames.get_clock();
+
+        frames.set_visible(false);
+        frames.request_frame();
+        frames.request_frame_at(clock.current + 5ms);
+
+        clock.current += 10ms;
+        if (frames.get_wait_timeout() || frames.begin_frame()) { failure = "a hidden window woke the loop or painted"; return false; }
+
+        // Shown again, it repaints whether or not anything was requested meanwhile.
+        frames.set_visible(true);
+        if (frames.get_wait_timeout() != scheduler::duration::zero() || !frames.begin_frame()) { failure = "showing the window didn't repaint"; return false; }
+
+        frames.set_visible(false);
+        clock.current += 100ms;
+        frames.set_visible(true);
+
+        if (!frames.begin_frame()) { failure = "showing the window without a request didn't repaint"; return false; }
+
+        return true;
+
+    });
+
+}
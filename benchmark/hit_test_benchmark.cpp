@@ -0,0 +1,153 @@
+#include <string>
+#include <vector>
+
+#include <gui/hit_test_map.hpp>
+#include <gui/window_sector.hpp>
+
+#include "benchmark.hpp"
+
+namespace {
+
+    using namespace chrome;
+
+    constexpr auto border = 10;
+    constexpr auto caption_height = 38;
+
+    auto make_window_map(measure::rectangle<std::int32_t> const& window, std::uint32_t const tab_count) {
+
+        gui::hit_test_map map;
+        map.reset(window);
+        map.add_resize_borders(border);
+        map.add_caption({ window.origin.x, window.origin.y, window.dimension.width, caption_height });
+
+        // Tabs shrink to fit, like a browser's tab strip does, followed by the new tab button.
+        auto strip_width = window.dimension.width - 200;
+        auto tab_width = std::max(2, strip_width / static_cast<std::int32_t>(std::max(tab_count, 1u)));
+        for (auto tab = 0u; tab < tab_count; ++tab)
+            map.add_interactive({ window.origin.x + 80 + static_cast<std::int32_t>(tab) * tab_width, window.origin.y + 8, tab_width - 1, 30 }, tab + 1);
+        map.add_interactive({ window.right() - 110, window.origin.y + 12, 28, 24 }, tab_count + 1);
+
+        map.build();
+        return map;
+
+    }
+
+    auto make_points(measure::rectangle<std::int32_t> const& window, std::uint32_t const count, bool const caption_only) {
+
+        benchmark::random random { 11 };
+        std::vector<measure::point<std::int32_t>> points;
+
+        for (auto i = 0u; i < count; ++i) {
+            auto x = window.origin.x + static_cast<std::int32_t>(random.next(0, static_cast<std::uint32_t>(window.dimension.width - 1)));
+            auto height = caption_only ? caption_height + border : window.dimension.height;
+            auto y = window.origin.y + static_cast<std::int32_t>(random.next(0, static_cast<std::uint32_t>(height - 1)));
+            points.emplace_back(x, y);
+        }
+
+        return points;
+
+    }
+
+}
+
+auto register_hit_test_benchmarks(benchmark::suite& suite) -> void {
+
+    // With only borders and a caption registered the map has to agree with the classifier everywhere.
+    suite.add_check("hit_test/map_matches_window_sector_classifier", [](std::string& failure) {
+
+        for (auto [width, height] : { std::pair { 1280, 720 }, std::pair { 33, 21 }, std::pair { 641, 97 } }) {
+
+            auto window = measure::rectangle<std::int32_t> { -7, 13, width, height };
+
+            gui::hit_test_map map { 16 };
+            map.reset(window);
+            map.add_resize_borders(border);
+            map.add_caption({ window.origin.x, window.origin.y, window.dimension.width, caption_height });
+            map.build();
+
+            for (auto y = window.origin.y; y < window.bottom(); ++y) {
+                for (auto x = window.origin.x; x < window.right(); ++x) {
+
+                    auto expected = gui::classify_window_sector(window, { x, y }, border, caption_height);
+                    auto actual = map.hit_test({ x, y }).sector;
+
+                    if (expected != actual) {
+                        failure = std::to_string(width) + "x" + std::to_string(height) + " window, point "
+                            + std::to_string(x) + "," + std::to_string(y) + ": sector "
+                            + std::to_string(static_cast<int>(actual)) + " instead of " + std::to_string(static_cast<int>(expected));
+                        return false;
+                    }
+
+                }
+            }
+
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("hit_test/interactive_regions_win_over_caption", [](std::string& failure) {
+
+        auto window = measure::rectangle<std::int32_t> { 0, 0, 1280, 720 };
+        auto map = make_window_map(window, 100);
+
+        // Every tab has to answer with its own id somewhere inside it.
+        auto tab_width = (window.dimension.width - 200) / 100;
+
+        for (auto tab = 0u; tab < 100u; ++tab) {
+            auto result = map.hit_test({ 80 + static_cast<std::int32_t>(tab) * tab_width + tab_width / 2, 20 });
+            if (result.kind != gui::hit_region_kind::interactive || result.id != tab + 1) {
+                failure = "tab " + std::to_string(tab) + " answered with id " + std::to_string(result.id);
+                return false;
+            }
+        }
+
+        if (map.hit_test({ 40, 20 }).kind != gui::hit_region_kind::caption) { failure = "caption left of the tabs"; return false; }
+        if (map.hit_test({ 5, 5 }).sector != gui::window_sector::top_left) { failure = "top left corner"; return false; }
+
+        return true;
+
+    });
+
+    auto window = measure::rectangle<std::int32_t> { 0, 0, 1920, 1080 };
+
+    suite.add("hit_test/classifier_1024_points", [window, points = make_points(window, 1024, false)](benchmark::context& context) {
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            auto sum = 0u;
+            for (auto& point : points) sum += static_cast<std::uint32_t>(gui::classify_window_sector(window, point, border, caption_height));
+            benchmark::do_not_optimize(sum);
+        }
+
+    });
+
+    for (auto tab_count : { 10u, 500u }) {
+
+        auto name = "hit_test/map_" + std::to_string(tab_count) + "_tabs_1024_caption_points";
+        suite.add(name, [window, tab_count, points = make_points(window, 1024, true)](benchmark::context& context) {
+
+            auto map = make_window_map(window, tab_count);
+
+            for (std::uint64_t i = 0; i < context.iterations; ++i) {
+                auto sum = 0u;
+                for (auto& point : points) sum += map.hit_test(point).id;
+                benchmark::do_not_optimize(sum);
+            }
+
+            context.set_counter("regions", static_cast<double>(map.get_region_count()));
+
+        });
+
+    }
+
+    suite.add("hit_test/map_rebuild_500_tabs", [window](benchmark::context& context) {
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            auto map = make_window_map(window, 500);
+            benchmark::do_not_optimize(map);
+        }
+
+    });
+
+}
@@ -0,0 +1,44 @@
+#include <graphics/image_scaling.hpp>
+
+#include "benchmark.hpp"
+
+auto register_image_scaling_benchmarks(benchmark::suite& suite) -> void {
+
+    using namespace chrome;
+
+    // The tab raster at its source size, and a full HD screenshot sized thumbnail source.
+    auto add_downsample = [&suite](char const* name, std::uint32_t const width, std::uint32_t const height) {
+
+        suite.add(name, [width, height](benchmark::context& context) {
+
+            benchmark::random random;
+            graphics::bitmap source { width, height };
+            for (auto& pixel : source.pixels) pixel = static_cast<std::uint32_t>(random.next()) | 0xff000000u;
+
+            for (std::uint64_t i = 0; i < context.iterations; ++i) {
+                auto half = graphics::downsample_half(source);
+                benchmark::do_not_optimize(half);
+            }
+
+            auto megapixels = static_cast<double>(width) * height / 1e6;
+            context.set_counter("source_megapixels", megapixels);
+
+        });
+
+    };
+
+    add_downsample("image_scaling/downsample_half_462x56", 462, 56);
+    add_downsample("image_scaling/downsample_half_1920x1080", 1920, 1080);
+
+    suite.add("image_scaling/mip_chain_to_level_3_1920x1080", [](benchmark::context& context) {
+
+        graphics::bitmap source { 1920, 1080 };
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            auto level = graphics::build_mip_level(source, 3);
+            benchmark::do_not_optimize(level);
+        }
+
+    });
+
+}
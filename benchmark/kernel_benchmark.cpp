@@ -0,0 +1,168 @@
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <graphics/pixel_kernels.hpp>
+
+#include "benchmark.hpp"
+
+namespace {
+
+    using namespace chrome::graphics;
+
+    constexpr std::size_t benchmark_pixels = 1920 * 64;
+
+    // Every set the CPU runs, the scalar one included.
+    auto get_supported_sets() {
+
+        std::vector<kernels::instruction_set> sets { kernels::instruction_set::scalar };
+        auto best = kernels::detect_instruction_set();
+
+        if (best >= kernels::instruction_set::sse2) sets.push_back(kernels::instruction_set::sse2);
+        if (best >= kernels::instruction_set::avx2) sets.push_back(kernels::instruction_set::avx2);
+
+        return sets;
+
+    }
+
+    auto make_pixels(std::size_t const count, std::uint64_t const seed) {
+
+        benchmark::random random { seed };
+        std::vector<std::uint32_t> pixels(count);
+
+        // Mostly arbitrary, with enough fully opaque and fully transparent pixels to hit the edge cases.
+        for (auto& pixel : pixels) {
+            pixel = static_cast<std::uint32_t>(random.next());
+            auto kind = random.next(0, 7);
+            if (kind == 0) pixel |= 0xff000000u;
+            else if (kind == 1) pixel &= 0x00ffffffu;
+        }
+
+        return pixels;
+
+    }
+
+    auto describe_mismatch(std::string& failure, std::size_t const length, std::size_t const index, std::uint32_t const expected, std::uint32_t const actual) {
+
+        char buffer[128];
+        std::snprintf(buffer, sizeof(buffer), "length %zu, pixel %zu: expected %08x, got %08x", length, index, expected, actual);
+        failure = buffer;
+
+        return false;
+
+    }
+
+    // Runs kernel(table, destination, source) on every length up to a few vector widths past the widest
+    // one and at odd offsets, so both the vector loop and the scalar tail are compared against the reference.
+    template <typename Kernel>
+    auto compare_with_reference(kernels::kernel_table const& table, std::string& failure, Kernel&& kernel) {
+
+        auto& reference = kernels::get_kernels(kernels::instruction_set::scalar);
+        auto source = make_pixels(256, 1);
+        auto initial = make_pixels(256, 2);
+
+        for (std::size_t length = 0; length <= 67; ++length) {
+            for (std::size_t offset = 0; offset < 3; ++offset) {
+
+                auto expected = initial, actual = initial;
+                kernel(reference, expected.data() + offset, source.data() + offset, length);
+                kernel(table, actual.data() + offset, source.data() + offset, length);
+
+                for (std::size_t i = 0; i < expected.size(); ++i)
+                    if (expected[i] != actual[i]) return describe_mismatch(failure, length, i, expected[i], actual[i]);
+
+            }
+        }
+
+        return true;
+
+    }
+
+}
+
+auto register_kernel_benchmarks(benchmark::suite& suite) -> void {
+
+    using pixel = std::uint32_t;
+
+    for (auto set : get_supported_sets()) {
+
+        auto& table = kernels::get_kernels(set);
+        auto prefix = std::string { "kernels/" } + kernels::get_instruction_set_name(set) + "/";
+
+        // Opacity values around the special cased ones and in between.
+        auto opacities = std::array { 0u, 1u, 127u, 128u, 254u, 255u };
+
+        if (set != kernels::instruction_set::scalar) {
+
+            suite.add_check(prefix + "swizzle_rgba_to_bgra", [&table](std::string& failure) {
+                return compare_with_reference(table, failure, [](auto& kernels, pixel* d, pixel const* s, std::size_t n) { kernels.swizzle_rgba_to_bgra(d, s, n); });
+            });
+
+            suite.add_check(prefix + "premultiply", [&table](std::string& failure) {
+                return compare_with_reference(table, failure, [](auto& kernels, pixel* d, pixel const* s, std::size_t n) { kernels.premultiply(d, s, n); });
+            });
+
+            suite.add_check(prefix + "unpremultiply", [&table](std::string& failure) {
+                return compare_with_reference(table, failure, [](auto& kernels, pixel* d, pixel const* s, std::size_t n) { kernels.unpremultiply(d, s, n); });
+            });
+
+            suite.add_check(prefix + "blend_source_over", [&table, opacities](std::string& failure) {
+                for (auto opacity : opacities) {
+                    auto passed = compare_with_reference(table, failure, [opacity](auto& kernels, pixel* d, pixel const* s, std::size_t n) {
+                        kernels.blend_source_over(d, s, n, opacity);
+                    });
+                    if (!passed) { failure = "opacity " + std::to_string(opacity) + ", " + failure; return false; }
+                }
+                return true;
+            });
+
+            suite.add_check(prefix + "fill_and_blend_span", [&table](std::string& failure) {
+                for (auto color : make_pixels(32, 3)) {
+                    auto passed = compare_with_reference(table, failure, [color](auto& kernels, pixel* d, pixel const*, std::size_t n) {
+                        kernels.fill_span(d, n / 2, color);
+                        kernels.blend_span(d + n / 2, n - n / 2, color);
+                    });
+                    if (!passed) return false;
+                }
+                return true;
+            });
+
+            // Rows of the shared source a fixed distance apart, odd lengths exercise the repeated last column.
+            suite.add_check(prefix + "downsample_row", [&table](std::string& failure) {
+                return compare_with_reference(table, failure, [](auto& kernels, pixel* d, pixel const* s, std::size_t n) { kernels.downsample_row(d, s, s + 128, n); });
+            });
+
+        }
+
+        // Throughput over a 64 row band of a 1080p frame.
+        auto add_throughput = [&suite, &prefix](std::string const& name, auto kernel) {
+
+            suite.add(prefix + name, [kernel](benchmark::context& context) {
+
+                auto source = make_pixels(benchmark_pixels, 4);
+                auto destination = make_pixels(benchmark_pixels, 5);
+
+                for (std::uint64_t i = 0; i < context.iterations; ++i) {
+                    kernel(destination.data(), source.data(), benchmark_pixels);
+                    benchmark::do_not_optimize(destination.data());
+                }
+
+                context.set_counter("pixels", static_cast<double>(benchmark_pixels));
+
+            });
+
+        };
+
+        add_throughput("swizzle_rgba_to_bgra", [&table](pixel* d, pixel const* s, std::size_t n) { table.swizzle_rgba_to_bgra(d, s, n); });
+        add_throughput("premultiply", [&table](pixel* d, pixel const* s, std::size_t n) { table.premultiply(d, s, n); });
+        add_throughput("unpremultiply", [&table](pixel* d, pixel const* s, std::size_t n) { table.unpremultiply(d, s, n); });
+        add_throughput("blend_source_over_opacity_255", [&table](pixel* d, pixel const* s, std::size_t n) { table.blend_source_over(d, s, n, 255u); });
+        add_throughput("blend_source_over_opacity_128", [&table](pixel* d, pixel const* s, std::size_t n) { table.blend_source_over(d, s, n, 128u); });
+        add_throughput("fill_span", [&table](pixel* d, pixel const*, std::size_t n) { table.fill_span(d, n, 0xff202124u); });
+        add_throughput("blend_span", [&table](pixel* d, pixel const*, std::size_t n) { table.blend_span(d, n, 0x80101010u); });
+        add_throughput("downsample_row", [&table](pixel* d, pixel const* s, std::size_t n) { table.downsample_row(d, s, s + n / 2, n / 2); });
+
+    }
+
+}
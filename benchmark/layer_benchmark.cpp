@@ -0,0 +1,418 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <graphics/layer_tree.hpp>
+#include <graphics/software_compositor.hpp>
+#include <graphics/software_renderer.hpp>
+#include <graphics/surface_sizing.hpp>
+#include <gui/live_resize.hpp>
+#include <gui/mock_scene.hpp>
+
+#include "benchmark.hpp"
+#include "mock_scene_fixture.hpp"
+
+namespace {
+
+    using namespace chrome;
+
+    struct mock_scene_layers {
+
+        gui::mock_scene scene;
+        graphics::layer_tree layers;
+
+        mock_scene_layers(float const width, float const height) {
+            scene.add_layers(layers);
+            resize(width, height);
+        }
+
+        // What window::paint does with a new client size, minus the drawing.
+        auto resize(float const width, float const height) -> void {
+            scene.layout(layers, benchmark::make_client_area(width, height), benchmark::frame_height);
+            scene.record_layers(layers);
+        }
+
+        auto get(gui::mock_layer const layer) const -> graphics::layer const& {
+            return layers.get(scene.get_layer_id(layer));
+        }
+
+    };
+
+    auto get_content_extent(graphics::layer const& layer) {
+        return measure::size<std::uint32_t> {
+            static_cast<std::uint32_t>(std::ceil(layer.content_size.width)), static_cast<std::uint32_t>(std::ceil(layer.content_size.height))
+        };
+    }
+
+    // Stands in for the surfaces renderer::render_layers keeps per layer, counts how often they're reallocated.
+    struct surface_tracker {
+
+        std::unordered_map<graphics::layer_id, measure::size<std::uint32_t>> surfaces;
+        std::uint64_t reallocations = 0;
+
+        auto sync(graphics::layer_tree const& layers, bool const is_live_resizing) -> void {
+
+            for (auto id : layers.get_draw_order()) {
+
+                auto& layer = layers.get(id);
+                if (!layer.content_changed) continue;
+
+                auto content = get_content_extent(layer);
+                auto& current = surfaces[id];
+                auto size = graphics::get_surface_size(current, content, is_live_resizing);
+
+                if (size.width != current.width || size.height != current.height) ++reallocations;
+                current = size;
+
+            }
+
+        }
+
+    };
+
+}
+
+auto register_layer_benchmarks(benchmark::suite& suite) -> void {
+
+    suite.add_check("layers/resize_changes_only_what_depends_on_size", [](std::string& failure) {
+
+        mock_scene_layers mock { 1280.0f, 720.0f };
+        mock.layers.clear_changes();
+
+        // Shrinking keeps the static sidebar, width dependent layers are recorded again.
+        mock.resize(1000.0f, 600.0f);
+
+        auto& sidebar = mock.get(gui::mock_layer::sidebar);
+        if (sidebar.content_changed || !sidebar.geometry_changed) {
+            failure = "shrinking re-recorded the static sidebar or didn't clip it";
+            return false;
+        }
+
+        if (!mock.get(gui::mock_layer::toolbar).content_changed || !mock.get(gui::mock_layer::tab_strip).content_changed) {
+            failure = "width dependent layers weren't recorded again";
+            return false;
+        }
+
+        if (mock.layers.has_order_changed()) {
+            failure = "resizing changed the stacking order";
+            return false;
+        }
+
+        mock.layers.clear_changes();
+
+        // Growing past what's recorded has to record it again, at the larger size.
+        mock.resize(1000.0f, 900.0f);
+
+        if (!sidebar.content_changed || sidebar.content_size.height < sidebar.bounds.dimension.height) {
+            failure = "growing past the recorded content kept the sidebar";
+            return false;
+        }
+
+        mock.layers.clear_changes();
+
+        // Same size again, nothing to do.
+        mock.resize(1000.0f, 900.0f);
+
+        if (mock.layers.has_changes()) {
+            failure = "laying out the same size left changes behind";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("layers/draw_order_and_damage", [](std::string& failure) {
+
+        graphics::layer_tree layers;
+        auto background = layers.add("background");
+        auto panel = layers.add("panel");
+        auto badge = layers.add("badge", panel);
+        auto overlay = layers.add("overlay");
+
+        layers.set_bounds(background, { 0.0f, 0.0f, 800.0f, 600.0f });
+        layers.set_bounds(panel, { 100.0f, 100.0f, 200.0f, 200.0f });
+        layers.set_bounds(badge, { 150.0f, 10.0f, 100.0f, 20.0f }); // Half outside the panel.
+        layers.set_bounds(overlay, { 0.0f, 0.0f, 50.0f, 50.0f });
+
+        // Raising the panel above the overlay takes its child along.
+        layers.set_z_index(panel, 1);
+
+        auto expected = std::vector<graphics::layer_id> { background, overlay, panel, badge };
+        if (layers.get_draw_order() != expected) {
+            failure = "unexpected draw order";
+            return false;
+        }
+
+        auto visible = layers.get_visible_bounds(badge);
+        if (visible.origin.x != 250.0f || visible.dimension.width != 50.0f || visible.origin.y != 110.0f) {
+            failure = "the badge isn't clipped by its parent";
+            return false;
+        }
+
+        layers.clear_changes();
+        layers.invalidate(measure::rectangle<float> { 260.0f, 105.0f, 10.0f, 10.0f });
+
+        // Damage lands in layer local coordinates, only on layers it touches.
+        auto& badge_damage = layers.get(badge).damage;
+        auto damaged = badge_damage.get_bounds();
+        if (badge_damage.empty() || damaged.origin.x != 10.0f || damaged.origin.y != 0.0f || damaged.dimension.height != 5.0f) {
+            failure = "badge damage isn't in its local coordinates";
+            return false;
+        }
+
+        if (!layers.get(overlay).damage.empty() || layers.get(panel).damage.empty() || layers.get(background).damage.empty()) {
+            failure = "damage reached the wrong layers";
+            return false;
+        }
+
+        layers.remove(panel);
+        auto& removed = layers.get_removed();
+        if (removed.size() != 2 || layers.get_draw_order() != std::vector<graphics::layer_id> { background, overlay }) {
+            failure = "removing the panel didn't take the badge along";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("layers/composited_layers_match_single_surface", [](std::string& failure) {
+
+        auto const width = 1280u, height = 720u;
+
+        benchmark::mock_images images;
+        mock_scene_layers mock { static_cast<float>(width), static_cast<float>(height) };
+        auto provider = images.provider(mock.scene);
+
+        // Shrunk first, so the sidebar is composited out of content larger than what's visible.
+        mock.resize(1400.0f, 900.0f);
+        mock.resize(static_cast<float>(width), static_cast<float>(height));
+
+        graphics::software_compositor compositor { width, height };
+        compositor.set_image_provider(provider);
+        compositor.render_layers(mock.layers);
+
+        auto& composited = compositor.get_target();
+
+        graphics::command_list commands;
+        mock.scene.record(commands, benchmark::make_client_area(static_cast<float>(width), static_cast<float>(height)), benchmark::frame_height);
+
+        graphics::software_renderer renderer { width, height };
+        renderer.set_image_provider(provider);
+        renderer.begin_draw();
+        renderer.execute(commands);
+        renderer.end_draw();
+
+        // Blending over transparent layers can round differently from blending in place.
+        auto& reference = renderer.get_target().pixels;
+        for (std::size_t i = 0; i < reference.size(); ++i) {
+            for (auto shift = 0u; shift < 32u; shift += 8u) {
+                auto lhs = static_cast<int>((composited.pixels[i] >> shift) & 0xffu), rhs = static_cast<int>((reference[i] >> shift) & 0xffu);
+                if (std::abs(lhs - rhs) > 1) {
+                    failure = "pixel " + std::to_string(i % width) + "," + std::to_string(i / width) + " differs";
+                    return false;
+                }
+            }
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("layers/live_resize_reallocates_per_bucket", [](std::string& failure) {
+
+        mock_scene_layers mock { 1280.0f, 720.0f };
+        surface_tracker exact, bucketed;
+
+        exact.sync(mock.layers, false);
+        bucketed.sync(mock.layers, false);
+        exact.reallocations = bucketed.reallocations = 0;
+        mock.layers.clear_changes();
+
+        // Sizes exactly to the content outside of a live resize, as a bucket of one would.
+        auto exact_sync = [&] {
+            for (auto id : mock.layers.get_draw_order()) {
+                auto& layer = mock.layers.get(id);
+                if (!layer.content_changed) continue;
+                auto content = get_content_extent(layer);
+                auto& current = exact.surfaces[id];
+                if (content.width != current.width || content.height != current.height) ++exact.reallocations;
+                current = content;
+            }
+        };
+
+        for (auto step = 0; step < 200; ++step) {
+
+            auto delta = static_cast<float>(step < 100 ? step : 200 - step) * 3.0f;
+            mock.resize(1280.0f - delta, 720.0f - delta);
+
+            exact_sync();
+            bucketed.sync(mock.layers, true);
+            mock.layers.clear_changes();
+
+        }
+
+        if (bucketed.reallocations * 10 > exact.reallocations) {
+            failure = "bucketed surfaces reallocated " + std::to_string(bucketed.reallocations) + " times, exact ones " + std::to_string(exact.reallocations);
+            return false;
+        }
+
+        // Settling after the drag trims every surface to the bucket its content falls in, never below it.
+        for (auto& [id, size] : bucketed.surfaces) {
+
+            auto content = get_content_extent(mock.layers.get(id));
+            auto settled = graphics::get_surface_size(size, content, false);
+
+            if (settled.width < content.width || settled.height < content.height
+                || settled.width >= content.width + graphics::surface_bucket || settled.height >= content.height + graphics::surface_bucket) {
+                failure = "a settled surface doesn't fit its content within a bucket";
+                return false;
+            }
+
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("layers/live_resize_throttles_redraws", [](std::string& failure) {
+
+        using namespace std::chrono_literals;
+
+        gui::basic_live_resize<benchmark::manual_clock> resize; // Redraws at 30Hz.
+        auto& clock = resize.get_clock();
+
+        if (!resize.should_redraw()) {
+            failure = "a size change outside of live resize wasn't redrawn";
+            return false;
+        }
+
+        // A second of size changes at 250Hz, redrawn at most at 30Hz and presented in between.
+        resize.begin();
+
+        for (auto event = 0; event < 250; ++event) {
+
+            resize.handle_size_change();
+            if (resize.should_redraw()) resize.complete_redraw(1ms);
+            else resize.complete_presentation(100us);
+
+            clock.current += 4ms;
+
+        }
+
+        auto& statistics = resize.get_statistics();
+        if (statistics.redraws < 28 || statistics.redraws > 32 || statistics.redraws + statistics.presentations != 250) {
+            failure = "expected about 30 redraws, got " + std::to_string(statistics.redraws);
+            return false;
+        }
+
+        if (statistics.latency.maximum > resize.get_redraw_interval() + 4ms || statistics.commit_wait.count != 250) {
+            failure = "latency or commit waits weren't accounted for";
+            return false;
+        }
+
+        // The last change waits on a deadline, ending the drag redraws right away.
+        if (!resize.has_pending_redraw() || !resize.get_redraw_deadline()) {
+            failure = "the held back redraw has no deadline";
+            return false;
+        }
+
+        resize.end();
+        if (!resize.should_redraw() || resize.get_redraw_deadline()) {
+            failure = "ending the live resize didn't redraw";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    // An interactive resize drag, shrinking and growing by a few pixels each step. Layers recorded per step
+    // is what a single surface would redraw as 4, every time.
+    suite.add("layers/mock_scene_resize_drag_200_steps", [](benchmark::context& context) {
+
+        mock_scene_layers mock { 1280.0f, 720.0f };
+        auto recorded = 0.0;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            recorded = 0.0;
+
+            for (auto step = 0; step < 200; ++step) {
+
+                auto delta = static_cast<float>(step < 100 ? step : 200 - step) * 3.0f;
+                mock.resize(1280.0f - delta, 720.0f - delta);
+
+                for (auto id : mock.layers.get_draw_order()) recorded += mock.layers.get(id).content_changed ? 1.0 : 0.0;
+                mock.layers.clear_changes();
+
+            }
+
+        }
+
+        context.set_counter("layers_recorded_per_step", recorded / 200.0);
+
+    });
+
+    // The same drag with a size change every 4ms, throttled to 30 redraws a second on bucketed surfaces.
+    // Steps in between only present the last frame, so they cost nothing here.
+    suite.add("layers/mock_scene_live_resize_drag_200_steps", [](benchmark::context& context) {
+
+        using namespace std::chrono_literals;
+
+        mock_scene_layers mock { 1280.0f, 720.0f };
+        surface_tracker surfaces;
+        gui::basic_live_resize<benchmark::manual_clock> resize;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            resize.reset_statistics();
+            surfaces.reallocations = 0;
+            resize.begin();
+
+            for (auto step = 0; step < 200; ++step) {
+
+                resize.get_clock().current += 4ms;
+                resize.handle_size_change();
+
+                if (!resize.should_redraw()) { resize.complete_presentation(0ms); continue; }
+
+                auto delta = static_cast<float>(step < 100 ? step : 200 - step) * 3.0f;
+                mock.resize(1280.0f - delta, 720.0f - delta);
+                surfaces.sync(mock.layers, true);
+                mock.layers.clear_changes();
+
+                resize.complete_redraw(0ms);
+
+            }
+
+            resize.end();
+
+        }
+
+        auto& statistics = resize.get_statistics();
+        context.set_counter("redraws_per_step", static_cast<double>(statistics.redraws) / 200.0);
+        context.set_counter("surface_reallocations_per_step", static_cast<double>(surfaces.reallocations) / 200.0);
+        context.set_counter("latency_ms", std::chrono::duration<double, std::milli>(statistics.latency.get_average()).count());
+
+    });
+
+    // Hover style invalidation of a small area, mapped to the layers under it.
+    suite.add("layers/invalidate_area_mock_scene", [](benchmark::context& context) {
+
+        mock_scene_layers mock { 1280.0f, 720.0f };
+        mock.layers.clear_changes();
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            mock.layers.invalidate(measure::rectangle<float> { 220.0f, 0.0f, 200.0f, 40.0f });
+            benchmark::do_not_optimize(mock.layers.has_changes());
+            mock.layers.clear_changes();
+        }
+
+    });
+
+}
@@ -0,0 +1,376 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <graphics/layer_tree.hpp>
+#include <gui/hit_test_map.hpp>
+#include <gui/layout_tree.hpp>
+#include <gui/mock_scene.hpp>
+
+#include "benchmark.hpp"
+#include "mock_scene_fixture.hpp"
+
+namespace {
+
+    using namespace chrome;
+    using gui::layout_tree;
+
+    auto to_string(measure::rectangle<float> const& bounds) {
+        return "{ " + std::to_string(bounds.origin.x) + ", " + std::to_string(bounds.origin.y) + ", "
+            + std::to_string(bounds.dimension.width) + ", " + std::to_string(bounds.dimension.height) + " }";
+    }
+
+    auto is_same(measure::rectangle<float> const& lhs, measure::rectangle<float> const& rhs) {
+        return lhs.origin.x == rhs.origin.x && lhs.origin.y == rhs.origin.y
+            && lhs.dimension.width == rhs.dimension.width && lhs.dimension.height == rhs.dimension.height;
+    }
+
+    // Everything a node is built from, so the same tree can be laid out again from scratch.
+    struct node_description {
+        gui::layout_id parent = layout_tree::none;
+        gui::layout_direction direction = gui::layout_direction::stack;
+        gui::layout_alignment alignment = gui::layout_alignment::start;
+        float spacing = 0.0f;
+        gui::layout_length width, height;
+        gui::layout_margin margin;
+    };
+
+    auto random_length(benchmark::random& random) {
+        return random.next(0, 2) == 0 ? gui::flexible_length(static_cast<float>(random.next(0, 3))) : gui::fixed_length(static_cast<float>(random.next(0, 120)));
+    }
+
+    auto randomize(node_description& node, benchmark::random& random) {
+
+        node.direction = static_cast<gui::layout_direction>(random.next(0, 2));
+        node.alignment = static_cast<gui::layout_alignment>(random.next(0, 2));
+        node.spacing = static_cast<float>(random.next(0, 8)) - 2.0f;
+        node.width = random_length(random);
+        node.height = random_length(random);
+        node.margin = { static_cast<float>(random.next(0, 6)), static_cast<float>(random.next(0, 6)), static_cast<float>(random.next(0, 6)) - 3.0f, 0.0f };
+
+    }
+
+    auto apply(layout_tree& tree, gui::layout_id const id, node_description const& node) {
+
+        tree.set_direction(id, node.direction);
+        tree.set_alignment(id, node.alignment);
+        tree.set_spacing(id, node.spacing);
+        if (id == layout_tree::root) return;
+
+        tree.set_width(id, node.width);
+        tree.set_height(id, node.height);
+        tree.set_margin(id, node.margin);
+
+    }
+
+    auto build(std::vector<node_description> const& nodes, measure::rectangle<float> const& bounds) {
+
+        layout_tree tree;
+        apply(tree, layout_tree::root, nodes[0]);
+
+        for (std::size_t i = 1; i < nodes.size(); ++i) apply(tree, tree.add(nodes[i].parent), nodes[i]);
+
+        tree.set_root_bounds(bounds);
+        tree.update();
+
+        return tree;
+
+    }
+
+    // Something shaped like a browser window with a long bookmark sidebar: a toolbar of buttons around a
+    // flexible omnibox, a fixed sidebar of rows and a page of flexible columns.
+    struct chrome_like_nodes {
+        gui::layout_id sidebar;
+        gui::layout_id first_row;
+        gui::layout_id page;
+    };
+
+    auto build_chrome_like(layout_tree& tree, std::uint32_t const sidebar_rows) {
+
+        tree.set_direction(layout_tree::root, gui::layout_direction::column);
+
+        auto toolbar = tree.add(layout_tree::root, gui::layout_direction::row);
+        tree.set_height(toolbar, gui::fixed_length(40.0f));
+        tree.set_spacing(toolbar, 4.0f);
+
+        for (auto i = 0; i < 24; ++i) {
+            auto button = tree.add(toolbar);
+            tree.set_width(button, gui::fixed_length(28.0f));
+            if (i == 4) tree.set_width(tree.add(toolbar), gui::flexible_length());
+        }
+
+        auto body = tree.add(layout_tree::root, gui::layout_direction::row);
+
+        auto sidebar = tree.add(body, gui::layout_direction::column);
+        tree.set_width(sidebar, gui::fixed_length(300.0f));
+
+        auto first_row = static_cast<gui::layout_id>(tree.size());
+
+        for (std::uint32_t i = 0; i < sidebar_rows; ++i) {
+            auto row = tree.add(sidebar, gui::layout_direction::row);
+            tree.set_height(row, gui::fixed_length(24.0f));
+            tree.set_width(tree.add(row), gui::fixed_length(16.0f));
+            tree.add(row);
+        }
+
+        auto page = tree.add(body, gui::layout_direction::row);
+        for (auto i = 0; i < 3; ++i) tree.add(page);
+
+        return chrome_like_nodes { sidebar, first_row, page };
+
+    }
+
+}
+
+auto register_layout_benchmarks(benchmark::suite& suite) -> void {
+
+    suite.add_check("layout_tree/places_rows_columns_and_stacks", [](std::string& failure) {
+
+        layout_tree tree;
+        tree.set_direction(layout_tree::root, gui::layout_direction::row);
+        tree.set_spacing(layout_tree::root, 10.0f);
+        tree.set_alignment(layout_tree::root, gui::layout_alignment::center);
+
+        auto fixed = tree.add();
+        tree.set_width(fixed, gui::fixed_length(100.0f));
+        tree.set_height(fixed, gui::fixed_length(20.0f));
+        tree.set_margin(fixed, { 5.0f, 0.0f, 5.0f, 0.0f });
+
+        auto one = tree.add(layout_tree::root, gui::layout_direction::column);
+        auto two = tree.add();
+        tree.set_width(two, gui::flexible_length(2.0f));
+        tree.set_margin(two, { 0.0f, 4.0f, 0.0f, 6.0f });
+
+        auto top = tree.add(one);
+        tree.set_height(top, gui::fixed_length(30.0f));
+        tree.set_width(top, gui::fixed_length(50.0f));
+        tree.set_alignment(one, gui::layout_alignment::end);
+        auto rest = tree.add(one);
+
+        auto overlay = tree.add(two);
+        tree.set_width(overlay, gui::fixed_length(40.0f));
+        tree.set_alignment(two, gui::layout_alignment::center);
+
+        tree.set_root_bounds({ 0.0f, 0.0f, 440.0f, 100.0f });
+        tree.update();
+
+        // 440 - 110 fixed - 20 spacing leaves 310, split 1:2.
+        struct expectation { gui::layout_id id; measure::rectangle<float> bounds; } expected[] = {
+            { fixed, { 5.0f, 40.0f, 100.0f, 20.0f } },
+            { one, { 120.0f, 0.0f, 310.0f / 3.0f, 100.0f } },
+            { two, { 130.0f + 310.0f / 3.0f, 4.0f, 620.0f / 3.0f, 90.0f } },
+            { top, { 120.0f + 310.0f / 3.0f - 50.0f, 0.0f, 50.0f, 30.0f } },
+            { rest, { 120.0f, 30.0f, 310.0f / 3.0f, 70.0f } },
+            { overlay, { 130.0f + 310.0f / 3.0f + (620.0f / 3.0f - 40.0f) / 2.0f, 4.0f, 40.0f, 90.0f } }
+        };
+
+        for (auto& [id, bounds] : expected) {
+
+            auto& actual = tree.get_bounds(id);
+            auto close = std::abs(actual.origin.x - bounds.origin.x) < 1e-3f && std::abs(actual.origin.y - bounds.origin.y) < 1e-3f
+                && std::abs(actual.dimension.width - bounds.dimension.width) < 1e-3f && std::abs(actual.dimension.height - bounds.dimension.height) < 1e-3f;
+
+            if (!close) {
+                failure = "node " + std::to_string(id) + " at " + to_string(actual) + ", expected " + to_string(bounds);
+                return false;
+            }
+
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("layout_tree/reports_only_what_moved", [](std::string& failure) {
+
+        layout_tree tree;
+        auto [sidebar, first_row, page] = build_chrome_like(tree, 50);
+
+        tree.set_root_bounds({ 0.0f, 0.0f, 1280.0f, 720.0f });
+        tree.update();
+        tree.clear_changes();
+
+        // Wider: the buttons right of the omnibox and the page move, the sidebar stays.
+        tree.set_root_bounds({ 0.0f, 0.0f, 1300.0f, 720.0f });
+        tree.update();
+
+        for (auto id : tree.get_moved()) {
+            if (id >= sidebar && id < page) {
+                failure = "node " + std::to_string(id) + " in the sidebar moved";
+                return false;
+            }
+        }
+
+        // Root, toolbar, omnibox, 19 buttons past it, body, page and its 3 columns.
+        if (tree.get_moved().size() != 27) { failure = std::to_string(tree.get_moved().size()) + " nodes moved, expected 27"; return false; }
+
+        // A taller row (each is three nodes) pushes the rows below it down, nothing outside the sidebar moves.
+        tree.clear_changes();
+        tree.set_height(first_row + 3 * 30, gui::fixed_length(30.0f));
+        tree.update();
+
+        // The row and its two parts, then the 19 rows below with theirs.
+        if (tree.get_moved().size() != 3 * 20) { failure = std::to_string(tree.get_moved().size()) + " nodes moved, expected 60"; return false; }
+
+        for (auto id : tree.get_moved()) {
+            if (id < first_row + 3 * 30 || id >= page) {
+                failure = "node " + std::to_string(id) + " above the taller row or outside the sidebar moved";
+                return false;
+            }
+        }
+
+        // Nothing changed, nothing to do.
+        tree.clear_changes();
+        tree.set_root_bounds({ 0.0f, 0.0f, 1300.0f, 720.0f });
+        tree.set_height(first_row + 3 * 30, gui::fixed_length(30.0f));
+        tree.update();
+
+        if (!tree.get_moved().empty()) { failure = "an unchanged update moved something"; return false; }
+
+        return true;
+
+    });
+
+    suite.add_check("layout_tree/incremental_matches_full_layout", [](std::string& failure) {
+
+        benchmark::random random { 17 };
+
+        std::vector<node_description> nodes(1);
+        randomize(nodes[0], random);
+
+        for (auto i = 1; i < 120; ++i) {
+            auto& node = nodes.emplace_back();
+            node.parent = random.next(0, static_cast<std::uint32_t>(nodes.size() - 2));
+            randomize(node, random);
+        }
+
+        auto bounds = measure::rectangle<float> { 0.0f, 0.0f, 800.0f, 600.0f };
+        auto incremental = build(nodes, bounds);
+
+        for (auto step = 0; step < 300; ++step) {
+
+            // A few properties or the root size at a time, like a frame would.
+            for (auto change = random.next(1, 3); change-- > 0;) {
+
+                auto id = random.next(0, static_cast<std::uint32_t>(nodes.size() - 1));
+                if (random.next(0, 4) == 0) bounds.dimension = { static_cast<float>(random.next(100, 1000)), static_cast<float>(random.next(100, 800)) };
+                else randomize(nodes[id], random);
+
+                apply(incremental, id, nodes[id]);
+
+            }
+
+            incremental.set_root_bounds(bounds);
+            incremental.update();
+
+            auto full = build(nodes, bounds);
+            for (gui::layout_id id = 0; id < nodes.size(); ++id) {
+                if (!is_same(incremental.get_bounds(id), full.get_bounds(id))) {
+                    failure = "step " + std::to_string(step) + ": node " + std::to_string(id) + " at " + to_string(incremental.get_bounds(id)) + ", expected " + to_string(full.get_bounds(id));
+                    return false;
+                }
+            }
+
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("mock_scene/layout_places_the_chrome", [](std::string& failure) {
+
+        gui::mock_scene scene;
+        graphics::layer_tree layers;
+        scene.add_layers(layers);
+
+        // Hit regions don't need a layout, the tabs only hang from the bottom of the frame.
+        gui::hit_test_map map;
+        map.reset({ 0, 0, 1280, 720 });
+        scene.add_hit_regions(map, benchmark::frame_height, 1.0f);
+        map.build();
+
+        scene.layout(layers, benchmark::make_client_area(1280.0f, 720.0f), benchmark::frame_height);
+
+        struct expectation { gui::mock_layer layer; measure::rectangle<float> bounds; } expected[] = {
+            { gui::mock_layer::tab_strip, { 0.0f, 0.0f, 1280.0f, 30.0f } },
+            { gui::mock_layer::toolbar, { 0.0f, 30.0f, 1280.0f, 55.0f } },
+            { gui::mock_layer::content, { 0.0f, 85.0f, 1280.0f, 635.0f } },
+            { gui::mock_layer::sidebar, { 0.0f, 85.0f, 400.0f, 635.0f } }
+        };
+
+        for (auto& [layer, bounds] : expected) {
+            auto& actual = layers.get(scene.get_layer_id(layer)).bounds;
+            if (!is_same(actual, bounds)) {
+                failure = "layer " + std::to_string(static_cast<int>(layer)) + " at " + to_string(actual) + ", expected " + to_string(bounds);
+                return false;
+            }
+        }
+
+        struct probe { measure::point<std::int32_t> point; gui::mock_element element; } probes[] = {
+            { { 20, 16 }, gui::mock_element::active_tab },
+            { { 235, 16 }, gui::mock_element::active_tab },    // Where the tabs overlap.
+            { { 300, 16 }, gui::mock_element::inactive_tab },
+            { { 465, 12 }, gui::mock_element::new_tab_button },
+            { { 465, 26 }, gui::mock_element::none }
+        };
+
+        for (auto& [point, element] : probes) {
+            auto result = map.hit_test(point);
+            auto actual = result.kind == gui::hit_region_kind::interactive ? static_cast<gui::mock_element>(result.id) : gui::mock_element::none;
+            if (actual != element) {
+                failure = "hit test at " + std::to_string(point.x) + ", " + std::to_string(point.y) + " found the wrong element";
+                return false;
+            }
+        }
+
+        return true;
+
+    });
+
+    // One DIP wider per step, back and forth like a drag.
+    auto drag_width = [](std::uint64_t const step) { return 1000.0f + static_cast<float>(step % 400 < 200 ? step % 400 : 400 - step % 400); };
+
+    suite.add("layout_tree/resize_drag_chrome_2000_rows", [drag_width](benchmark::context& context) {
+
+        layout_tree tree;
+        build_chrome_like(tree, 2000);
+
+        tree.set_root_bounds({ 0.0f, 0.0f, drag_width(0), 800.0f });
+        tree.update();
+        tree.clear_changes();
+
+        auto before = tree.get_statistics();
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            tree.set_root_bounds({ 0.0f, 0.0f, drag_width(i + 1), 800.0f });
+            tree.update();
+            tree.clear_changes();
+        }
+
+        auto& after = tree.get_statistics();
+        auto steps = static_cast<double>(std::max<std::uint64_t>(context.iterations, 1));
+
+        context.set_counter("nodes", static_cast<double>(tree.size()));
+        context.set_counter("moved_per_step", static_cast<double>(after.nodes_moved - before.nodes_moved) / steps);
+        context.set_counter("laid_out_per_step", static_cast<double>(after.containers_laid_out - before.containers_laid_out) / steps);
+
+    });
+
+    // Everything laid out from scratch every step, what the hard-coded positions amounted to.
+    suite.add("layout_tree/resize_drag_chrome_2000_rows_full", [drag_width](benchmark::context& context) {
+
+        layout_tree tree;
+        build_chrome_like(tree, 2000);
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            // Moving the origin back and forth moves every node.
+            tree.set_root_bounds({ static_cast<float>(i % 2), 0.0f, drag_width(i + 1), 800.0f });
+            tree.update();
+            tree.clear_changes();
+
+        }
+
+    });
+
+}
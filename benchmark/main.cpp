@@ -0,0 +1,83 @@
+#include <cstdio>
+#include <string>
+#include <thread>
+
+#include <graphics/pixel_kernels.hpp>
+
+#include "benchmark.hpp"
+
+auto register_measure_benchmarks(benchmark::suite& suite) -> void;
+auto register_hit_test_benchmarks(benchmark::suite& suite) -> void;
+auto register_scene_benchmarks(benchmark::suite& suite) -> void;
+auto register_atlas_benchmarks(benchmark::suite& suite) -> void;
+auto register_residency_benchmarks(benchmark::suite& suite) -> void;
+auto register_image_scaling_benchmarks(benchmark::suite& suite) -> void;
+auto register_kernel_benchmarks(benchmark::suite& suite) -> void;
+auto register_layer_benchmarks(benchmark::suite& suite) -> void;
+auto register_startup_benchmarks(benchmark::suite& suite) -> void;
+auto register_profiler_benchmarks(benchmark::suite& suite) -> void;
+auto register_render_thread_benchmarks(benchmark::suite& suite) -> void;
+auto register_tile_benchmarks(benchmark::suite& suite) -> void;
+auto register_capture_benchmarks(benchmark::suite& suite) -> void;
+auto register_text_fitting_benchmarks(benchmark::suite& suite) -> void;
+auto register_utf8_benchmarks(benchmark::suite& suite) -> void;
+auto register_layout_benchmarks(benchmark::suite& suite) -> void;
+auto register_frame_scheduler_benchmarks(benchmark::suite& suite) -> void;
+
+namespace {
+
+    auto get_compiler_description() -> std::string {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+}
+
+auto main(int argument_count, char* arguments[]) -> int {
+
+    auto options = benchmark::parse_options(argument_count, arguments);
+    if (!options) {
+        std::fprintf(stderr, "usage: %s [filter] [--json=path|-] [--repetitions=n] [--min-time-ms=n]\n", arguments[0]);
+        return 2;
+    }
+
+    benchmark::suite suite;
+
+    // Enough to tell two result files apart, the rest belongs in the file name.
+    suite.set_property("compiler", get_compiler_description());
+#if defined(NDEBUG)
+    suite.set_property("assertions", "off");
+#else
+    suite.set_property("assertions", "on");
+#endif
+    suite.set_property("pixel_kernels", chrome::graphics::kernels::get_instruction_set_name(chrome::graphics::kernels::get_kernels().set));
+    suite.set_property("hardware_threads", std::to_string(std::thread::hardware_concurrency()));
+
+    register_measure_benchmarks(suite);
+    register_hit_test_benchmarks(suite);
+    register_scene_benchmarks(suite);
+    register_atlas_benchmarks(suite);
+    register_residency_benchmarks(suite);
+    register_image_scaling_benchmarks(suite);
+    register_kernel_benchmarks(suite);
+    register_layer_benchmarks(suite);
+    register_startup_benchmarks(suite);
+    register_profiler_benchmarks(suite);
+    register_render_thread_benchmarks(suite);
+    register_tile_benchmarks(suite);
+    register_capture_benchmarks(suite);
+    register_text_fitting_benchmarks(suite);
+    register_utf8_benchmarks(suite);
+    register_layout_benchmarks(suite);
+    register_frame_scheduler_benchmarks(suite);
+
+    return suite.run(*options);
+
+}
@@ -0,0 +1,296 @@
+#include <cmath>
+#include <stack>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <utility/affine.hpp>
+#include <utility/measure.hpp>
+#include <utility/region.hpp>
+#include <graphics/transform.hpp>
+
+#include "benchmark.hpp"
+
+namespace {
+
+    using namespace chrome;
+
+    constexpr auto sample_count = 1024u;
+
+    auto make_rectangles(std::uint64_t const seed) {
+
+        benchmark::random random { seed };
+        std::vector<measure::rectangle<std::int32_t>> rectangles;
+        rectangles.reserve(sample_count);
+
+        for (auto i = 0u; i < sample_count; ++i) {
+            rectangles.emplace_back(
+                static_cast<std::int32_t>(random.next(0, 1800)), static_cast<std::int32_t>(random.next(0, 1000)),
+                static_cast<std::int32_t>(random.next(1, 300)), static_cast<std::int32_t>(random.next(1, 120))
+            );
+        }
+
+        return rectangles;
+
+    }
+
+    auto make_points(std::uint64_t const seed, std::uint32_t const width, std::uint32_t const height) {
+
+        benchmark::random random { seed };
+        std::vector<measure::point<std::int32_t>> points;
+        points.reserve(sample_count);
+
+        for (auto i = 0u; i < sample_count; ++i)
+            points.emplace_back(static_cast<std::int32_t>(random.next(0, width)), static_cast<std::int32_t>(random.next(0, height)));
+
+        return points;
+
+    }
+
+    auto make_float_points(std::uint64_t const seed) {
+
+        benchmark::random random { seed };
+        std::vector<measure::point<float>> points;
+        points.reserve(sample_count);
+
+        for (auto i = 0u; i < sample_count; ++i)
+            points.emplace_back(static_cast<float>(random.next(0, 1920)) * 0.5f, static_cast<float>(random.next(0, 1080)) * 0.5f);
+
+        return points;
+
+    }
+
+    auto make_float_rectangles(std::uint64_t const seed) {
+
+        std::vector<measure::rectangle<float>> rectangles;
+        rectangles.reserve(sample_count);
+
+        for (auto& [origin, dimension] : make_rectangles(seed)) {
+            rectangles.emplace_back(
+                static_cast<float>(origin.x), static_cast<float>(origin.y),
+                static_cast<float>(dimension.width), static_cast<float>(dimension.height)
+            );
+        }
+
+        return rectangles;
+
+    }
+
+    // Rotated on purpose, so bounds aren't just two transformed corners.
+    auto const view_transform = measure::affine2d::rotation(0.3f) * measure::affine2d::scale(1.25f, 0.75f)
+        * measure::affine2d::translation(12.0f, -40.0f);
+
+    auto close_enough(float const lhs, float const rhs) {
+        return std::abs(lhs - rhs) <= 1e-3f * (1.0f + std::abs(lhs) + std::abs(rhs));
+    }
+
+    // Construction and composition have to stay usable in constant expressions.
+    constexpr auto compile_time_transform = measure::affine2d::translation(4.0f, 2.0f) * measure::affine2d::scale(2.0f, 3.0f);
+    static_assert(compile_time_transform.dx == 8.0f && compile_time_transform.dy == 6.0f);
+    static_assert(measure::transform_bounds(compile_time_transform, { 0.0f, 0.0f, 1.0f, 1.0f }).dimension.height == 3.0f);
+
+}
+
+auto register_measure_benchmarks(benchmark::suite& suite) -> void {
+
+    suite.add_check("measure/affine_batches_match_scalar", [](std::string& failure) {
+
+        // The SIMD product against the constant evaluated one.
+        constexpr auto lhs = measure::affine2d { 1.5f, -0.25f, 0.5f, 2.0f, 3.0f, -7.0f };
+        constexpr auto rhs = measure::affine2d { 0.75f, 1.0f, -2.0f, 0.5f, 11.0f, 4.0f };
+        constexpr auto expected = lhs * rhs;
+        auto product = lhs * rhs;
+
+        auto& [e11, e12, e21, e22, edx, edy] = expected;
+        auto& [p11, p12, p21, p22, pdx, pdy] = product;
+        if (e11 != p11 || e12 != p12 || e21 != p21 || e22 != p22 || edx != pdx || edy != pdy) {
+            failure = "matrix product differs from the scalar one";
+            return false;
+        }
+
+        // Counts that aren't a multiple of the batch width, so the scalar tails run too.
+        auto points = make_float_points(7);
+        points.resize(points.size() - 1);
+        std::vector<measure::point<float>> mapped(points.size());
+        measure::transform_points(view_transform, points.data(), mapped.data(), points.size());
+
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            auto expected_point = view_transform.transform_point(points[i]);
+            if (!close_enough(expected_point.x, mapped[i].x) || !close_enough(expected_point.y, mapped[i].y)) {
+                failure = "point " + std::to_string(i) + " maps differently";
+                return false;
+            }
+        }
+
+        auto rectangles = make_float_rectangles(8);
+        rectangles.resize(rectangles.size() - 3);
+        std::vector<measure::rectangle<float>> bounds(rectangles.size());
+        measure::transform_bounds(view_transform, rectangles.data(), bounds.data(), rectangles.size());
+
+        for (std::size_t i = 0; i < rectangles.size(); ++i) {
+            auto expected_bounds = measure::transform_bounds(view_transform, rectangles[i]);
+            if (!close_enough(expected_bounds.origin.x, bounds[i].origin.x) || !close_enough(expected_bounds.origin.y, bounds[i].origin.y)
+                || !close_enough(expected_bounds.right(), bounds[i].right()) || !close_enough(expected_bounds.bottom(), bounds[i].bottom())) {
+                failure = "rectangle " + std::to_string(i) + " gets different bounds";
+                return false;
+            }
+        }
+
+        return true;
+
+    });
+
+    suite.add("measure/rectangle_intersect_unite_1024", [lhs = make_rectangles(1), rhs = make_rectangles(2)](benchmark::context& context) {
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            std::int64_t area = 0;
+            for (auto k = 0u; k < sample_count; ++k) {
+                if (lhs[k].intersects(rhs[k])) area += measure::intersect(lhs[k], rhs[k]).area();
+                area += measure::unite(lhs[k], rhs[k]).area();
+            }
+            benchmark::do_not_optimize(area);
+        }
+
+    });
+
+    suite.add("measure/rectangle_contains_point_1024", [rectangles = make_rectangles(3), points = make_points(4, 2100, 1120)](benchmark::context& context) {
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            auto hits = 0u;
+            for (auto k = 0u; k < sample_count; ++k) hits += rectangles[k].contains(points[k]);
+            benchmark::do_not_optimize(hits);
+        }
+
+    });
+
+    // A frame's worth of damage, hover highlights and text carets scattered around the window.
+    suite.add("measure/region_add_64_damage_rectangles", [rectangles = make_rectangles(5)](benchmark::context& context) {
+
+        auto rectangle_count = 0.0;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            measure::region<std::int32_t> damage;
+            for (auto k = 0u; k < 64u; ++k) damage.add(rectangles[k]);
+            rectangle_count = static_cast<double>(damage.get_rectangles().size());
+            benchmark::do_not_optimize(damage);
+        }
+
+        context.set_counter("rectangles", rectangle_count);
+
+    });
+
+    suite.add("measure/transform_compose_and_map_1024", [points = make_points(6, 1920, 1080)](benchmark::context& context) {
+
+        auto base = graphics::transform::translation(0.0f, 30.0f) * graphics::transform::scale(1.5f, 1.5f);
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            auto sum = 0.0f;
+            for (auto& [x, y] : points) {
+                auto combined = graphics::transform::translation(static_cast<float>(x), 0.0f) * base;
+                sum += combined.transform_point({ 1.0f, static_cast<float>(y) }).y;
+            }
+            benchmark::do_not_optimize(sum);
+        }
+
+    });
+
+
+    suite.add("measure/affine_transform_points_scalar_1024", [points = make_float_points(9)](benchmark::context& context) {
+
+        std::vector<measure::point<float>> mapped(points.size());
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            for (std::size_t k = 0; k < points.size(); ++k) mapped[k] = view_transform.transform_point(points[k]);
+            benchmark::do_not_optimize(mapped.data());
+        }
+
+    });
+
+    suite.add("measure/affine_transform_points_batch_1024", [points = make_float_points(9)](benchmark::context& context) {
+
+        std::vector<measure::point<float>> mapped(points.size());
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            measure::transform_points(view_transform, points.data(), mapped.data(), points.size());
+            benchmark::do_not_optimize(mapped.data());
+        }
+
+    });
+
+    suite.add("measure/affine_transform_bounds_scalar_1024", [rectangles = make_float_rectangles(10)](benchmark::context& context) {
+
+        std::vector<measure::rectangle<float>> bounds(rectangles.size());
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            for (std::size_t k = 0; k < rectangles.size(); ++k) bounds[k] = measure::transform_bounds(view_transform, rectangles[k]);
+            benchmark::do_not_optimize(bounds.data());
+        }
+
+    });
+
+    suite.add("measure/affine_transform_bounds_batch_1024", [rectangles = make_float_rectangles(10)](benchmark::context& context) {
+
+        std::vector<measure::rectangle<float>> bounds(rectangles.size());
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            measure::transform_bounds(view_transform, rectangles.data(), bounds.data(), rectangles.size());
+            benchmark::do_not_optimize(bounds.data());
+        }
+
+    });
+
+    suite.add_check("measure/transform_stack_rejects_unbalanced", [](std::string& failure) {
+
+        graphics::transform_stack transforms;
+
+        try {
+            transforms.pop();
+            failure = "popping the identity did not throw";
+            return false;
+        }
+        catch (std::out_of_range const&) {}
+
+        for (auto depth = 1u; depth < graphics::transform_stack::capacity; ++depth) transforms.push(graphics::transform::scale(2.0f, 2.0f));
+
+        try {
+            transforms.push(graphics::transform::identity());
+            failure = "pushing past capacity did not throw";
+            return false;
+        }
+        catch (std::length_error const&) {}
+
+        if (transforms.get_depth() != graphics::transform_stack::capacity) {
+            failure = "a rejected push or pop changed the depth";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    // Nested layout containers, against the std::stack the renderer used to keep.
+    suite.add("measure/transform_stack_push_pop_depth_8", [](benchmark::context& context) {
+
+        graphics::transform_stack transforms;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            for (auto depth = 0; depth < 8; ++depth) transforms.push(graphics::transform::translation(static_cast<float>(depth), 1.0f));
+            benchmark::do_not_optimize(transforms.top());
+            for (auto depth = 0; depth < 8; ++depth) transforms.pop();
+        }
+
+    });
+
+    suite.add("measure/std_stack_push_pop_depth_8", [](benchmark::context& context) {
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            std::stack<graphics::transform> transforms;
+            transforms.push(graphics::transform::identity());
+            for (auto depth = 0; depth < 8; ++depth)
+                transforms.push(graphics::transform::translation(static_cast<float>(depth), 1.0f) * transforms.top());
+            benchmark::do_not_optimize(transforms.top());
+        }
+
+    });
+
+}
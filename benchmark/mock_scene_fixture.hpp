@@ -0,0 +1,45 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+
+#include <utility/measure.hpp>
+#include <graphics/bitmap.hpp>
+#include <gui/mock_scene.hpp>
+
+#include "benchmark.hpp"
+
+// What the benchmarks drawing the mock scene share, set up the way a window would.
+
+namespace benchmark {
+
+    // Matches what window::paint hands the scene at 100% scaling, below a 30 DIP extended frame.
+    constexpr auto frame_height = 30.0f;
+
+    inline auto make_client_area(float const width, float const height) {
+        return measure::rectangle<float> { 0.0f, 0.0f, width, height - frame_height };
+    }
+
+    // Stand-ins for the decoded tab raster and new tab symbol, the software renderer only needs pixels.
+    struct mock_images {
+
+        chrome::graphics::bitmap tab_raster { 462, 56 };
+        chrome::graphics::bitmap new_tab_symbol { 32, 32 };
+
+        mock_images() {
+            random generator;
+            for (auto& pixel : tab_raster.pixels) pixel = 0xff000000u | static_cast<std::uint32_t>(generator.next() & 0x00ffffffu);
+            for (auto& pixel : new_tab_symbol.pixels) pixel = (generator.next(0, 1) ? 0xff5f6368u : 0u);
+        }
+
+        auto provider(chrome::gui::mock_scene const& scene) const {
+            return [this, &scene](chrome::resource::image const& image) -> chrome::graphics::bitmap const* {
+                return &image == scene.get_tab_raster() ? &tab_raster : &new_tab_symbol;
+            };
+        }
+
+    };
+
+}
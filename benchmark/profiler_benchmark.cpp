@@ -0,0 +1,211 @@
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <utility/profiler.hpp>
+#include <graphics/command_list.hpp>
+#include <graphics/software_renderer.hpp>
+#include <gui/mock_scene.hpp>
+
+#include "benchmark.hpp"
+#include "mock_scene_fixture.hpp"
+
+namespace {
+
+    using namespace chrome;
+    namespace profiler = utility::profiler;
+
+    // Whatever earlier checks and benchmarks left in the rings is thrown away.
+    auto drain_everything() {
+        profiler::collector discarded;
+        discarded.collect();
+    }
+
+}
+
+auto register_profiler_benchmarks(benchmark::suite& suite) -> void {
+
+    suite.add_check("profiler/ring_drops_when_full", [](std::string& failure) {
+
+        profiler::event_ring<8> ring;
+        for (std::int64_t i = 0; i < 10; ++i) ring.push({ "event", i, 0, profiler::event_type::zone });
+
+        if (ring.get_dropped() != 2) {
+            failure = "expected the two events past the capacity to be dropped";
+            return false;
+        }
+
+        std::int64_t expected = 0;
+        auto drained = ring.drain([&](profiler::event const& event) {
+            if (event.start == expected) ++expected;
+        });
+
+        if (drained != 8 || expected != 8) {
+            failure = "events don't come out in the order they went in";
+            return false;
+        }
+
+        if (!ring.push({ "event", 10, 0, profiler::event_type::zone }) || ring.drain([](profiler::event const&) {}) != 1) {
+            failure = "a drained ring doesn't take new events";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("profiler/chrome_trace_export", [](std::string& failure) {
+
+        profiler::set_enabled(true);
+        drain_everything();
+
+        // A fresh thread, so nothing else recorded lands in its buffer.
+        std::thread worker { [] {
+            profiler::frame frame { "frame" };
+            profiler::zone zone { "zone" };
+            profiler::add_counter("draw calls", 2);
+            profiler::add_counter("draw calls", 4);
+        } };
+        worker.join();
+
+        profiler::set_enabled(false);
+        std::thread { [] { profiler::zone zone { "disabled" }; } }.join();
+        profiler::set_enabled(true);
+
+        profiler::collector collector;
+        collector.collect();
+
+        auto& events = collector.get_events();
+        if (events.size() != 3 || collector.get_frame_times().get_count() != 1) {
+            failure = "expected a zone, a frame and a counter, got " + std::to_string(events.size()) + " events";
+            return false;
+        }
+
+        auto& zone = events[0].recorded;
+        auto& frame = events[1].recorded;
+        auto& counter = events[2].recorded;
+        if (zone.start < frame.start || zone.start + zone.value > frame.start + frame.value || counter.value != 6) {
+            failure = "the zone isn't inside its frame or the counter didn't add up";
+            return false;
+        }
+
+        std::ostringstream output;
+        collector.export_chrome_trace(output);
+        auto trace = output.str();
+
+        for (auto expected : {
+            "{\"traceEvents\":[",
+            "{\"name\":\"zone\",\"pid\":1,",
+            ",\"ph\":\"X\",\"dur\":",
+            ",\"cat\":\"frame\"}",
+            "{\"name\":\"draw calls\",",
+            ",\"ph\":\"C\",\"args\":{\"value\":6}}",
+            "],\"displayTimeUnit\":\"ms\"}"
+        }) {
+            if (trace.find(expected) != std::string::npos) continue;
+            failure = std::string { "the trace is missing " } + expected + ":\n" + trace;
+            return false;
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("profiler/frame_histogram_percentiles", [](std::string& failure) {
+
+        profiler::frame_histogram histogram;
+        for (std::int64_t i = 1; i <= 100; ++i) histogram.add(i * 100'000); // 0.1ms to 10ms.
+        histogram.add(100'000'000);
+
+        auto median = histogram.get_percentile(0.5);
+        if (median < 5'000'000 || median > 5'250'000) {
+            failure = "median " + std::to_string(median) + "ns, expected the bucket around 5ms";
+            return false;
+        }
+
+        if (histogram.get_overflow() != 1 || histogram.get_maximum() != 100'000'000 || histogram.get_percentile(1.0) != 100'000'000) {
+            failure = "frames past the last bucket aren't accounted for";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    // What an instrumented build pays for a zone while nobody is recording.
+    suite.add("profiler/zone_disabled", [](benchmark::context& context) {
+
+        profiler::set_enabled(false);
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            profiler::zone zone { "zone" };
+            benchmark::do_not_optimize(zone);
+        }
+        profiler::set_enabled(true);
+
+    });
+
+    // Two clock reads and a push, drained now and then the way the application does once a frame.
+    suite.add("profiler/zone_enabled", [](benchmark::context& context) {
+
+        profiler::set_enabled(true);
+        drain_everything();
+
+        profiler::collector collector;
+        auto dropped = collector.get_dropped();
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            { profiler::zone zone { "zone" }; }
+
+            if ((i & 1023) == 1023) {
+                collector.collect();
+                collector.clear();
+            }
+
+        }
+
+        collector.collect();
+        context.set_counter("dropped", static_cast<double>(collector.get_dropped() - dropped));
+
+    });
+
+    // A whole software rendered frame, with as many zones and counters as the build compiled in.
+    suite.add("profiler/mock_scene_frame_software_1280x720", [](benchmark::context& context) {
+
+        auto const width = 1280u, height = 720u;
+        auto client_area = benchmark::make_client_area(static_cast<float>(width), static_cast<float>(height));
+
+        gui::mock_scene scene;
+        graphics::command_list commands;
+        graphics::software_renderer renderer { width, height };
+
+        profiler::set_enabled(true);
+        drain_everything();
+
+        profiler::collector collector;
+        std::uint64_t events = 0;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            {
+                profiler::frame frame { "frame" };
+
+                commands.clear();
+                scene.record(commands, client_area, benchmark::frame_height);
+
+                renderer.begin_draw();
+                renderer.execute(commands);
+                renderer.end_draw();
+            }
+
+            collector.collect();
+            events += collector.get_events().size();
+            collector.clear();
+
+        }
+
+        context.set_counter("events_per_frame", static_cast<double>(events) / static_cast<double>(context.iterations));
+
+    });
+
+}
@@ -0,0 +1,425 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <utility/spsc_queue.hpp>
+#include <graphics/layer_tree.hpp>
+#include <graphics/software_renderer.hpp>
+#include <gui/frame_queue.hpp>
+#include <gui/render_thread.hpp>
+#include <gui/mock_scene.hpp>
+
+#include "benchmark.hpp"
+#include "mock_scene_fixture.hpp"
+
+namespace {
+
+    using namespace chrome;
+
+    // window_frame without the Windows parts, merged the same way.
+    struct layer_frame {
+        std::optional<graphics::layer_tree> layers;
+    };
+
+    auto merge_layer_frames(layer_frame& latest, layer_frame&& superseded) -> void {
+        if (!superseded.layers) return;
+        if (latest.layers) latest.layers->absorb_changes(*superseded.layers);
+        else latest.layers = std::move(superseded.layers);
+    }
+
+    // What the render thread ends up showing per layer, mirrors the visual state renderer::render_layers keeps.
+    struct visual_mirror {
+
+        struct visual {
+            measure::size<float> content_size { 0.0f, 0.0f };
+            measure::rectangle<float> bounds { 0.0f, 0.0f, 0.0f, 0.0f };
+        };
+
+        std::unordered_map<graphics::layer_id, visual> visuals;
+        bool rasterize = false;
+
+        auto sync(graphics::layer_tree const& layers) -> void {
+
+            for (auto id : layers.get_removed()) visuals.erase(id);
+
+            for (auto id : layers.get_draw_order()) {
+
+                auto& layer = layers.get(id);
+                auto& mirrored = visuals[id];
+
+                if (layer.geometry_changed) mirrored.bounds = layers.get_absolute_bounds(id);
+                if (!layer.content_changed) continue;
+
+                mirrored.content_size = layer.content_size;
+                if (!rasterize) continue;
+
+                auto width = static_cast<std::uint32_t>(std::ceil(layer.content_size.width));
+                auto height = static_cast<std::uint32_t>(std::ceil(layer.content_size.height));
+                if (width == 0 || height == 0) continue;
+
+                graphics::software_renderer surface { width, height };
+                surface.begin_draw();
+                surface.execute(*layer.commands);
+                surface.end_draw();
+                benchmark::do_not_optimize(surface.get_target().pixels.data());
+
+            }
+
+        }
+
+        auto matches(graphics::layer_tree const& layers) const {
+
+            for (auto id : layers.get_draw_order()) {
+
+                auto lookup_iterator = visuals.find(id);
+                if (lookup_iterator == visuals.end()) return false;
+
+                auto& [content_size, bounds] = lookup_iterator->second;
+                auto expected = layers.get_absolute_bounds(id);
+                auto& layer = layers.get(id);
+
+                if (content_size.width != layer.content_size.width || content_size.height != layer.content_size.height) return false;
+                if (bounds.origin.x != expected.origin.x || bounds.origin.y != expected.origin.y) return false;
+                if (bounds.dimension.width != expected.dimension.width || bounds.dimension.height != expected.dimension.height) return false;
+
+            }
+
+            return true;
+
+        }
+
+    };
+
+    // The UI side of a resize drag: lay out, record and hand the frame over, unless the render thread pushes back.
+    struct drag_producer {
+
+        gui::mock_scene scene;
+        graphics::layer_tree layers;
+
+        drag_producer() { scene.add_layers(layers); }
+
+        auto step(int const step, gui::frame_queue<layer_frame>& queue) -> bool {
+
+            auto delta = static_cast<float>(step < 100 ? step : 200 - step) * 3.0f;
+            scene.layout(layers, benchmark::make_client_area(1280.0f - delta, 720.0f - delta), benchmark::frame_height);
+            scene.record_layers(layers);
+
+            if (!queue.try_submit([this] { return layer_frame { layers }; })) return false;
+
+            layers.clear_changes();
+            return true;
+
+        }
+
+    };
+
+}
+
+auto register_render_thread_benchmarks(benchmark::suite& suite) -> void {
+
+    suite.add_check("render_thread/spsc_queue_order_and_capacity", [](std::string& failure) {
+
+        utility::spsc_queue<std::string, 4> queue;
+
+        for (auto i = 0; i < 4; ++i) {
+            auto value = std::to_string(i);
+            if (!queue.try_push(value)) { failure = "a queue with room rejected a value"; return false; }
+        }
+
+        auto rejected = std::string { "4" };
+        if (queue.try_push(rejected) || rejected != "4" || !queue.is_full()) {
+            failure = "a full queue took a value or consumed the one it rejected";
+            return false;
+        }
+
+        for (auto i = 0; i < 4; ++i) {
+            auto value = queue.try_pop();
+            if (!value || *value != std::to_string(i)) { failure = "values don't come out in order"; return false; }
+        }
+
+        if (queue.try_pop() || queue.get_size() != 0) {
+            failure = "an empty queue handed out a value";
+            return false;
+        }
+
+        // Indices keep counting past the capacity, the slots wrap.
+        std::thread producer { [&queue] {
+            for (auto i = 0; i < 10000; ++i) {
+                auto value = std::to_string(i);
+                while (!queue.try_push(value)) std::this_thread::yield();
+            }
+        } };
+
+        auto in_order = true;
+        for (auto i = 0; i < 10000;) {
+            auto value = queue.try_pop();
+            if (!value) { std::this_thread::yield(); continue; }
+            in_order = in_order && *value == std::to_string(i++);
+        }
+
+        producer.join();
+
+        if (!in_order) failure = "values passed between threads arrived out of order";
+        return in_order;
+
+    });
+
+    suite.add_check("render_thread/latest_frame_wins", [](std::string& failure) {
+
+        // Every frame carries the changes since the one before, merging keeps them all.
+        gui::frame_queue<std::vector<int>, 4> queue;
+
+        for (auto i = 0; i < 4; ++i) queue.try_submit([i] { return std::vector<int> { i }; });
+
+        auto described = false;
+        if (queue.try_submit([&described] { described = true; return std::vector<int> { 4 }; }) || described) {
+            failure = "a full queue took a frame or had it described";
+            return false;
+        }
+
+        auto latest = queue.acquire_latest([](std::vector<int>& later, std::vector<int>&& older) {
+            later.insert(later.begin(), older.begin(), older.end());
+        });
+
+        if (!latest || *latest != std::vector<int> { 0, 1, 2, 3 }) {
+            failure = "the latest frame doesn't carry every superseded one, oldest first";
+            return false;
+        }
+
+        auto statistics = queue.get_statistics();
+        if (statistics.submitted != 4 || statistics.rejected != 1 || statistics.acquired != 1 || statistics.dropped != 3) {
+            failure = "unexpected statistics";
+            return false;
+        }
+
+        if (queue.acquire_latest([](std::vector<int>&, std::vector<int>&&) {})) {
+            failure = "an empty queue handed out a frame";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("render_thread/back_pressure_while_rendering", [](std::string& failure) {
+
+        gui::frame_queue<std::vector<int>, 2> queue;
+        std::vector<std::vector<int>> rendered;
+
+        std::atomic<bool> is_rendering { false }, may_finish { false };
+
+        gui::render_thread thread { [&] {
+            while (auto frame = queue.acquire_latest([](std::vector<int>& later, std::vector<int>&& older) {
+                later.insert(later.begin(), older.begin(), older.end());
+            })) {
+                is_rendering.store(true);
+                while (!may_finish.load()) std::this_thread::yield();
+                rendered.push_back(std::move(*frame));
+            }
+        } };
+
+        auto submit = [&queue](int const value) {
+            return queue.try_submit([value] { return std::vector<int> { value }; });
+        };
+
+        // The first frame is being rendered, two more fit behind it and the one after that is pushed back.
+        submit(0);
+        thread.wake();
+        while (!is_rendering.load()) std::this_thread::yield();
+
+        auto accepted = submit(1) && submit(2);
+        auto pushed_back = !submit(3);
+
+        may_finish.store(true);
+        thread.flush();
+
+        if (!accepted || !pushed_back) {
+            failure = "a queue of two behind a busy renderer didn't take exactly two frames";
+            return false;
+        }
+
+        if (rendered != std::vector<std::vector<int>> { { 0 }, { 1, 2 } } || queue.get_statistics().dropped != 1) {
+            failure = "frames queued behind the busy renderer didn't collapse into one";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("render_thread/flush_and_failures", [](std::string& failure) {
+
+        std::atomic<int> runs { 0 };
+        gui::render_thread thread { [&runs] {
+            if (runs.fetch_add(1) == 2) throw std::runtime_error { "device lost" };
+        } };
+
+        thread.flush();
+        thread.flush();
+
+        if (runs.load() != 2) {
+            failure = "flush returned before a run started after it completed";
+            return false;
+        }
+
+        try { thread.rethrow_failure(); }
+        catch (...) { failure = "reported a failure before there was one"; return false; }
+
+        thread.flush();
+
+        try { thread.rethrow_failure(); }
+        catch (std::runtime_error const& error) { return std::string { error.what() } == "device lost"; }
+
+        failure = "the work's exception didn't make it to the owning thread";
+        return false;
+
+    });
+
+    suite.add_check("render_thread/skipped_frames_lose_no_changes", [](std::string& failure) {
+
+        gui::frame_queue<layer_frame> queue;
+        visual_mirror mirror;
+
+        // Slower than the producer, so frames pile up, get pushed back and get dropped.
+        gui::render_thread thread { [&] {
+            while (auto frame = queue.acquire_latest(merge_layer_frames)) {
+                if (frame->layers) mirror.sync(*frame->layers);
+                std::this_thread::sleep_for(std::chrono::microseconds { 200 });
+            }
+        } };
+
+        drag_producer producer;
+        for (auto step = 0; step <= 200; ++step) {
+            producer.step(step, queue);
+            thread.wake();
+        }
+
+        // Whatever was pushed back goes out once the renderer catches up.
+        thread.flush();
+        while (!producer.step(200, queue)) thread.flush();
+        thread.flush();
+
+        auto statistics = queue.get_statistics();
+        if (statistics.dropped == 0 && statistics.rejected == 0) {
+            failure = "the renderer never fell behind, nothing was tested";
+            return false;
+        }
+
+        if (!mirror.matches(producer.layers)) {
+            failure = "what the render thread shows doesn't match the final layout";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("render_thread/frames_share_recorded_commands", [](std::string& failure) {
+
+        gui::frame_queue<layer_frame> queue;
+        drag_producer producer;
+        producer.step(0, queue);
+
+        auto& layers = producer.layers;
+        auto frame = layers;
+
+        for (auto id : layers.get_draw_order()) {
+            if (frame.get(id).commands != layers.get(id).commands) {
+                failure = "describing a frame copied the commands of layer " + layers.get(id).name;
+                return false;
+            }
+        }
+
+        // Recording again replaces the changed layer's commands, the frame keeps drawing what it was given.
+        auto changed = layers.get_draw_order().back();
+        auto recorded = frame.get(changed).commands;
+        auto recorded_count = recorded->command_count();
+
+        layers.invalidate_content(changed);
+        producer.scene.record_layers(layers);
+
+        if (layers.get(changed).commands == recorded || frame.get(changed).commands != recorded || recorded->command_count() != recorded_count) {
+            failure = "recording again changed the commands a frame was handed";
+            return false;
+        }
+
+        for (auto id : layers.get_draw_order()) {
+            if (id != changed && frame.get(id).commands != layers.get(id).commands) {
+                failure = "recording one layer replaced the commands of " + layers.get(id).name;
+                return false;
+            }
+        }
+
+        return true;
+
+    });
+
+    // Handing a value from one thread to another, either side yields while it can't make progress.
+    suite.add("render_thread/spsc_queue_transfer", [](benchmark::context& context) {
+
+        utility::spsc_queue<std::uint64_t, 1024> queue;
+        auto count = context.iterations;
+
+        std::thread consumer { [&queue, count] {
+            for (std::uint64_t received = 0; received < count;) {
+                if (auto value = queue.try_pop()) { benchmark::do_not_optimize(*value); ++received; }
+                else std::this_thread::yield();
+            }
+        } };
+
+        for (std::uint64_t i = 0; i < count; ++i) {
+            auto value = i;
+            while (!queue.try_push(value)) std::this_thread::yield();
+        }
+
+        consumer.join();
+
+    });
+
+    // A 200 step drag on the UI thread against a render thread rasterizing every layer that changed.
+    // Time is what the UI thread spends per step, the render thread never holds it up.
+    suite.add("render_thread/mock_scene_drag_software_renderer_behind", [](benchmark::context& context) {
+
+        std::uint64_t steps = 0;
+        gui::frame_queue_statistics totals;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            gui::frame_queue<layer_frame> queue;
+            visual_mirror mirror;
+            mirror.rasterize = true;
+
+            gui::render_thread thread { [&] {
+                while (auto frame = queue.acquire_latest(merge_layer_frames)) {
+                    if (frame->layers) mirror.sync(*frame->layers);
+                }
+            } };
+
+            drag_producer producer;
+            for (auto step = 0; step < 200; ++step, ++steps) {
+                producer.step(step, queue);
+                thread.wake();
+            }
+
+            thread.flush();
+
+            auto statistics = queue.get_statistics();
+            totals.submitted += statistics.submitted;
+            totals.rejected += statistics.rejected;
+            totals.dropped += statistics.dropped;
+
+        }
+
+        context.set_counter("submitted_per_step", static_cast<double>(totals.submitted) / static_cast<double>(steps));
+        context.set_counter("rejected_per_step", static_cast<double>(totals.rejected) / static_cast<double>(steps));
+        context.set_counter("dropped_per_step", static_cast<double>(totals.dropped) / static_cast<double>(steps));
+
+    });
+
+}
@@ -0,0 +1,101 @@
+#include <string>
+#include <vector>
+
+#include <graphics/texture_residency.hpp>
+
+#include "benchmark.hpp"
+
+namespace {
+
+    using namespace chrome;
+
+    constexpr auto favicon_count = 400u;
+    constexpr auto visible_tabs = 40u;
+    constexpr auto frames = 1000u;
+    constexpr std::uint64_t favicon_bytes = 32 * 32 * 4;
+
+}
+
+auto register_residency_benchmarks(benchmark::suite& suite) -> void {
+
+    suite.add_check("residency/forgets_old_evictions", [](std::string& failure) {
+
+        // Room for one image, every frame's new one evicts the last.
+        graphics::texture_residency residency { favicon_bytes };
+        auto key = [](std::size_t const index) { return "media/favicon_" + std::to_string(index) + ".png"; };
+        auto count = graphics::texture_residency::remembered_evictions + 100;
+
+        for (std::size_t i = 0; i < count; ++i) {
+            residency.begin_frame();
+            residency.add(key(i), favicon_bytes);
+            residency.trim([](std::string const&) {});
+        }
+
+        if (residency.get_statistics().evictions != count - 1) { failure = "expected an eviction per frame"; return false; }
+
+        // Only the most recent evictions are remembered, the first ones come back as if they were new.
+        residency.begin_frame();
+        residency.add(key(0), favicon_bytes);
+        residency.add(key(count - 2), favicon_bytes);
+
+        if (residency.get_statistics().reloads != 1) {
+            failure = std::to_string(residency.get_statistics().reloads) + " reloads counted, expected only the recent one";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    // A long session with many tabs, the visible window scrolls now and then and
+    // sometimes jumps elsewhere. Counters tell how a budget holds up against it.
+    auto add_session = [&suite](std::string const& name, std::uint64_t const budget_bytes) {
+
+        suite.add(name, [budget_bytes](benchmark::context& context) {
+
+            std::vector<std::string> keys;
+            for (auto i = 0u; i < favicon_count; ++i) keys.push_back("media/favicon_" + std::to_string(i) + ".png");
+
+            graphics::residency_statistics statistics;
+
+            for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+                benchmark::random random;
+                graphics::texture_residency residency { budget_bytes };
+                residency.pin(keys[0]);
+
+                auto first_visible = 0u;
+
+                for (auto frame = 0u; frame < frames; ++frame) {
+
+                    residency.begin_frame();
+
+                    auto action = random.next(0, 99);
+                    if (action < 10) first_visible = (first_visible + 1) % (favicon_count - visible_tabs);
+                    else if (action < 12) first_visible = random.next(0, favicon_count - visible_tabs - 1);
+
+                    for (auto tab = first_visible; tab < first_visible + visible_tabs; ++tab) {
+                        if (residency.is_resident(keys[tab])) residency.touch(keys[tab]);
+                        else residency.add(keys[tab], favicon_bytes);
+                    }
+
+                    residency.trim([](std::string const& key) { benchmark::do_not_optimize(key); });
+
+                }
+
+                statistics = residency.get_statistics();
+
+            }
+
+            context.set_counter("evictions", static_cast<double>(statistics.evictions));
+            context.set_counter("reloads", static_cast<double>(statistics.reloads));
+            context.set_counter("peak_kib", static_cast<double>(statistics.peak_resident_bytes) / 1024.0);
+
+        });
+
+    };
+
+    add_session("residency/favicon_session_budget_256kib", 256 * 1024);
+    add_session("residency/favicon_session_budget_1mib", 1024 * 1024);
+
+}
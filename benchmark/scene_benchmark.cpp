@@ -0,0 +1,302 @@
+#include <string>
+#include <utility>
+#include <string_view>
+#include <vector>
+
+#include <graphics/command_list.hpp>
+#include <graphics/software_renderer.hpp>
+#include <graphics/text_cache.hpp>
+#include <gui/mock_scene.hpp>
+
+#include "benchmark.hpp"
+#include "mock_scene_fixture.hpp"
+
+namespace {
+
+    using namespace chrome;
+
+    // Counts commands by type without drawing anything, the cost of replay itself.
+    struct counting_target {
+
+        std::uint64_t fills = 0, lines = 0, images = 0, texts = 0, transforms = 0;
+
+        auto fill_rectangle(measure::rectangle<float> const&, measure::color const&) { ++fills; }
+        auto draw_line(measure::point<float> const&, measure::point<float> const&, float, measure::color const&) { ++lines; }
+        auto draw_image(resource::image const*, float, measure::point<float> const&, float) { ++images; }
+        auto draw_text(std::string_view, measure::point<float> const&, std::string_view, float, measure::color const&, graphics::font_weight) { ++texts; }
+        auto push_transform(graphics::transform const&) { ++transforms; }
+        auto pop_transform() {}
+
+    };
+
+    auto make_labels(std::size_t const count) {
+
+        std::vector<std::string> labels;
+        for (std::size_t i = 0; i < count; ++i) labels.push_back("Tab title number " + std::to_string(i));
+
+        return labels;
+
+    }
+
+    // A horizontally scrolling tab strip, most of it far outside the window.
+    auto record_tab_strip(graphics::command_list& commands, resource::image const& favicon, std::vector<std::string> const& labels, std::size_t const count) {
+
+        for (std::size_t k = 0; k < count; ++k) {
+            commands.push_transform(graphics::transform::translation(static_cast<float>(k) * 40.0f, 0.0f));
+            commands.fill_rectangle({ 0.0f, 0.0f, 38.0f, 28.0f }, measure::color { 0.9f, 0.9f, 0.9f });
+            commands.draw_image(&favicon, 1.0f, { 4.0f, 6.0f }, 1.0f);
+            commands.draw_text(labels[k], { 24.0f, 6.0f }, "Segoe UI", 12.0f, measure::color { 0.2f, 0.2f, 0.2f });
+            commands.pop_transform();
+        }
+
+    }
+
+}
+
+auto register_scene_benchmarks(benchmark::suite& suite) -> void {
+
+    suite.add_check("paint/culling_keeps_visible_pixels", [](std::string& failure) {
+
+        auto labels = make_labels(1000);
+        resource::image favicon { "media/favicon.png" };
+        graphics::bitmap favicon_pixels { 16, 16 };
+        for (auto& pixel : favicon_pixels.pixels) pixel = 0xff1a73e8u;
+
+        // Everything that can touch a 320 pixel wide target sits within the first few tabs.
+        auto paint = [&](std::size_t const count) {
+
+            graphics::command_list commands;
+            record_tab_strip(commands, favicon, labels, count);
+
+            graphics::software_renderer renderer { 320, 40 };
+            renderer.set_image_provider([&](resource::image const&) { return &favicon_pixels; });
+            renderer.begin_draw();
+            renderer.execute(commands);
+            renderer.end_draw();
+
+            return std::pair { renderer.get_target().pixels, renderer.get_culling_statistics() };
+
+        };
+
+        auto [culled_pixels, statistics] = paint(labels.size());
+        auto [reference_pixels, reference_statistics] = paint(16);
+
+        if (statistics.issued + statistics.culled != 3 * labels.size()) {
+            failure = "every draw has to be counted once";
+            return false;
+        }
+
+        if (statistics.issued != reference_statistics.issued || statistics.issued > 3 * 16) {
+            failure = std::to_string(statistics.issued) + " draws issued for 8 visible tabs";
+            return false;
+        }
+
+        if (culled_pixels != reference_pixels) {
+            failure = "culling changed what ended up on screen";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("paint/culling_keeps_stretched_strokes", [](std::string& failure) {
+
+        // Stretched horizontally, the stroke gets twice its width while the line's local bounds only grow sideways.
+        // Drawn just below the target, only the stroke reaches the last row.
+        graphics::command_list commands;
+        commands.push_transform(graphics::transform::scale(4.0f, 1.0f));
+        commands.draw_line({ 0.0f, 22.0f }, { 20.0f, 22.0f }, 2.0f, { 1.0f, 1.0f, 1.0f, 1.0f });
+        commands.pop_transform();
+
+        graphics::software_renderer renderer { 100, 21 };
+        renderer.begin_draw();
+        renderer.execute(commands);
+        renderer.end_draw();
+
+        if (renderer.get_target().row(20)[40] == 0u) {
+            failure = "a stroke reaching into the target was culled";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    suite.add("command_list/record_mock_scene", [](benchmark::context& context) {
+
+        gui::mock_scene scene;
+        graphics::command_list commands;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            commands.clear();
+            scene.record(commands, benchmark::make_client_area(1280.0f, 720.0f), benchmark::frame_height);
+            benchmark::do_not_optimize(commands);
+        }
+
+        context.set_counter("commands", static_cast<double>(commands.command_count()));
+        context.set_counter("bytes", static_cast<double>(commands.byte_size()));
+
+    });
+
+    suite.add("command_list/replay_mock_scene_counting", [](benchmark::context& context) {
+
+        gui::mock_scene scene;
+        graphics::command_list commands;
+        scene.record(commands, benchmark::make_client_area(1280.0f, 720.0f), benchmark::frame_height);
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            counting_target target;
+            commands.replay(target);
+            benchmark::do_not_optimize(target);
+        }
+
+    });
+
+    // Tab strip sized recording: a thousand labelled tabs with favicons.
+    suite.add("command_list/record_1000_tabs", [labels = make_labels(1000)](benchmark::context& context) {
+
+        resource::image favicon { "media/favicon.png" };
+        graphics::command_list commands;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            commands.clear();
+            record_tab_strip(commands, favicon, labels, labels.size());
+
+            benchmark::do_not_optimize(commands);
+
+        }
+
+        context.set_counter("bytes", static_cast<double>(commands.byte_size()));
+
+    });
+
+    // Steady state: every label of a frame hits the cache.
+    suite.add("text_cache/lookup_hits_200_labels", [labels = make_labels(200)](benchmark::context& context) {
+
+        graphics::text_cache<int, int> cache;
+        auto created = 0;
+        auto create_format = [&created](graphics::text_format_view const&) { return ++created; };
+        auto create_layout = [&created](graphics::text_layout_view const&) { return ++created; };
+
+        auto lookup_all = [&] {
+            auto sum = 0;
+            for (auto& label : labels) {
+                auto format = graphics::text_format_view { "Segoe UI", 12.0f, graphics::font_weight::normal, graphics::font_style::normal };
+                sum += cache.get_format(format, create_format);
+                sum += cache.get_layout({ label, format, 5000.0f }, create_layout);
+            }
+            return sum;
+        };
+
+        lookup_all();
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) benchmark::do_not_optimize(lookup_all());
+
+        context.set_counter("layout_hits", static_cast<double>(cache.get_layout_statistics().hits));
+
+    });
+
+    // More distinct labels than the cache holds, every lookup misses and evicts.
+    suite.add("text_cache/lookup_misses_1000_labels", [labels = make_labels(1000)](benchmark::context& context) {
+
+        graphics::text_cache<int, int> cache;
+        auto create = [](auto const&) { return 1; };
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            auto sum = 0;
+            for (auto& label : labels) {
+                auto format = graphics::text_format_view { "Segoe UI", 12.0f, graphics::font_weight::normal, graphics::font_style::normal };
+                sum += cache.get_layout({ label, format, 5000.0f }, create);
+            }
+            benchmark::do_not_optimize(sum);
+        }
+
+        context.set_counter("layout_evictions", static_cast<double>(cache.get_layout_statistics().evictions));
+
+    });
+
+    // The whole window::paint path on a CPU target, at 100% and 150% scaling.
+    auto add_paint = [&suite](std::string const& name, std::uint32_t const width, std::uint32_t const height, float const dpi) {
+
+        suite.add(name, [width, height, dpi](benchmark::context& context) {
+
+            auto scaling = dpi / 96.0f;
+            gui::mock_scene scene;
+            benchmark::mock_images images;
+
+            graphics::command_list commands;
+            scene.record(commands, benchmark::make_client_area(static_cast<float>(width) / scaling, static_cast<float>(height) / scaling), benchmark::frame_height);
+
+            graphics::software_renderer renderer { width, height, dpi };
+            renderer.set_image_provider(images.provider(scene));
+
+            for (std::uint64_t i = 0; i < context.iterations; ++i) {
+                renderer.begin_draw();
+                renderer.execute(commands);
+                renderer.end_draw();
+            }
+
+            benchmark::do_not_optimize(renderer.get_target().pixels.data());
+            context.set_counter("megapixels", static_cast<double>(width) * height / 1e6);
+
+        });
+
+    };
+
+    add_paint("paint/mock_scene_software_1280x720", 1280, 720, 96.0f);
+    add_paint("paint/mock_scene_software_1920x1080_150_percent", 1920, 1080, 144.0f);
+
+    // Damage sized repaint, a hovered tab.
+    suite.add("paint/mock_scene_software_damage_200x40", [](benchmark::context& context) {
+
+        gui::mock_scene scene;
+        benchmark::mock_images images;
+
+        graphics::command_list commands;
+        scene.record(commands, benchmark::make_client_area(1280.0f, 720.0f), benchmark::frame_height);
+
+        graphics::software_renderer renderer { 1280, 720 };
+        renderer.set_image_provider(images.provider(scene));
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            renderer.reset_culling_statistics();
+            renderer.begin_draw({ 220, 0, 200, 40 });
+            renderer.execute(commands);
+            renderer.end_draw();
+        }
+
+        benchmark::do_not_optimize(renderer.get_target().pixels.data());
+        context.set_counter("issued", static_cast<double>(renderer.get_culling_statistics().issued));
+        context.set_counter("culled", static_cast<double>(renderer.get_culling_statistics().culled));
+
+    });
+
+    // A thousand tabs painted into a window that shows a few dozen, culling keeps it at the visible cost.
+    suite.add("paint/tab_strip_1000_tabs_software_1280x40", [labels = make_labels(1000)](benchmark::context& context) {
+
+        resource::image favicon { "media/favicon.png" };
+        graphics::bitmap favicon_pixels { 16, 16 };
+        for (auto& pixel : favicon_pixels.pixels) pixel = 0xff1a73e8u;
+
+        graphics::command_list commands;
+        record_tab_strip(commands, favicon, labels, labels.size());
+
+        graphics::software_renderer renderer { 1280, 40 };
+        renderer.set_image_provider([&](resource::image const&) { return &favicon_pixels; });
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            renderer.reset_culling_statistics();
+            renderer.begin_draw();
+            renderer.execute(commands);
+            renderer.end_draw();
+        }
+
+        benchmark::do_not_optimize(renderer.get_target().pixels.data());
+        context.set_counter("issued", static_cast<double>(renderer.get_culling_statistics().issued));
+        context.set_counter("culled", static_cast<double>(renderer.get_culling_statistics().culled));
+
+    });
+
+}
@@ -0,0 +1,127 @@
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <utility/startup_timeline.hpp>
+#include <graphics/layer_tree.hpp>
+#include <graphics/software_renderer.hpp>
+#include <gui/mock_scene.hpp>
+
+#include "benchmark.hpp"
+#include "mock_scene_fixture.hpp"
+
+namespace {
+
+    using namespace chrome;
+
+    auto to_milliseconds(utility::startup_timeline::clock::duration const duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+}
+
+auto register_startup_benchmarks(benchmark::suite& suite) -> void {
+
+    suite.add_check("startup/timeline_records_phases_across_threads", [](std::string& failure) {
+
+        utility::startup_timeline timeline;
+
+        {
+            auto phase = timeline.measure("main");
+            std::thread worker { [&timeline] { auto phase = timeline.measure("worker"); } };
+            worker.join();
+        }
+
+        timeline.mark("first frame");
+        auto first = timeline.get_milestone("first frame");
+        timeline.mark("first frame");
+
+        auto phases = timeline.get_phases();
+        if (phases.size() != 2 || phases[0].name != "main" || phases[1].name != "worker") {
+            failure = "phases aren't sorted by when they started";
+            return false;
+        }
+
+        if (phases[0].thread == phases[1].thread || phases[1].end > phases[0].end) {
+            failure = "the worker's phase isn't on its own thread or doesn't nest";
+            return false;
+        }
+
+        if (!first || timeline.get_milestone("first frame") != first || timeline.get_milestone("unknown")) {
+            failure = "milestones aren't kept at the first time they're reached";
+            return false;
+        }
+
+        auto report = timeline.report();
+        if (report.find("] worker") == std::string::npos || report.find("ms  first frame") == std::string::npos) {
+            failure = "unexpected report:\n" + report;
+            return false;
+        }
+
+        return true;
+
+    });
+
+    // Everything the first frame needs past the devices: the scene and its layers, layout and recording,
+    // and rasterizing it. Images are still decoding at that point, so none are drawn.
+    suite.add("startup/mock_scene_first_frame_software_1280x720", [](benchmark::context& context) {
+
+        auto const width = 1280u, height = 720u;
+
+        std::vector<double> scene_ms, record_ms, rasterize_ms, first_frame_ms;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            utility::startup_timeline timeline;
+            auto client_area = benchmark::make_client_area(static_cast<float>(width), static_cast<float>(height));
+
+            gui::mock_scene scene;
+            graphics::layer_tree layers;
+            graphics::command_list commands;
+
+            {
+                auto phase = timeline.measure("scene");
+                scene.add_layers(layers);
+            }
+
+            {
+                auto phase = timeline.measure("layout and record");
+                scene.layout(layers, client_area, benchmark::frame_height);
+                scene.record_layers(layers);
+                scene.record(commands, client_area, benchmark::frame_height);
+            }
+
+            {
+                auto phase = timeline.measure("rasterize");
+                graphics::software_renderer renderer { width, height };
+                renderer.begin_draw();
+                renderer.execute(commands);
+                renderer.end_draw();
+                benchmark::do_not_optimize(renderer.get_target().pixels.data());
+            }
+
+            timeline.mark("first frame");
+
+            auto phases = timeline.get_phases();
+            scene_ms.push_back(to_milliseconds(phases[0].end - phases[0].start));
+            record_ms.push_back(to_milliseconds(phases[1].end - phases[1].start));
+            rasterize_ms.push_back(to_milliseconds(phases[2].end - phases[2].start));
+            first_frame_ms.push_back(to_milliseconds(*timeline.get_milestone("first frame")));
+
+        }
+
+        auto average = [](std::vector<double> const& samples) {
+            auto sum = 0.0;
+            for (auto sample : samples) sum += sample;
+            return samples.empty() ? 0.0 : sum / static_cast<double>(samples.size());
+        };
+
+        context.set_counter("scene_ms", average(scene_ms));
+        context.set_counter("layout_and_record_ms", average(record_ms));
+        context.set_counter("rasterize_ms", average(rasterize_ms));
+        context.set_counter("first_frame_ms", average(first_frame_ms));
+
+    });
+
+}
@@ -0,0 +1,249 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <graphics/font.hpp>
+#include <graphics/software_renderer.hpp>
+#include <graphics/text_fitting.hpp>
+
+#include "benchmark.hpp"
+
+namespace {
+
+    using chrome::graphics::fitted_text;
+    using chrome::graphics::font_advances;
+    using chrome::graphics::font_weight;
+    using chrome::graphics::text_fitter;
+
+    // Proportional enough that cut off points differ from a fixed pitch font, roughly Segoe UI.
+    auto make_proportional_advances() {
+
+        font_advances advances;
+        for (std::size_t i = 0; i < advances.ascii.size(); ++i) advances.ascii[i] = 0.45f + static_cast<float>(i % 7) * 0.04f;
+
+        advances.ascii[' '] = 0.27f;
+        advances.ascii['i'] = advances.ascii['l'] = 0.24f;
+        advances.ascii['m'] = advances.ascii['W'] = 0.88f;
+        advances.fallback = 0.6f;
+        advances.ellipsis = 0.75f;
+
+        return advances;
+
+    }
+
+    auto proportional_provider(std::string_view, font_weight) { return make_proportional_advances(); }
+
+    auto make_titles(std::size_t const count, std::uint64_t const seed) {
+
+        static constexpr std::string_view words[] = {
+            "Expand", "the", "frame", "into", "title", "bar", "with", "DwmExtendFrameIntoClientArea", "Recompute",
+            "window", "region", "when", "is", "resized", "Straße", "über", "Привет", "мир", "日本語", "タブ", "wiki"
+        };
+
+        benchmark::random random { seed };
+        std::vector<std::string> titles;
+
+        for (std::size_t i = 0; i < count; ++i) {
+
+            auto& title = titles.emplace_back();
+            for (auto word_count = random.next(1, 12); word_count-- > 0;) {
+                if (!title.empty()) title += ' ';
+                title += words[random.next(0, std::size(words) - 1)];
+            }
+
+        }
+
+        return titles;
+
+    }
+
+    auto is_continuation(char const character) { return (static_cast<unsigned char>(character) & 0xc0u) == 0x80u; }
+
+    // What the fitter is checked against and the uncached baseline: walks the whole label on every call.
+    auto fit_linearly(std::string_view text, font_advances const& advances, float const font_size, float const available) {
+
+        auto advance_of = [&](unsigned char const lead) { return lead < 0x80 ? advances.ascii[lead] : advances.fallback; };
+
+        auto total = 0.0f;
+        for (auto character : text)
+            if (!is_continuation(character)) total += advance_of(static_cast<unsigned char>(character));
+
+        if (total * font_size <= available) return fitted_text { std::string { text }, total * font_size, false };
+
+        auto limit = available / font_size - advances.ellipsis;
+        auto width = 0.0f, kept_width = 0.0f;
+        std::size_t kept = 0;
+
+        for (std::size_t position = 0; position < text.size();) {
+
+            auto end = position + 1;
+            while (end < text.size() && is_continuation(text[end])) ++end;
+
+            width += advance_of(static_cast<unsigned char>(text[position]));
+            if (width > limit) break;
+
+            position = end;
+            if (text[end - 1] != ' ') { kept = end; kept_width = width; }
+
+        }
+
+        return fitted_text { std::string { text.substr(0, kept) } + std::string { text_fitter::ellipsis }, (kept_width + advances.ellipsis) * font_size, true };
+
+    }
+
+}
+
+auto register_text_fitting_benchmarks(benchmark::suite& suite) -> void {
+
+    auto font = chrome::graphics::intern_font_family("Segoe UI");
+
+    suite.add_check("text_fitter/matches_linear_fit", [font](std::string& failure) {
+
+        auto titles = make_titles(64, 7);
+        auto advances = make_proportional_advances();
+
+        // Whole DIP buckets, so every width in one has the same linear fit at its lower edge.
+        text_fitter fitter { proportional_provider, 1.0f };
+
+        for (auto& title : titles) {
+            for (auto max_width = 0.0f; max_width < 400.0f; max_width += 0.75f) {
+
+                auto& fitted = fitter.fit(title, font, 14.0f, max_width);
+                auto expected = fit_linearly(title, advances, 14.0f, std::floor(max_width));
+
+                if (fitted.text != expected.text || fitted.is_truncated != expected.is_truncated || std::abs(fitted.width - expected.width) > 1e-3f) {
+                    failure = "\"" + title + "\" at " + std::to_string(max_width) + " fitted as \"" + fitted.text + "\", expected \"" + expected.text + "\"";
+                    return false;
+                }
+
+                // Only the ellipsis alone is allowed to stick out.
+                if (fitted.width > max_width && fitted.text != text_fitter::ellipsis) {
+                    failure = "\"" + fitted.text + "\" is wider than " + std::to_string(max_width);
+                    return false;
+                }
+
+            }
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("text_fitter/keeps_code_points_whole", [font](std::string& failure) {
+
+        text_fitter fitter { proportional_provider };
+        std::string title = "日本語のタブ Привет мир Straße";
+
+        for (auto max_width = 0.0f; max_width < 300.0f; max_width += 1.0f) {
+
+            auto& fitted = fitter.fit(title, font, 14.0f, max_width);
+            if (!fitted.is_truncated) continue;
+
+            auto prefix = std::string_view { fitted.text }.substr(0, fitted.text.size() - text_fitter::ellipsis.size());
+            if (title.compare(0, prefix.size(), prefix) != 0 || is_continuation(title[prefix.size()]) || (!prefix.empty() && prefix.back() == ' ')) {
+                failure = "cut \"" + fitted.text + "\" at " + std::to_string(max_width);
+                return false;
+            }
+
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("text_fitter/handles_empty_text_and_tiny_widths", [font](std::string& failure) {
+
+        text_fitter fitter { proportional_provider };
+
+        // Copies, every fit reuses the same result.
+        auto empty = fitter.fit("", font, 14.0f, 0.0f);
+        auto squeezed = fitter.fit("Recompute", font, 14.0f, 0.0f);
+        auto measured = fitter.measure("", font, 14.0f);
+
+        if (empty.text != "" || empty.is_truncated || measured != 0.0f) { failure = "empty text"; return false; }
+        if (squeezed.text != text_fitter::ellipsis || !squeezed.is_truncated) { failure = "zero width gave \"" + squeezed.text + "\""; return false; }
+
+        return true;
+
+    });
+
+    suite.add_check("text_fitter/evictions_match_a_fresh_fitter", [font](std::string& failure) {
+
+        auto titles = make_titles(48, 11);
+
+        // Few enough measurements that sweeping every title evicts them, while the first few titles on their
+        // own stay and collect more cuts than a label keeps.
+        text_fitter cached { proportional_provider, 2.0f, 8 };
+
+        auto compare = [&](std::string const& title, float const font_size, float const max_width) {
+
+            text_fitter fresh { proportional_provider };
+            auto expected = fresh.fit(title, font, font_size, max_width).text;
+            if (cached.fit(title, font, font_size, max_width).text == expected) return true;
+
+            failure = "\"" + title + "\" fitted differently after evictions";
+            return false;
+
+        };
+
+        for (auto round = 0; round < 3; ++round) {
+
+            for (auto max_width = 40.0f; max_width < 240.0f; max_width += 7.0f)
+                for (auto& title : titles)
+                    if (!compare(title, 12.0f, max_width)) return false;
+
+            for (auto title = titles.begin(); title != titles.begin() + 4; ++title)
+                for (auto max_width = 0.0f; max_width < 400.0f; max_width += 1.0f)
+                    if (!compare(*title, 12.0f + static_cast<float>(round), max_width)) return false;
+
+        }
+
+        return true;
+
+    });
+
+    // A tab strip of 200 tabs resized one DIP per frame, back and forth like a drag.
+    auto titles = make_titles(200, 3);
+    auto tab_width = [](std::uint64_t const frame) { return 60.0f + static_cast<float>(frame % 160 < 80 ? frame % 160 : 160 - frame % 160); };
+
+    suite.add("text_fitter/resize_200_tabs", [font, titles, tab_width](benchmark::context& context) {
+
+        text_fitter fitter { [](std::string_view, font_weight) { return chrome::graphics::software_renderer::get_font_advances(); } };
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            auto width = tab_width(i);
+            for (auto& title : titles) benchmark::do_not_optimize(fitter.fit(title, font, 14.0f, width).width);
+
+        }
+
+        auto fits = fitter.get_statistics().fits;
+        context.set_counter("hit rate", static_cast<double>(fits.hits) / static_cast<double>(std::max<std::uint64_t>(fits.hits + fits.misses, 1)));
+
+    });
+
+    suite.add("text_fitter/resize_200_tabs_uncached", [titles, tab_width](benchmark::context& context) {
+
+        auto advances = chrome::graphics::software_renderer::get_font_advances();
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            auto width = tab_width(i);
+            for (auto& title : titles) benchmark::do_not_optimize(fit_linearly(title, advances, 14.0f, width).width);
+
+        }
+
+    });
+
+    suite.add("text_fitter/fit_hit", [font](benchmark::context& context) {
+
+        text_fitter fitter { proportional_provider };
+        std::string_view title = "Expand the frame into the title bar with DwmExtendFrameIntoClientArea";
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) benchmark::do_not_optimize(fitter.fit(title, font, 14.0f, 160.0f).width);
+
+    });
+
+}
@@ -0,0 +1,210 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <utility/work_stealing_pool.hpp>
+#include <graphics/command_list.hpp>
+#include <graphics/software_renderer.hpp>
+#include <graphics/tiled_renderer.hpp>
+#include <gui/mock_scene.hpp>
+
+#include "benchmark.hpp"
+#include "mock_scene_fixture.hpp"
+
+namespace {
+
+    using namespace chrome;
+
+    // Everything the rasterizer has a path for, at fractional positions and under nested transforms,
+    // so plenty of edges land on tile boundaries with partial coverage.
+    auto record_random_scene(graphics::command_list& commands, resource::image const& image, std::uint32_t const seed) {
+
+        benchmark::random random { seed };
+        auto coordinate = [&random](std::uint32_t const range) { return static_cast<float>(random.next(0, range * 8)) / 8.0f; };
+        auto color = [&random] {
+            return measure::color { static_cast<float>(random.next(0, 255)) / 255.0f, static_cast<float>(random.next(0, 255)) / 255.0f, 0.5f, static_cast<float>(random.next(32, 255)) / 255.0f };
+        };
+
+        for (auto group = 0; group < 8; ++group) {
+
+            commands.push_transform(graphics::transform::translation(coordinate(300), coordinate(200)));
+            if (group % 3 == 0) commands.push_transform(graphics::transform::scale(1.5f, 0.75f));
+
+            for (auto i = 0; i < 12; ++i) {
+                commands.fill_rectangle({ coordinate(400), coordinate(300), coordinate(200), coordinate(120) }, color());
+                commands.draw_line({ coordinate(400), coordinate(300) }, { coordinate(400), coordinate(300) }, 1.0f + coordinate(4), color());
+                commands.draw_line({ coordinate(400), 100.5f }, { coordinate(400), 100.5f }, 1.5f, color());
+                commands.draw_image(&image, 0.5f + coordinate(2), { coordinate(400), coordinate(300) }, 0.8f);
+                commands.draw_text("Tiled text run", { coordinate(400), coordinate(300) }, "Segoe UI", 9.0f + coordinate(12), color());
+            }
+
+            if (group % 3 == 0) commands.pop_transform();
+            commands.pop_transform();
+
+        }
+
+    }
+
+    auto render_untiled(graphics::command_list const& commands, graphics::software_renderer::image_provider provider, std::uint32_t const width, std::uint32_t const height, float const dpi) {
+
+        graphics::software_renderer renderer { width, height, dpi };
+        renderer.set_image_provider(std::move(provider));
+        renderer.begin_draw();
+        renderer.execute(commands);
+        renderer.end_draw();
+
+        return renderer.get_target().pixels;
+
+    }
+
+}
+
+auto register_tile_benchmarks(benchmark::suite& suite) -> void {
+
+    suite.add_check("work_stealing_pool/runs_every_index_once", [](std::string& failure) {
+
+        utility::work_stealing_pool pool { 4 };
+        std::vector<std::atomic<std::uint32_t>> runs(997);
+
+        // Work piles up at the front, whoever owns the back half runs dry and has to steal.
+        for (auto round = 0; round < 20; ++round) {
+            pool.run(runs.size(), [&runs](std::size_t const index, std::size_t) {
+                if (index < 64) std::this_thread::sleep_for(std::chrono::microseconds { 50 });
+                runs[index].fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+
+        for (std::size_t i = 0; i < runs.size(); ++i) {
+            if (runs[i].load() != 20) {
+                failure = "index " + std::to_string(i) + " ran " + std::to_string(runs[i].load()) + " times in 20 rounds";
+                return false;
+            }
+        }
+
+        pool.run(0, [](std::size_t, std::size_t) {});
+        return true;
+
+    });
+
+    suite.add_check("tiled_renderer/matches_software_renderer", [](std::string& failure) {
+
+        resource::image image { "media/favicon.png" };
+        graphics::bitmap image_pixels { 24, 24 };
+        benchmark::random random;
+        for (auto& pixel : image_pixels.pixels) pixel = 0xff000000u | static_cast<std::uint32_t>(random.next() & 0x00ffffffu);
+        auto provider = [&image_pixels](resource::image const&) { return &image_pixels; };
+
+        gui::mock_scene scene;
+        benchmark::mock_images images;
+
+        struct test_case {
+            std::string name;
+            graphics::command_list commands;
+            graphics::software_renderer::image_provider provider;
+            std::uint32_t width, height;
+            float dpi;
+        };
+
+        std::vector<test_case> cases;
+
+        auto& mock = cases.emplace_back(test_case { "mock scene at 150%", {}, images.provider(scene), 1000, 700, 144.0f });
+        scene.record(mock.commands, benchmark::make_client_area(1000.0f / 1.5f, 700.0f / 1.5f), benchmark::frame_height);
+
+        for (std::uint32_t seed = 1; seed <= 4; ++seed) {
+            auto& random_case = cases.emplace_back(test_case { "random scene " + std::to_string(seed), {}, provider, 517, 389, seed % 2 ? 96.0f : 120.0f });
+            record_random_scene(random_case.commands, image, seed);
+        }
+
+        for (auto& [name, commands, case_provider, width, height, dpi] : cases) {
+
+            auto reference = render_untiled(commands, case_provider, width, height, dpi);
+
+            for (std::size_t workers : { 1, 3, 8 }) {
+
+                utility::work_stealing_pool pool { workers };
+                graphics::tiled_renderer renderer { width, height, pool, dpi };
+                renderer.set_image_provider(case_provider);
+                renderer.render(commands);
+
+                if (renderer.get_target().pixels != reference) {
+                    failure = name + " with " + std::to_string(workers) + " workers differs from the untiled render";
+                    return false;
+                }
+
+                // A partial update leaves everything outside of it alone.
+                auto pixels = renderer.get_target().pixels;
+                renderer.render(commands, { 70, 50, 130, 97 });
+
+                if (renderer.get_target().pixels != pixels) {
+                    failure = name + " with " + std::to_string(workers) + " workers changed under a partial update";
+                    return false;
+                }
+
+            }
+
+        }
+
+        return true;
+
+    });
+
+    // The same 4K frame at 200% on 1 to 8 workers, against the untiled renderer on one thread.
+    // Speedup tops out at the number of hardware threads the machine has.
+    constexpr std::uint32_t width = 3840, height = 2160;
+    constexpr auto dpi = 192.0f;
+
+    suite.add("tiled_renderer/mock_scene_3840x2160_200_percent_untiled", [](benchmark::context& context) {
+
+        gui::mock_scene scene;
+        benchmark::mock_images images;
+
+        graphics::command_list commands;
+        scene.record(commands, benchmark::make_client_area(width / 2.0f, height / 2.0f), benchmark::frame_height);
+
+        graphics::software_renderer renderer { width, height, dpi };
+        renderer.set_image_provider(images.provider(scene));
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            renderer.begin_draw();
+            renderer.execute(commands);
+            renderer.end_draw();
+        }
+
+        benchmark::do_not_optimize(renderer.get_target().pixels.data());
+
+    });
+
+    for (std::size_t workers : { 1, 2, 4, 8 }) {
+
+        suite.add("tiled_renderer/mock_scene_3840x2160_200_percent_" + std::to_string(workers) + "_workers", [workers](benchmark::context& context) {
+
+            gui::mock_scene scene;
+            benchmark::mock_images images;
+
+            graphics::command_list commands;
+            scene.record(commands, benchmark::make_client_area(width / 2.0f, height / 2.0f), benchmark::frame_height);
+
+            utility::work_stealing_pool pool { workers };
+            graphics::tiled_renderer renderer { width, height, pool, dpi };
+            renderer.set_image_provider(images.provider(scene));
+
+            auto steals = pool.get_steal_count();
+            for (std::uint64_t i = 0; i < context.iterations; ++i) renderer.render(commands);
+
+            benchmark::do_not_optimize(renderer.get_target().pixels.data());
+
+            auto& statistics = renderer.get_statistics();
+            context.set_counter("tiles", statistics.tiles);
+            context.set_counter("empty_tiles", statistics.empty_tiles);
+            context.set_counter("binned_per_primitive", static_cast<double>(statistics.binned) / statistics.primitives);
+            context.set_counter("steals_per_frame", static_cast<double>(pool.get_steal_count() - steals) / static_cast<double>(context.iterations));
+            context.set_counter("hardware_threads", std::thread::hardware_concurrency());
+
+        });
+
+    }
+
+}
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <graphics/command_list.hpp>
+#include <graphics/font.hpp>
+#include <utility/string_interner.hpp>
+#include <utility/utf8.hpp>
+
+#include "benchmark.hpp"
+
+namespace {
+
+    auto append_utf8(std::string& utf8, char32_t const code_point) {
+
+        if (code_point < 0x80) utf8 += static_cast<char>(code_point);
+        else if (code_point < 0x800) {
+            utf8 += static_cast<char>(0xc0 | (code_point >> 6));
+            utf8 += static_cast<char>(0x80 | (code_point & 0x3f));
+        }
+        else if (code_point < 0x10000) {
+            utf8 += static_cast<char>(0xe0 | (code_point >> 12));
+            utf8 += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+            utf8 += static_cast<char>(0x80 | (code_point & 0x3f));
+        }
+        else {
+            utf8 += static_cast<char>(0xf0 | (code_point >> 18));
+            utf8 += static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+            utf8 += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+            utf8 += static_cast<char>(0x80 | (code_point & 0x3f));
+        }
+
+    }
+
+    auto append_utf16(std::u16string& utf16, char32_t const code_point) {
+
+        if (code_point < 0x10000) { utf16 += static_cast<char16_t>(code_point); return; }
+
+        utf16 += static_cast<char16_t>(0xd800 + ((code_point - 0x10000) >> 10));
+        utf16 += static_cast<char16_t>(0xdc00 + ((code_point - 0x10000) & 0x3ff));
+
+    }
+
+    // Random valid text, weighted towards whatever a script of the given kind mostly consists of.
+    auto make_text(std::size_t const code_points, std::uint32_t const ascii_percent, std::uint64_t const seed) {
+
+        benchmark::random random { seed };
+        std::string utf8;
+        std::u16string utf16;
+
+        for (std::size_t i = 0; i < code_points; ++i) {
+
+            char32_t code_point;
+            if (random.next(0, 99) < ascii_percent) code_point = random.next(0x20, 0x7e);
+            else switch (random.next(0, 3)) {
+                case 0: code_point = random.next(0xc0, 0x17f); break;         // Accented Latin.
+                case 1: code_point = random.next(0x410, 0x44f); break;        // Cyrillic.
+                case 2: code_point = random.next(0x4e00, 0x9fff); break;      // CJK.
+                default: code_point = random.next(0x1f300, 0x1f64f); break;   // Emoji, surrogate pairs.
+            }
+
+            append_utf8(utf8, code_point);
+            append_utf16(utf16, code_point);
+
+        }
+
+        return std::pair { utf8, utf16 };
+
+    }
+
+    auto transcode(std::string_view utf8) {
+
+        std::u16string utf16(utf8.size(), u'\0');
+        auto result = utility::transcode_utf8_to_utf16(utf8, utf16.data());
+        utf16.resize(result.length);
+
+        return std::pair { utf16, result.invalid_sequences };
+
+    }
+
+    // What the SIMD path is measured against, a byte at a time with no ASCII shortcut.
+    auto transcode_scalar(std::string_view utf8, char16_t* output) {
+
+        auto start = output;
+        for (std::size_t i = 0; i < utf8.size();) {
+
+            auto lead = static_cast<unsigned char>(utf8[i]);
+            auto length = lead < 0x80 ? 1 : lead < 0xe0 ? 2 : lead < 0xf0 ? 3 : 4;
+            char32_t code_point = length == 1 ? lead : lead & (0x7f >> length);
+
+            for (auto j = 1; j < length; ++j) code_point = (code_point << 6) | (static_cast<unsigned char>(utf8[i + j]) & 0x3f);
+            i += static_cast<std::size_t>(length);
+
+            if (code_point < 0x10000) *output++ = static_cast<char16_t>(code_point);
+            else {
+                *output++ = static_cast<char16_t>(0xd800 + ((code_point - 0x10000) >> 10));
+                *output++ = static_cast<char16_t>(0xdc00 + ((code_point - 0x10000) & 0x3ff));
+            }
+
+        }
+
+        return static_cast<std::size_t>(output - start);
+
+    }
+
+    constexpr auto label = std::string_view { "Chrome management - Settings" };
+
+}
+
+auto register_utf8_benchmarks(benchmark::suite& suite) -> void {
+
+    suite.add_check("utf8/matches_reference_encoding", [](std::string& failure) {
+
+        // Every length up to a few vectors, so each prefix and tail split of the ASCII path is covered.
+        for (std::uint32_t ascii_percent : { 100, 95, 50, 0 }) {
+            for (std::size_t code_points = 0; code_points < 70; ++code_points) {
+
+                auto [utf8, expected] = make_text(code_points, ascii_percent, code_points * 131 + ascii_percent + 1);
+                auto [utf16, invalid] = transcode(utf8);
+
+                if (utf16 != expected || invalid != 0) {
+                    failure = std::to_string(code_points) + " code points at " + std::to_string(ascii_percent) + "% ASCII transcoded wrong";
+                    return false;
+                }
+
+            }
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("utf8/replaces_malformed_sequences", [](std::string& failure) {
+
+        struct test_case {
+            std::string_view utf8;
+            std::u16string_view expected;
+        };
+
+        // One U+FFFD per maximal subpart, as recommended by the Unicode standard and done by MultiByteToWideChar.
+        test_case cases[] = {
+            { "\x80", u"\xfffd" },
+            { "a\xbf" "b", u"a\xfffd" u"b" },
+            { "\xc0\xaf", u"\xfffd\xfffd" },                        // Overlong, C0 and C1 never start anything.
+            { "\xe0\x80\xaf", u"\xfffd\xfffd\xfffd" },              // Overlong three byte form.
+            { "\xed\xa0\x80", u"\xfffd\xfffd\xfffd" },              // Encoded surrogate.
+            { "\xf4\x90\x80\x80", u"\xfffd\xfffd\xfffd\xfffd" },    // Past U+10FFFF.
+            { "\xf5\x80", u"\xfffd\xfffd" },
+            { "\xe2\x82", u"\xfffd" },                              // Cut off at the end.
+            { "\xf0\x9f\x98" "b", u"\xfffd" u"b" },                 // Cut off by the next character.
+            { "\xe2\x82\xac\xf0\x9f\x98\x80", u"\x20ac\xd83d\xde00" },
+            { "0123456789abcdef\xff" "0123456789abcdef", u"0123456789abcdef\xfffd" u"0123456789abcdef" }
+        };
+
+        for (auto& [utf8, expected] : cases) {
+
+            auto [utf16, invalid] = transcode(utf8);
+            auto expected_invalid = static_cast<std::size_t>(std::count(expected.begin(), expected.end(), u'\xfffd'));
+
+            if (utf16 != expected || invalid != expected_invalid) {
+                failure = "malformed case " + std::to_string(&utf8 - &cases[0].utf8) + " transcoded wrong";
+                return false;
+            }
+
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("utf16_buffer/grows_past_inline_storage", [](std::string& failure) {
+
+        utility::utf16_buffer<16> buffer;
+        buffer.assign(label.substr(0, 15));
+
+        if (!buffer.is_inline() || buffer.view() != u"Chrome manageme" || buffer.c_str()[buffer.size()] != u'\0') {
+            failure = "a short string wasn't kept inline";
+            return false;
+        }
+
+        auto [long_text, expected] = make_text(300, 50, 7);
+        buffer.assign(long_text);
+
+        if (buffer.is_inline() || buffer.view() != expected || buffer.c_str()[buffer.size()] != u'\0') {
+            failure = "a long string wasn't transcoded into the heap buffer";
+            return false;
+        }
+
+        return true;
+
+    });
+
+    suite.add_check("string_interner/ids_are_stable_across_threads", [](std::string& failure) {
+
+        utility::string_interner interner;
+        std::vector<std::string> names;
+        for (auto i = 0; i < 200; ++i) names.push_back("family " + std::to_string(i));
+
+        std::vector<std::vector<utility::string_id>> ids(4);
+        std::vector<std::thread> threads;
+
+        for (std::size_t t = 0; t < ids.size(); ++t) {
+            threads.emplace_back([&, t] {
+                for (auto& name : names) ids[t].push_back(interner.intern(name));
+            });
+        }
+
+        for (auto& thread : threads) thread.join();
+
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            for (auto& thread_ids : ids) {
+                if (thread_ids[i] != ids[0][i] || interner.get(thread_ids[i]) != names[i]) {
+                    failure = names[i] + " got different ids or came back different";
+                    return false;
+                }
+            }
+        }
+
+        if (interner.size() != names.size()) {
+            failure = "interned " + std::to_string(interner.size()) + " strings out of " + std::to_string(names.size());
+            return false;
+        }
+
+        return true;
+
+    });
+
+    suite.add("utf8/transcode_label", [](benchmark::context& context) {
+
+        utility::utf16_buffer<> buffer;
+        for (std::uint64_t i = 0; i < context.iterations; ++i) buffer.assign(label);
+
+        benchmark::do_not_optimize(buffer.c_str());
+
+    });
+
+    // What convert_utf8_to_utf16 did for every label, a fresh string per call.
+    suite.add("utf8/transcode_label_allocating", [](benchmark::context& context) {
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+            auto utf16 = transcode(label).first;
+            benchmark::do_not_optimize(utf16.data());
+        }
+
+    });
+
+    for (std::uint32_t ascii_percent : { 100, 90, 0 }) {
+
+        auto suffix = "_16k_" + std::to_string(ascii_percent) + "_percent_ascii";
+
+        suite.add("utf8/transcode" + suffix, [ascii_percent](benchmark::context& context) {
+
+            auto utf8 = make_text(16384, ascii_percent, 1).first;
+            std::vector<char16_t> utf16(utf8.size());
+
+            for (std::uint64_t i = 0; i < context.iterations; ++i) {
+                auto result = utility::transcode_utf8_to_utf16(utf8, utf16.data());
+                benchmark::do_not_optimize(result);
+            }
+
+            context.set_counter("bytes", static_cast<double>(utf8.size()));
+
+        });
+
+        suite.add("utf8/transcode_scalar" + suffix, [ascii_percent](benchmark::context& context) {
+
+            auto utf8 = make_text(16384, ascii_percent, 1).first;
+            std::vector<char16_t> utf16(utf8.size());
+
+            for (std::uint64_t i = 0; i < context.iterations; ++i) {
+                auto length = transcode_scalar(utf8, utf16.data());
+                benchmark::do_not_optimize(length);
+            }
+
+            context.set_counter("bytes", static_cast<double>(utf8.size()));
+
+        });
+
+    }
+
+    // Recording a label, with the family interned instead of copied into the string pool.
+    suite.add("command_list/record_text_labels", [](benchmark::context& context) {
+
+        chrome::graphics::command_list commands;
+
+        for (std::uint64_t i = 0; i < context.iterations; ++i) {
+
+            commands.clear();
+            for (auto j = 0; j < 32; ++j)
+                commands.draw_text(label, { 10.0f, 20.0f * static_cast<float>(j) }, "Segoe UI", 12.0f, { 0.0f, 0.0f, 0.0f, 1.0f });
+
+            benchmark::do_not_optimize(commands.byte_size());
+
+        }
+
+    });
+
+}
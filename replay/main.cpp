@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <utility/command_line.hpp>
+#include <utility/work_stealing_pool.hpp>
+#include <graphics/bitmap.hpp>
+#include <graphics/frame_capture.hpp>
+#include <graphics/pixel_kernels.hpp>
+#include <graphics/software_compositor.hpp>
+#include <graphics/tiled_renderer.hpp>
+
+// Replays a frame written with --capture=<directory> without a window or a GPU, either through the
+// software compositor (every layer on its own surface, composited like DComp would) or flattened onto the
+// tiled renderer. The images a capture references are replaced by opaque placeholders of the size they
+// had, so timings hold up but image pixels won't match the real thing.
+
+using namespace chrome;
+
+namespace {
+
+    struct options {
+        std::string capture_path;
+        std::string backend = "software";
+        std::size_t threads = 0;
+        int iterations = 10;
+        std::string output_path;
+        std::string compare_path;
+    };
+
+    auto parse_options(int const argument_count, char const* const arguments[]) -> std::optional<options> {
+
+        options result;
+        auto number = 0;
+
+        for (auto i = 1; i < argument_count; ++i) {
+
+            auto argument = std::string_view { arguments[i] };
+
+            if (argument.substr(0, 10) == "--backend=") result.backend = argument.substr(10);
+            else if (utility::parse_number_argument(argument, "--threads=", number)) result.threads = static_cast<std::size_t>(number);
+            else if (utility::parse_number_argument(argument, "--iterations=", number)) result.iterations = number;
+            else if (argument.substr(0, 9) == "--output=") result.output_path = argument.substr(9);
+            else if (argument.substr(0, 10) == "--compare=") result.compare_path = argument.substr(10);
+            else if (argument.substr(0, 2) != "--" && result.capture_path.empty()) result.capture_path = argument;
+            else return std::nullopt;
+
+        }
+
+        if (result.capture_path.empty() || (result.backend != "software" && result.backend != "tiled")) return std::nullopt;
+        return result;
+
+    }
+
+    // Uncompressed 32 bit top-down BMP, the pixels go out premultiplied as they are.
+    auto write_bitmap(std::string const& path, graphics::bitmap const& image) -> void {
+
+        auto write_u16 = [](std::vector<std::uint8_t>& bytes, std::uint16_t value) { bytes.push_back(value & 0xff); bytes.push_back(value >> 8); };
+        auto write_u32 = [&write_u16](std::vector<std::uint8_t>& bytes, std::uint32_t value) { write_u16(bytes, value & 0xffff); write_u16(bytes, value >> 16); };
+
+        auto pixel_bytes = static_cast<std::uint32_t>(image.byte_size());
+
+        std::vector<std::uint8_t> header;
+        header.push_back('B'); header.push_back('M');
+        write_u32(header, 54 + pixel_bytes);
+        write_u32(header, 0);
+        write_u32(header, 54);
+
+        write_u32(header, 40);
+        write_u32(header, image.width);
+        write_u32(header, static_cast<std::uint32_t>(-static_cast<std::int32_t>(image.height)));
+        write_u16(header, 1);
+        write_u16(header, 32);
+        for (auto i = 0; i < 6; ++i) write_u32(header, 0);
+
+        std::ofstream output { path, std::ios::binary };
+        output.write(reinterpret_cast<char const*>(header.data()), static_cast<std::streamsize>(header.size()));
+        output.write(reinterpret_cast<char const*>(image.pixels.data()), static_cast<std::streamsize>(pixel_bytes));
+
+        if (!output) throw std::runtime_error { "Failed to write " + path + "." };
+
+    }
+
+    // Only reads back what write_bitmap writes.
+    auto read_bitmap(std::string const& path) -> graphics::bitmap {
+
+        std::ifstream input { path, std::ios::binary };
+        std::uint8_t header[54];
+        if (!input.read(reinterpret_cast<char*>(header), sizeof(header))) throw std::runtime_error { "Failed to read " + path + "." };
+
+        auto read_u32 = [&header](std::size_t offset) {
+            std::uint32_t value;
+            std::memcpy(&value, header + offset, sizeof(value));
+            return value;
+        };
+
+        auto width = read_u32(18);
+        auto height = -static_cast<std::int32_t>(read_u32(22));
+        auto bits = static_cast<std::uint16_t>(header[28] | header[29] << 8);
+
+        if (header[0] != 'B' || header[1] != 'M' || bits != 32 || read_u32(30) != 0 || height < 0 || width > 1u << 16 || height > 1 << 16)
+            throw std::runtime_error { path + " isn't a top-down 32 bit bitmap." };
+
+        graphics::bitmap image { width, static_cast<std::uint32_t>(height) };
+        input.seekg(read_u32(10));
+        if (!input.read(reinterpret_cast<char*>(image.pixels.data()), static_cast<std::streamsize>(image.byte_size())))
+            throw std::runtime_error { path + " is truncated." };
+
+        return image;
+
+    }
+
+    // Everything visible in a single list, each layer translated to its rounded pixel offset. Layer clips
+    // aren't applied, so content overflowing a layer shows where the compositor would cut it off.
+    auto flatten_layers(graphics::layer_tree const& layers, float const dpi) {
+
+        auto scale = dpi / 96.0f;
+        graphics::command_list commands;
+
+        for (auto id : layers.get_draw_order()) {
+
+            auto bounds = layers.get_absolute_bounds(id);
+            commands.push_transform(graphics::transform::translation(
+                std::round(bounds.origin.x * scale) / scale, std::round(bounds.origin.y * scale) / scale
+            ));
+
+            layers.get(id).commands->replay(commands);
+            commands.pop_transform();
+
+        }
+
+        return commands;
+
+    }
+
+    auto replay(options const& replay_options) -> int {
+
+        std::ifstream input { replay_options.capture_path, std::ios::binary };
+        if (!input) throw std::runtime_error { "Failed to open " + replay_options.capture_path + "." };
+
+        auto capture = graphics::read_frame_capture(input);
+        auto [width, height] = capture.surface_size;
+
+        // Opaque mid grey, images that weren't resident when the frame was captured stay skipped.
+        std::unordered_map<resource::image const*, graphics::bitmap> placeholders;
+        for (auto& [image, size] : capture.images) {
+            if (size.width == 0 || size.height == 0) continue;
+            auto& pixels = placeholders.try_emplace(&image, size.width, size.height).first->second;
+            std::fill(pixels.pixels.begin(), pixels.pixels.end(), 0xff808080u);
+        }
+
+        auto provider = [&placeholders](resource::image const& image) -> graphics::bitmap const* {
+            auto lookup_iterator = placeholders.find(&image);
+            return lookup_iterator != placeholders.end() ? &lookup_iterator->second : nullptr;
+        };
+
+        std::printf(
+            "%s: %ux%u at %.0f dpi, %zu layers, %zu images, %s backend with %s kernels\n",
+            replay_options.capture_path.c_str(), width, height, capture.dpi, capture.layers.get_draw_order().size(),
+            capture.images.size(), replay_options.backend.c_str(),
+            graphics::kernels::get_instruction_set_name(graphics::kernels::get_kernels().set)
+        );
+
+        // The tree comes back with everything pending, so every iteration redraws the whole frame.
+        std::unique_ptr<graphics::software_compositor> compositor;
+        std::unique_ptr<utility::work_stealing_pool> pool;
+        std::unique_ptr<graphics::tiled_renderer> tiled;
+        graphics::command_list flattened;
+
+        if (replay_options.backend == "software") {
+            compositor = std::make_unique<graphics::software_compositor>(width, height, capture.dpi);
+            compositor->set_image_provider(provider);
+        }
+        else {
+            pool = std::make_unique<utility::work_stealing_pool>(replay_options.threads);
+            tiled = std::make_unique<graphics::tiled_renderer>(width, height, *pool, capture.dpi);
+            tiled->set_image_provider(provider);
+            flattened = flatten_layers(capture.layers, capture.dpi);
+        }
+
+        std::vector<double> timings;
+        for (auto i = 0; i < replay_options.iterations; ++i) {
+
+            auto start = std::chrono::steady_clock::now();
+            if (compositor) compositor->render_layers(capture.layers);
+            else tiled->render(flattened);
+            timings.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+        }
+
+        std::sort(timings.begin(), timings.end());
+        std::printf("%d iterations, median %.3f ms, min %.3f ms\n", replay_options.iterations, timings[timings.size() / 2], timings.front());
+
+        auto& frame = compositor ? compositor->get_target() : tiled->get_target();
+        if (!replay_options.output_path.empty()) write_bitmap(replay_options.output_path, frame);
+        if (replay_options.compare_path.empty()) return 0;
+
+        auto reference = read_bitmap(replay_options.compare_path);
+        if (reference.width != frame.width || reference.height != frame.height) {
+            std::printf("size mismatch, %ux%u against %ux%u\n", frame.width, frame.height, reference.width, reference.height);
+            return 1;
+        }
+
+        // Largest difference of any channel, so rounding noise can be told apart from a real change.
+        std::size_t differing = 0;
+        std::uint32_t maximum_difference = 0;
+
+        for (std::size_t i = 0; i < frame.pixels.size(); ++i) {
+
+            auto lhs = frame.pixels[i], rhs = reference.pixels[i];
+            if (lhs == rhs) continue;
+
+            ++differing;
+            for (auto shift = 0; shift < 32; shift += 8) {
+                auto a = static_cast<std::int32_t>((lhs >> shift) & 0xff), b = static_cast<std::int32_t>((rhs >> shift) & 0xff);
+                maximum_difference = std::max(maximum_difference, static_cast<std::uint32_t>(std::abs(a - b)));
+            }
+
+        }
+
+        std::printf("%zu of %zu pixels differ, by up to %u\n", differing, frame.pixels.size(), maximum_difference);
+        return differing == 0 ? 0 : 1;
+
+    }
+
+}
+
+auto main(int argument_count, char* arguments[]) -> int {
+
+    auto options = parse_options(argument_count, arguments);
+    if (!options) {
+        std::fprintf(
+            stderr, "usage: %s <capture> [--backend=software|tiled] [--threads=n] [--iterations=n] [--output=frame.bmp] [--compare=frame.bmp]\n",
+            arguments[0]
+        );
+        return 2;
+    }
+
+    try {
+        return replay(*options);
+    }
+    catch (std::exception const& error) {
+        std::fprintf(stderr, "%s\n", error.what());
+        return 2;
+    }
+
+}
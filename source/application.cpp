@@ -1,30 +1,299 @@
+#include <algorithm>
 #include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+#include <dwmapi.h>
 
 #include <application.hpp>
 
 namespace chrome {
 
-    application::application(char**, int) {
+    namespace {
+        // Posted to the message window by decoder threads, the render thread uploads what's ready.
+        constexpr auto image_ready_message = WM_APP + 1;
+        // Posted to the message window by the render thread, repaints every window with the uploaded images.
+        constexpr auto images_uploaded_message = WM_APP + 2;
+    }
+
+    application::application(char** args, int argument_count) {
+
+        WNDCLASSEXW message_class { sizeof(WNDCLASSEXW) };
+        message_class.lpfnWndProc = process_message;
+        message_class.hInstance = GetModuleHandleW(nullptr);
+        message_class.lpszClassName = L"ChromeApplicationMessages";
+
+        RegisterClassExW(&message_class);
+
+        _message_window = CreateWindowExW(
+            0, message_class.lpszClassName, nullptr, 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, message_class.hInstance, this
+        );
+
+        if (_message_window == nullptr) throw std::runtime_error { "Failed to create the message window." };
+
+        // Nothing about the windows needs the devices until the first paint, so they're created
+        // on a worker in the meantime.
+        auto pending_render_device = std::async(std::launch::async, [this] {
+            auto phase = _startup_timeline.measure("render device");
+            return std::make_unique<graphics::render_device>(&_startup_timeline);
+        });
+
+        {
+
+            auto phase = _startup_timeline.measure("refresh rate");
+
+            // Pace frames to the compositor, which runs at the refresh rate of the primary display.
+            DWM_TIMING_INFO timing_info { sizeof(DWM_TIMING_INFO) };
+            if (SUCCEEDED(DwmGetCompositionTimingInfo(nullptr, &timing_info)) && timing_info.rateRefresh.uiNumerator != 0) {
+                auto refresh_interval = std::chrono::duration<double>(
+                    static_cast<double>(timing_info.rateRefresh.uiDenominator) / timing_info.rateRefresh.uiNumerator
+                );
+                _refresh_interval = std::chrono::duration_cast<gui::frame_scheduler::duration>(refresh_interval);
+            }
+
+        }
+
+        // --windows=N opens that many windows, cascaded. --profile=<path> records a trace of every frame
+        // into that file, in builds with the profiler compiled in. --capture=<directory> writes every frame
+        // of every window into that directory, to be replayed headless with chrome_replay.
+        auto window_count = 1;
+        auto profile_path = std::string_view {};
+        for (auto i = 1; i < argument_count; ++i) {
+
+            auto argument = std::string_view { args[i] };
+            auto windows_prefix = std::string_view { "--windows=" };
+            auto profile_prefix = std::string_view { "--profile=" };
+            auto capture_prefix = std::string_view { "--capture=" };
+
+            if (argument.substr(0, windows_prefix.size()) == windows_prefix)
+                std::from_chars(argument.data() + windows_prefix.size(), argument.data() + argument.size(), window_count);
+            else if (argument.substr(0, profile_prefix.size()) == profile_prefix)
+                profile_path = argument.substr(profile_prefix.size());
+            else if (argument.substr(0, capture_prefix.size()) == capture_prefix)
+                _capture_directory = argument.substr(capture_prefix.size());
+
+        }
+
+        // Recording is on by default so the benchmarks can use it, the application only pays for it when asked.
+        utility::profiler::set_enabled(!profile_path.empty());
+#if defined(CHROME_ENABLE_PROFILER)
+        _profile_path = profile_path;
+#endif
+
+        {
+            auto phase = _startup_timeline.measure("windows");
+            for (auto i = 0; i < std::max(window_count, 1); ++i) {
+                auto offset = 30.0f * static_cast<float>(i);
+                open_window("Chrome management", { 100.0f + offset, 100.0f + offset, 1280.f, 720.f });
+            }
+        }
+
+        {
+            auto phase = _startup_timeline.measure("waiting for render device");
+            _render_device = pending_render_device.get();
+        }
+
+        _render_thread = std::make_unique<gui::render_thread>([this] { render(); });
 
-        auto frame = measure::rectangle { 100.0f, 100.0f, 1280.f, 720.f };
-        _window = std::make_unique<gui::window>("Chrome management", frame);
-        _window->show_window(); 
+        _render_device->set_image_ready_callback([message_window = _message_window] {
+            PostMessageW(message_window, image_ready_message, 0, 0);
+        });
+
+        {
+            auto phase = _startup_timeline.measure("renderers");
+            for (auto& entry : _windows) entry.window->attach_renderer(*_render_device, *_render_thread);
+        }
+
+        for (auto& entry : _windows) entry.window->show_window();
+        _startup_timeline.mark("windows shown");
         
     }
 
+    application::~application() {
+        write_profile();
+        DestroyWindow(_message_window);
+    }
+
+    auto CALLBACK application::process_message(HWND window_handle, UINT message, WPARAM wparam, LPARAM lparam) -> LRESULT {
+
+        auto owner = reinterpret_cast<application*>(GetWindowLongPtrW(window_handle, GWLP_USERDATA));
+
+        if (message == WM_CREATE) {
+            auto create_struct = reinterpret_cast<CREATESTRUCT*>(lparam);
+            SetWindowLongPtrW(window_handle, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(create_struct->lpCreateParams));
+        }
+        else if (message == image_ready_message) {
+            owner->_render_thread->wake();
+            return 0;
+        }
+        else if (message == images_uploaded_message) {
+            owner->request_frames();
+            return 0;
+        }
+
+        return DefWindowProcW(window_handle, message, wparam, lparam);
+
+    }
+
+    auto application::open_window(std::string title, measure::rectangle<float> const& frame) -> gui::window& {
+
+        auto scheduler = std::make_unique<gui::frame_scheduler>();
+        scheduler->set_refresh_interval(_refresh_interval);
+        auto opened = std::make_unique<gui::window>(std::move(title), frame, *scheduler);
+        auto& opened_window = *opened;
+
+        if (!_capture_directory.empty()) opened_window.capture_frames(_capture_directory, "window" + std::to_string(_windows.size()));
+
+        // Windows opened during startup get their renderer once the device is up.
+        if (!_render_device) {
+            _windows.push_back({ std::move(scheduler), std::move(opened) });
+            return opened_window;
+        }
+
+        opened_window.attach_renderer(*_render_device, *_render_thread);
+
+        auto device_lock = _render_device->lock();
+        _windows.push_back({ std::move(scheduler), std::move(opened) });
+
+        return opened_window;
+
+    }
+
+    auto application::request_frames() -> void {
+        for (auto& entry : _windows) entry.frame_scheduler->request_frame();
+    }
+
+    auto application::render() -> void {
+
+        // Draw calls and uploads are counted on this thread, so its frames are the ones that flush them.
+        CHROME_PROFILE_FRAME("render");
+
+        auto upload_generation = _render_device->get_upload_generation();
+        auto has_rendered = false;
+
+        {
+
+            auto device_lock = _render_device->lock();
+            _render_device->upload_pending_images();
+
+            for (auto& entry : _windows) has_rendered = entry.window->render() || has_rendered;
+
+            // Every window's frame goes out with one commit.
+            if (has_rendered) _render_device->commit();
+
+        }
+
+        // Waiting on the compositor keeps the thread from running ahead of it. The queues fill up meanwhile and push
+        // back on the UI thread, which can still open and drop windows since the device isn't locked.
+        if (has_rendered) _render_device->wait_for_commit_completion();
+
+        if (upload_generation != _render_device->get_upload_generation())
+            PostMessageW(_message_window, images_uploaded_message, 0, 0);
+
+    }
+
+    auto application::report_startup() -> void {
+
+        std::optional<std::chrono::steady_clock::time_point> first_frame_time;
+        for (auto& entry : _windows) {
+            auto time = entry.window->get_first_frame_time();
+            if (time && (!first_frame_time || *time < *first_frame_time)) first_frame_time = time;
+        }
+
+        if (!first_frame_time) return;
+
+        // Time to first frame is the number to watch, the phases say where it went.
+        _startup_timeline.mark("first frame", *first_frame_time);
+        _is_startup_reported = true;
+
+        auto report = "Startup timeline:\n" + _startup_timeline.report();
+        OutputDebugStringA(report.c_str());
+
+    }
+
+    auto application::write_profile() -> void {
+
+#if defined(CHROME_ENABLE_PROFILER)
+        if (_profile_path.empty()) return;
+
+        _profiler.collect();
+
+        std::ofstream output { _profile_path, std::ios::binary };
+        _profiler.export_chrome_trace(output);
+
+        auto& frame_times = _profiler.get_frame_times();
+        auto to_milliseconds = [](std::int64_t const nanoseconds) { return static_cast<double>(nanoseconds) / 1'000'000.0; };
+
+        char summary[256];
+        std::snprintf(summary, sizeof(summary), "Profile: %llu frames, p50 %.2fms, p99 %.2fms, max %.2fms, %llu events dropped\n",
+            static_cast<unsigned long long>(frame_times.get_count()),
+            to_milliseconds(frame_times.get_percentile(0.5)),
+            to_milliseconds(frame_times.get_percentile(0.99)),
+            to_milliseconds(frame_times.get_maximum()),
+            static_cast<unsigned long long>(_profiler.get_dropped())
+        );
+
+        OutputDebugStringA(summary);
+#endif
+
+    }
+
     auto application::execute() -> int {
 
         MSG message_structure {};
 
-        while (message_structure.message != WM_QUIT)
-        if (PeekMessageW(&message_structure, nullptr, 0, 0, PM_REMOVE)) {
-            TranslateMessage(&message_structure);
-            DispatchMessageW(&message_structure);
-        }
+        while (true) {
+
+            // Sleep until input arrives or a scheduler wants a frame, idle windows cost nothing.
+            std::optional<gui::frame_scheduler::duration> timeout;
+            for (auto& entry : _windows) {
+                auto window_timeout = entry.frame_scheduler->get_wait_timeout();
+                if (window_timeout && (!timeout || *window_timeout < *timeout)) timeout = window_timeout;
+            }
+
+            auto timeout_milliseconds = timeout
+                ? static_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(*timeout).count())
+                : INFINITE;
 
-        return static_cast<int>(message_structure.wParam);
+            MsgWaitForMultipleObjectsEx(0, nullptr, timeout_milliseconds, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+
+            while (PeekMessageW(&message_structure, nullptr, 0, 0, PM_REMOVE)) {
+
+                if (message_structure.message == WM_QUIT) return static_cast<int>(message_structure.wParam);
+
+                TranslateMessage(&message_structure);
+                DispatchMessageW(&message_structure);
+
+            }
+
+            // A render in progress may still be drawing a closed window.
+            if (std::any_of(_windows.begin(), _windows.end(), [](window_entry const& entry) { return entry.window->is_closed(); })) {
+                auto device_lock = _render_device->lock();
+                std::erase_if(_windows, [](window_entry const& entry) { return entry.window->is_closed(); });
+            }
+
+            if (_windows.empty()) return 0;
+
+            for (auto& entry : _windows) {
+                if (entry.frame_scheduler->begin_frame()) entry.window->update();
+            }
+
+            if (!_is_startup_reported) report_startup();
+            _render_thread->rethrow_failure();
+
+#if defined(CHROME_ENABLE_PROFILER)
+            if (!_profile_path.empty()) _profiler.collect();
+#endif
+
+        }
 
     }
 
-}
\ No newline at end of file
+}
@@ -3,9 +3,16 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <vector>
 
+#include <utility/startup_timeline.hpp>
+#include <utility/profiler.hpp>
+#include <graphics/render_device.hpp>
 #include <gui/window.hpp>
+#include <gui/frame_scheduler.hpp>
+#include <gui/render_thread.hpp>
 
 namespace chrome {
 
@@ -19,13 +26,56 @@ namespace chrome {
         application& operator=(application const&)  = delete;
         application& operator=(application&&)       = delete;
 
-        ~application() = default;
+        ~application();
 
         auto execute() -> int;
 
+        // Every window draws with the shared device, so another one only costs its own surfaces.
+        auto open_window(std::string title, measure::rectangle<float> const& frame) -> gui::window&;
+
+        // Phases of startup and the milestones up to the first frame, also sent to the debugger output once complete.
+        auto& get_startup_timeline() const { return _startup_timeline; }
+
     private:
 
-        std::unique_ptr<gui::window> _window;
+        // Each window paces its own frames, a minimized one doesn't hold the others back.
+        struct window_entry {
+            std::unique_ptr<gui::frame_scheduler> frame_scheduler;
+            std::unique_ptr<gui::window> window;
+        };
+
+        // Handles what the device and the render thread post to the message window.
+        static auto CALLBACK process_message(HWND window_handle, UINT message, WPARAM wparam, LPARAM lparam) -> LRESULT;
+
+        auto request_frames() -> void;
+        auto report_startup() -> void;
+
+        // Render thread. Uploads decoded images, renders every window's latest frame and commits them together.
+        auto render() -> void;
+        auto write_profile() -> void;
+
+        // Starts counting as the application is constructed.
+        utility::startup_timeline _startup_timeline;
+        bool _is_startup_reported = false;
+
+        // Declared before the windows, so it outlives them.
+        std::unique_ptr<graphics::render_device> _render_device;
+        gui::frame_scheduler::duration _refresh_interval = gui::frame_scheduler::default_refresh_interval();
+
+        // Changed with the device locked, the render thread walks it.
+        std::vector<window_entry> _windows;
+        std::string _capture_directory; // Empty unless capturing frames.
+        // Message-only, unlike thread messages its posts are still dispatched while a modal loop runs a drag or a menu.
+        HWND _message_window = nullptr;
+
+        // After the windows, so it stops before they go away.
+        std::unique_ptr<gui::render_thread> _render_thread;
+
+#if defined(CHROME_ENABLE_PROFILER)
+        // Drained once per loop iteration, written out as a Chrome trace on exit.
+        utility::profiler::collector _profiler;
+        std::string _profile_path;
+#endif
 
     };
 
@@ -13,8 +13,9 @@ auto main(int argument_count, char* arguments[]) -> int try {
 
 catch (std::exception const& exception) {
 
-    auto what = utility::convert_utf8_to_utf16(exception.what());
-    MessageBoxW(nullptr, what.c_str(), L"Fatal error!", MB_ICONERROR | MB_OK);
+    // Converted on the stack, the error might well be that the heap ran out.
+    utility::utf16_buffer<512> what { exception.what() };
+    MessageBoxW(nullptr, utility::as_wide(what), L"Fatal error!", MB_ICONERROR | MB_OK);
     
     return -1;
 
@@ -0,0 +1,29 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace chrome::graphics {
+
+    // CPU side pixel storage, premultiplied BGRA packed as 0xAARRGGBB, rows are tightly packed.
+    struct bitmap {
+
+        bitmap() = default;
+        bitmap(std::uint32_t const width, std::uint32_t const height)
+        : width(width), height(height), pixels(static_cast<std::size_t>(width) * height, 0u) {}
+
+        auto row(std::uint32_t const y) { return pixels.data() + static_cast<std::size_t>(y) * width; }
+        auto row(std::uint32_t const y) const { return pixels.data() + static_cast<std::size_t>(y) * width; }
+
+        auto byte_size() const { return pixels.size() * sizeof(std::uint32_t); }
+
+        std::uint32_t width = 0, height = 0;
+        std::vector<std::uint32_t> pixels;
+
+    };
+
+}
@@ -0,0 +1,57 @@
+#include <graphics/command_list.hpp>
+
+namespace chrome::graphics {
+
+    auto command_list::fill_rectangle(measure::rectangle<float> const& fill_area, measure::color const& fill_color) -> void {
+        record(command_type::fill_rectangle, command::fill_rectangle { fill_area, fill_color });
+    }
+
+    auto command_list::draw_line(
+        measure::point<float> const& start_point, measure::point<float> const& end_point,
+        float const stroke_width, measure::color const& stroke_color
+    ) -> void {
+        record(command_type::draw_line, command::draw_line { start_point, end_point, stroke_width, stroke_color });
+    }
+
+    auto command_list::draw_image(resource::image const* image, float scale, measure::point<float> const& top_left, float const opacity) -> void {
+        record(command_type::draw_image, command::draw_image { image, scale, top_left, opacity });
+    }
+
+    auto command_list::draw_text(
+        std::string_view text, measure::point<float> const& top_left, std::string_view font_family,
+        float const font_size, measure::color const& text_color, font_weight const weight
+    ) -> void {
+
+        // The family is interned rather than stored, it's the same few names over and over.
+        record(command_type::draw_text, command::draw_text {
+            store_string(text), intern_font_family(font_family), top_left, font_size, text_color, weight
+        });
+
+    }
+
+    auto command_list::push_transform(transform const& transform) -> void {
+        record(command_type::push_transform, command::push_transform { transform });
+    }
+
+    auto command_list::pop_transform() -> void {
+        record(command_type::pop_transform, command::pop_transform {});
+    }
+
+    auto command_list::clear() -> void {
+
+        _commands.clear();
+        _strings.clear();
+        _command_count = 0;
+
+    }
+
+    auto command_list::store_string(std::string_view string) -> string_reference {
+
+        auto offset = static_cast<std::uint32_t>(_strings.size());
+        _strings.insert(_strings.end(), string.begin(), string.end());
+
+        return { offset, static_cast<std::uint32_t>(string.size()) };
+
+    }
+
+}
@@ -0,0 +1,220 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <utility/measure.hpp>
+#include <graphics/image.hpp>
+#include <graphics/font.hpp>
+#include <graphics/transform.hpp>
+
+// Retained list of renderer calls. Recording does not touch any platform API, so a frame can be
+// built once, replayed onto whichever backend is around, and reused as long as the scene is unchanged.
+// Every command is a trivially copyable struct stored back to back in a single byte buffer,
+// strings live in a separate pool and are referenced by offset. Font families are interned process wide.
+
+namespace chrome::graphics {
+
+    enum struct command_type : std::uint8_t {
+        fill_rectangle,
+        draw_line,
+        draw_image,
+        draw_text,
+        push_transform,
+        pop_transform
+    };
+
+    struct string_reference {
+        std::uint32_t offset, length;
+    };
+
+    namespace command {
+
+        struct fill_rectangle {
+            measure::rectangle<float> area;
+            measure::color color;
+        };
+
+        struct draw_line {
+            measure::point<float> start, end;
+            float stroke_width;
+            measure::color color;
+        };
+
+        struct draw_image {
+            resource::image const* image;
+            float scale;
+            measure::point<float> top_left;
+            float opacity;
+        };
+
+        struct draw_text {
+            string_reference text;
+            font_id font_family;
+            measure::point<float> top_left;
+            float font_size;
+            measure::color color;
+            font_weight weight;
+        };
+
+        struct push_transform {
+            graphics::transform transform;
+        };
+
+        struct pop_transform {};
+
+    }
+
+    struct command_list {
+
+        command_list() = default;
+
+        command_list(command_list const&) = default;
+        command_list(command_list&&) = default;
+        command_list& operator=(command_list const&) = default;
+        command_list& operator=(command_list&&) = default;
+
+        ~command_list() = default;
+
+        auto fill_rectangle(
+            measure::rectangle<float> const& fill_area,
+            measure::color const& fill_color
+        ) -> void;
+
+        auto draw_line(
+            measure::point<float> const& start, measure::point<float> const& end,
+            float const stroke_width, measure::color const& stroke_color
+        ) -> void;
+
+        auto draw_image(
+            resource::image const* image, float scale,
+            measure::point<float> const& top_left, float const opacity
+        ) -> void;
+
+        auto draw_text(
+            std::string_view text, measure::point<float> const& top_left, std::string_view font_family,
+            float const font_size, measure::color const& text_color,
+            font_weight const weight = font_weight::normal
+        ) -> void;
+
+        auto push_transform(transform const& transform) -> void;
+
+        auto pop_transform() -> void;
+
+        // Drops the recorded commands but keeps the storage around for the next recording.
+        auto clear() -> void;
+
+        auto empty() const { return _command_count == 0; }
+        auto command_count() const { return _command_count; }
+        auto byte_size() const { return _commands.size() + _strings.size(); }
+
+        auto get_string(string_reference const& reference) const {
+            return std::string_view { _strings.data() + reference.offset, reference.length };
+        }
+
+        // Calls visitor(command_type, command::xyz const&) for every recorded command, in order.
+        template <typename Visitor>
+        auto visit(Visitor&& visitor) const -> void;
+
+        // Re-issues the recorded calls on anything exposing the renderer surface.
+        template <typename Target>
+        auto replay(Target& target) const -> void;
+
+    private:
+
+        template <typename Command>
+        auto record(command_type type, Command const& command) -> void;
+
+        auto store_string(std::string_view string) -> string_reference;
+
+        std::vector<std::byte> _commands;
+        std::vector<char> _strings;
+        std::uint32_t _command_count = 0;
+
+    };
+
+    template <typename Command>
+    auto command_list::record(command_type type, Command const& command) -> void {
+
+        static_assert(std::is_trivially_copyable_v<Command>, "Recorded commands have to be trivially copyable.");
+
+        auto position = _commands.size();
+        _commands.resize(position + sizeof(command_type) + sizeof(Command));
+        std::memcpy(_commands.data() + position, &type, sizeof(command_type));
+        std::memcpy(_commands.data() + position + sizeof(command_type), &command, sizeof(Command));
+        ++_command_count;
+
+    }
+
+    template <typename Visitor>
+    auto command_list::visit(Visitor&& visitor) const -> void {
+
+        auto cursor = _commands.data();
+        auto const end = cursor + _commands.size();
+
+        // Payloads are unaligned inside the buffer, so they're copied out before use.
+        auto decode = [&cursor, &visitor](command_type type, auto command) {
+            std::memcpy(&command, cursor, sizeof(command));
+            cursor += sizeof(command);
+            visitor(type, static_cast<decltype(command) const&>(command));
+        };
+
+        while (cursor < end) {
+
+            command_type type;
+            std::memcpy(&type, cursor, sizeof(command_type));
+            cursor += sizeof(command_type);
+
+            switch (type) {
+                case command_type::fill_rectangle:  decode(type, command::fill_rectangle {}); break;
+                case command_type::draw_line:       decode(type, command::draw_line {}); break;
+                case command_type::draw_image:      decode(type, command::draw_image {}); break;
+                case command_type::draw_text:       decode(type, command::draw_text {}); break;
+                case command_type::push_transform:  decode(type, command::push_transform {}); break;
+                case command_type::pop_transform:   decode(type, command::pop_transform {}); break;
+            }
+
+        }
+
+    }
+
+    template <typename Target>
+    auto command_list::replay(Target& target) const -> void {
+
+        visit([this, &target](command_type, auto const& command) {
+
+            using command_t = std::decay_t<decltype(command)>;
+
+            if constexpr (std::is_same_v<command_t, command::fill_rectangle>)
+                target.fill_rectangle(command.area, command.color);
+
+            else if constexpr (std::is_same_v<command_t, command::draw_line>)
+                target.draw_line(command.start, command.end, command.stroke_width, command.color);
+
+            else if constexpr (std::is_same_v<command_t, command::draw_image>)
+                target.draw_image(command.image, command.scale, command.top_left, command.opacity);
+
+            else if constexpr (std::is_same_v<command_t, command::draw_text>)
+                target.draw_text(
+                    get_string(command.text), command.top_left, get_font_family(command.font_family),
+                    command.font_size, command.color, command.weight
+                );
+
+            else if constexpr (std::is_same_v<command_t, command::push_transform>)
+                target.push_transform(command.transform);
+
+            else if constexpr (std::is_same_v<command_t, command::pop_transform>)
+                target.pop_transform();
+
+        });
+
+    }
+
+}
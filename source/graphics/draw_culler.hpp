@@ -0,0 +1,67 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+
+#include <utility/affine.hpp>
+#include <utility/measure.hpp>
+#include <graphics/transform.hpp>
+
+// Rejects draws that can't touch the visible area before they reach the backend. Each renderer
+// picks its own cull space (device pixels for the software one, DIPs for D2D), as long as the
+// cull area and the transforms handed in agree on it.
+
+namespace chrome::graphics {
+
+    struct culling_statistics {
+        std::uint64_t issued = 0, culled = 0;
+    };
+
+    struct draw_culler {
+
+        // Intersection of the viewport and the active clip, in cull space.
+        auto set_cull_area(measure::rectangle<float> const& area) -> void {
+            _cull_area = area;
+        }
+
+        // Bounds are in the primitive's local space and get mapped through to_cull_space.
+        // Counts the draw either way, true means it has to be issued.
+        auto accept(transform const& to_cull_space, measure::rectangle<float> const& local_bounds) -> bool {
+
+            if (measure::transform_bounds(to_cull_space, local_bounds).intersects(_cull_area)) {
+                ++_statistics.issued;
+                return true;
+            }
+
+            ++_statistics.culled;
+            return false;
+
+        }
+
+        auto& get_cull_area() const { return _cull_area; }
+        auto& get_statistics() const { return _statistics; }
+        auto reset_statistics() -> void { _statistics = {}; }
+
+    private:
+
+        measure::rectangle<float> _cull_area {};
+        culling_statistics _statistics;
+
+    };
+
+    // Bounds of a stroked line, stroke included whatever the caps.
+    inline auto get_line_bounds(measure::point<float> const& start, measure::point<float> const& end, float const stroke_width) {
+
+        auto half_width = 0.5f * stroke_width;
+        auto left = start.x < end.x ? start.x : end.x, top = start.y < end.y ? start.y : end.y;
+        auto right = start.x < end.x ? end.x : start.x, bottom = start.y < end.y ? end.y : start.y;
+
+        return measure::rectangle<float> {
+            left - half_width, top - half_width, right - left + stroke_width, bottom - top + stroke_width
+        };
+
+    }
+
+}
@@ -0,0 +1,59 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include <utility/string_interner.hpp>
+
+namespace chrome::graphics {
+
+    // Mirrors DWRITE_FONT_WEIGHT values so the renderer can cast straight through.
+    enum struct font_weight : std::uint16_t {
+        thin        = 100,
+        extra_light = 200,
+        light       = 300,
+        normal      = 400,
+        medium      = 500,
+        semi_bold   = 600,
+        bold        = 700,
+        extra_bold  = 800,
+        black       = 900
+    };
+
+    // Mirrors DWRITE_FONT_STYLE.
+    enum struct font_style : std::uint8_t {
+        normal  = 0,
+        oblique = 1,
+        italic  = 2
+    };
+
+    // Horizontal advances of one font at one weight, in ems, enough to measure a label without laying it out.
+    // Kerning and shaping aren't part of it, which is fine for deciding where a label gets cut off.
+    struct font_advances {
+        std::array<float, 128> ascii {};
+        float fallback = 0.5f;  // Anything past ASCII.
+        float ellipsis = 0.5f;  // U+2026.
+    };
+
+    // A handful of family names repeat on every text draw, recorded commands carry one of these instead.
+    // Ids are shared by every command list and thread of the process, but only mean something within it.
+    using font_id = utility::string_id;
+
+    inline auto get_font_families() -> utility::string_interner& {
+        static utility::string_interner font_families;
+        return font_families;
+    }
+
+    inline auto intern_font_family(std::string_view const font_family) -> font_id {
+        return get_font_families().intern(font_family);
+    }
+
+    inline auto get_font_family(font_id const id) -> std::string_view {
+        return get_font_families().get(id);
+    }
+
+}
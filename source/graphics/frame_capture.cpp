@@ -0,0 +1,335 @@
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <graphics/frame_capture.hpp>
+
+namespace chrome::graphics {
+
+    namespace {
+
+        constexpr auto capture_magic = std::uint32_t { 0x43464843u }; // "CHFC"
+        constexpr auto capture_version = std::uint32_t { 1 };
+
+        // Nothing in a frame comes close, anything longer or larger is a corrupt file. Sizes are capped at
+        // the largest D3D11 texture, replay allocates bitmaps straight from them.
+        constexpr auto maximum_string_length = std::uint32_t { 1u << 24 };
+        constexpr auto maximum_extent = std::uint32_t { 16384 };
+
+        constexpr auto is_static_flag = std::uint8_t { 1u << 0 };
+        constexpr auto is_visible_flag = std::uint8_t { 1u << 1 };
+
+        // Values go out as their in-memory bytes, little endian on everything this builds for.
+        struct capture_writer {
+
+            std::ostream& output;
+
+            template <typename Value>
+            auto write(Value const& value) -> void {
+                static_assert(std::is_trivially_copyable_v<Value>, "Only plain values are written as they are.");
+                output.write(reinterpret_cast<char const*>(&value), sizeof(Value));
+            }
+
+            auto write_string(std::string_view string) -> void {
+                write(static_cast<std::uint32_t>(string.size()));
+                output.write(string.data(), static_cast<std::streamsize>(string.size()));
+            }
+
+        };
+
+        struct capture_reader {
+
+            std::istream& input;
+
+            template <typename Value>
+            auto read() -> Value {
+
+                Value value;
+                if (!input.read(reinterpret_cast<char*>(&value), sizeof(Value))) throw std::runtime_error { "The frame capture is truncated." };
+
+                return value;
+
+            }
+
+            auto read_string() -> std::string {
+
+                auto length = read<std::uint32_t>();
+                if (length > maximum_string_length) throw std::runtime_error { "The frame capture has a corrupt string." };
+
+                std::string string(length, '\0');
+                if (!input.read(string.data(), static_cast<std::streamsize>(length))) throw std::runtime_error { "The frame capture is truncated." };
+
+                return string;
+
+            }
+
+            auto read_size() -> measure::size<std::uint32_t> {
+
+                auto size = read<measure::size<std::uint32_t>>();
+                if (size.width > maximum_extent || size.height > maximum_extent) throw std::runtime_error { "The frame capture has a corrupt size." };
+
+                return size;
+
+            }
+
+        };
+
+        // Every layer, invisible ones included, parents before their children and siblings back to front.
+        // Added back in this order, siblings sharing a z index keep their order.
+        auto get_capture_order(layer_tree const& layers) {
+
+            std::vector<layer_id> order;
+            std::vector<layer_id> pending;
+
+            auto push_children = [&](layer_id const id) {
+                auto& children = layers.get(id).children;
+                for (auto i = children.size(); i-- > 0;) pending.push_back(children[i]);
+            };
+
+            push_children(layer_tree::root);
+
+            while (!pending.empty()) {
+                auto id = pending.back();
+                pending.pop_back();
+                order.push_back(id);
+                push_children(id);
+            }
+
+            return order;
+
+        }
+
+    }
+
+    auto write_frame_capture(
+        std::ostream& output, layer_tree const& layers, measure::size<std::uint32_t> const& surface_size,
+        float const dpi, image_size_provider const& get_image_size
+    ) -> void {
+
+        auto order = get_capture_order(layers);
+
+        // Images and font families are written once up front and referenced by index.
+        std::unordered_map<resource::image const*, std::uint32_t> image_indices;
+        std::vector<resource::image const*> images;
+        std::unordered_map<font_id, std::uint32_t> font_indices;
+        std::vector<font_id> fonts;
+
+        for (auto id : order) {
+
+            auto& commands = *layers.get(id).commands;
+            commands.visit([&](command_type, auto const& command) {
+
+                using command_t = std::decay_t<decltype(command)>;
+
+                if constexpr (std::is_same_v<command_t, command::draw_image>) {
+                    if (image_indices.try_emplace(command.image, static_cast<std::uint32_t>(images.size())).second) images.push_back(command.image);
+                }
+
+                else if constexpr (std::is_same_v<command_t, command::draw_text>) {
+                    if (font_indices.try_emplace(command.font_family, static_cast<std::uint32_t>(fonts.size())).second) fonts.push_back(command.font_family);
+                }
+
+            });
+
+        }
+
+        capture_writer writer { output };
+
+        writer.write(capture_magic);
+        writer.write(capture_version);
+        writer.write(surface_size);
+        writer.write(dpi);
+
+        writer.write(static_cast<std::uint32_t>(images.size()));
+        for (auto image : images) {
+            writer.write_string(image->get_file_path());
+            writer.write(get_image_size(*image).value_or(measure::size<std::uint32_t> { 0, 0 }));
+        }
+
+        writer.write(static_cast<std::uint32_t>(fonts.size()));
+        // By name, ids are only meaningful to the process that interned them.
+        for (auto font_family : fonts) writer.write_string(get_font_family(font_family));
+
+        // Parents are referenced by their position in the file plus one, zero is the root.
+        std::unordered_map<layer_id, std::uint32_t> positions;
+        writer.write(static_cast<std::uint32_t>(order.size()));
+
+        for (auto id : order) {
+
+            auto& layer = layers.get(id);
+            positions[id] = static_cast<std::uint32_t>(positions.size() + 1);
+
+            writer.write(layer.parent == layer_tree::root ? 0u : positions.at(layer.parent));
+            writer.write_string(layer.name);
+            writer.write(layer.bounds);
+            writer.write(layer.z_index);
+            writer.write(static_cast<std::uint8_t>((layer.is_static ? is_static_flag : 0) | (layer.is_visible ? is_visible_flag : 0)));
+            writer.write(layer.content_size);
+
+            auto& commands = *layer.commands;
+            writer.write(commands.command_count());
+
+            commands.visit([&](command_type type, auto const& command) {
+
+                using command_t = std::decay_t<decltype(command)>;
+                writer.write(type);
+
+                if constexpr (std::is_same_v<command_t, command::fill_rectangle>) {
+                    writer.write(command.area);
+                    writer.write(command.color);
+                }
+
+                else if constexpr (std::is_same_v<command_t, command::draw_line>) {
+                    writer.write(command.start);
+                    writer.write(command.end);
+                    writer.write(command.stroke_width);
+                    writer.write(command.color);
+                }
+
+                else if constexpr (std::is_same_v<command_t, command::draw_image>) {
+                    writer.write(image_indices.at(command.image));
+                    writer.write(command.scale);
+                    writer.write(command.top_left);
+                    writer.write(command.opacity);
+                }
+
+                else if constexpr (std::is_same_v<command_t, command::draw_text>) {
+                    writer.write_string(commands.get_string(command.text));
+                    writer.write(font_indices.at(command.font_family));
+                    writer.write(command.top_left);
+                    writer.write(command.font_size);
+                    writer.write(command.color);
+                    writer.write(command.weight);
+                }
+
+                else if constexpr (std::is_same_v<command_t, command::push_transform>)
+                    writer.write(command.transform);
+
+            });
+
+        }
+
+        if (!output) throw std::runtime_error { "Failed to write the frame capture." };
+
+    }
+
+    auto read_frame_capture(std::istream& input) -> frame_capture {
+
+        capture_reader reader { input };
+
+        if (reader.read<std::uint32_t>() != capture_magic) throw std::runtime_error { "Not a frame capture." };
+        if (reader.read<std::uint32_t>() != capture_version) throw std::runtime_error { "Unsupported frame capture version." };
+
+        frame_capture capture;
+        capture.surface_size = reader.read_size();
+        capture.dpi = reader.read<float>();
+
+        auto image_count = reader.read<std::uint32_t>();
+        for (std::uint32_t i = 0; i < image_count; ++i) {
+            auto file_path = reader.read_string();
+            capture.images.push_back({ resource::image { std::move(file_path) }, reader.read_size() });
+        }
+
+        // Counts aren't trusted to size anything up front, a corrupt one runs out of bytes first.
+        std::vector<std::string> fonts;
+
+        auto font_count = reader.read<std::uint32_t>();
+        for (std::uint32_t i = 0; i < font_count; ++i) fonts.push_back(reader.read_string());
+
+        auto& layers = capture.layers;
+        std::vector<layer_id> ids;
+
+        auto layer_count = reader.read<std::uint32_t>();
+        for (std::uint32_t i = 0; i < layer_count; ++i) {
+
+            auto parent = reader.read<std::uint32_t>();
+            if (parent > ids.size()) throw std::runtime_error { "The frame capture has a layer before its parent." };
+
+            auto name = reader.read_string();
+            auto bounds = reader.read<measure::rectangle<float>>();
+            auto z_index = reader.read<std::int32_t>();
+            auto flags = reader.read<std::uint8_t>();
+            auto content_size = reader.read<measure::size<float>>();
+
+            auto id = layers.add(std::move(name), parent == 0 ? layer_tree::root : ids[parent - 1], (flags & is_static_flag) != 0);
+            ids.push_back(id);
+
+            layers.set_bounds(id, bounds);
+            layers.set_z_index(id, z_index);
+            layers.set_visible(id, (flags & is_visible_flag) != 0);
+
+            auto& layer = layers.get(id);
+            layer.content_size = content_size;
+
+            auto commands = command_list {};
+            auto command_count = reader.read<std::uint32_t>();
+
+            for (std::uint32_t j = 0; j < command_count; ++j) {
+
+                switch (reader.read<command_type>()) {
+
+                    case command_type::fill_rectangle: {
+                        auto area = reader.read<measure::rectangle<float>>();
+                        commands.fill_rectangle(area, reader.read<measure::color>());
+                        break;
+                    }
+
+                    case command_type::draw_line: {
+                        auto start = reader.read<measure::point<float>>();
+                        auto end = reader.read<measure::point<float>>();
+                        auto stroke_width = reader.read<float>();
+                        commands.draw_line(start, end, stroke_width, reader.read<measure::color>());
+                        break;
+                    }
+
+                    case command_type::draw_image: {
+                        auto index = reader.read<std::uint32_t>();
+                        if (index >= capture.images.size()) throw std::runtime_error { "The frame capture draws an unknown image." };
+
+                        auto scale = reader.read<float>();
+                        auto top_left = reader.read<measure::point<float>>();
+                        commands.draw_image(&capture.images[index].image, scale, top_left, reader.read<float>());
+                        break;
+                    }
+
+                    case command_type::draw_text: {
+                        auto text = reader.read_string();
+                        auto font_index = reader.read<std::uint32_t>();
+                        if (font_index >= fonts.size()) throw std::runtime_error { "The frame capture uses an unknown font." };
+
+                        auto top_left = reader.read<measure::point<float>>();
+                        auto font_size = reader.read<float>();
+                        auto color = reader.read<measure::color>();
+                        commands.draw_text(text, top_left, fonts[font_index], font_size, color, reader.read<font_weight>());
+                        break;
+                    }
+
+                    case command_type::push_transform:
+                        commands.push_transform(reader.read<transform>());
+                        break;
+
+                    case command_type::pop_transform:
+                        commands.pop_transform();
+                        break;
+
+                    default:
+                        throw std::runtime_error { "The frame capture has an unknown command." };
+
+                }
+
+            }
+
+            layer.commands = std::make_shared<command_list const>(std::move(commands));
+
+        }
+
+        return capture;
+
+    }
+
+}
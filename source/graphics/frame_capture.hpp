@@ -0,0 +1,60 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string>
+
+#include <utility/measure.hpp>
+#include <graphics/image.hpp>
+#include <graphics/layer_tree.hpp>
+
+// A frame exactly as a window handed it to the render thread, in a self-contained binary file: the whole
+// layer tree with every layer's recorded commands, the surface size and DPI, and the images it drew by
+// file path and decoded size. Reading one back rebuilds the layer tree with everything pending, so any
+// backend that renders layers replays it from scratch, the headless ones included.
+
+namespace chrome::graphics {
+
+    struct captured_image {
+        resource::image image;
+        measure::size<std::uint32_t> size { 0, 0 }; // Zero when it wasn't resident yet, the frame skipped it.
+    };
+
+    struct frame_capture {
+
+        frame_capture() = default;
+
+        // Recorded draw_image commands point at the images, so moving is fine but copying isn't.
+        frame_capture(frame_capture const&) = delete;
+        frame_capture(frame_capture&&) = default;
+        frame_capture& operator=(frame_capture const&) = delete;
+        frame_capture& operator=(frame_capture&&) = default;
+
+        ~frame_capture() = default;
+
+        measure::size<std::uint32_t> surface_size { 0, 0 }; // In pixels.
+        float dpi = 96.0f;
+
+        layer_tree layers;
+        std::deque<captured_image> images;
+
+    };
+
+    // Decoded size of an image, if it is.
+    using image_size_provider = std::function<std::optional<measure::size<std::uint32_t>>(resource::image const&)>;
+
+    auto write_frame_capture(
+        std::ostream& output, layer_tree const& layers, measure::size<std::uint32_t> const& surface_size,
+        float const dpi, image_size_provider const& get_image_size
+    ) -> void;
+
+    // Throws std::runtime_error for anything that isn't a complete capture of a version this build reads.
+    auto read_frame_capture(std::istream& input) -> frame_capture;
+
+}
@@ -0,0 +1,94 @@
+#include <graphics/image_loader.hpp>
+
+namespace chrome::graphics {
+
+    image_loader::image_loader(
+        decoder decode, std::size_t const thread_count,
+        std::size_t const queue_capacity, std::size_t const uploads_per_frame
+    )
+    : _decode(std::move(decode)), _queue_capacity(queue_capacity > 0 ? queue_capacity : 1),
+      _uploads_per_frame(uploads_per_frame > 0 ? uploads_per_frame : 1), _pool(thread_count) {}
+
+    auto image_loader::set_completion_callback(completion_callback callback) -> void {
+        _on_completion = std::move(callback);
+    }
+
+    auto image_loader::request(resource::image const& image) -> image_state {
+
+        auto& file_path = image.get_file_path();
+        auto& entry = _entries[file_path];
+
+        if (entry.state != image_state::unknown) return entry.state;
+
+        entry.state = image_state::pending;
+        entry.requested_at = clock::now();
+        entry.generation = ++_generation;
+
+        _waiting.push_back(file_path);
+        dispatch();
+
+        return entry.state;
+
+    }
+
+    auto image_loader::forget(std::string const& file_path) -> void {
+
+        // Anything still waiting or decoding gets dropped when it shows up, thanks to the generation.
+        _entries.erase(file_path);
+
+    }
+
+    auto image_loader::get_state(std::string const& file_path) const -> image_state {
+
+        auto lookup_iterator = _entries.find(file_path);
+        return lookup_iterator != _entries.end() ? lookup_iterator->second.state : image_state::unknown;
+
+    }
+
+    auto image_loader::get_timing(std::string const& file_path) const -> image_timing const* {
+
+        auto lookup_iterator = _entries.find(file_path);
+        return lookup_iterator != _entries.end() ? &lookup_iterator->second.timing : nullptr;
+
+    }
+
+    auto image_loader::has_pending_uploads() -> bool {
+
+        std::lock_guard lock { _completed_mutex };
+        return !_completed.empty();
+
+    }
+
+    auto image_loader::dispatch() -> void {
+
+        while (!_waiting.empty() && _in_flight < _queue_capacity) {
+
+            auto file_path = std::move(_waiting.front());
+            _waiting.pop_front();
+
+            auto lookup_iterator = _entries.find(file_path);
+            if (lookup_iterator == _entries.end()) continue;
+
+            auto generation = lookup_iterator->second.generation;
+            ++_in_flight;
+
+            _pool.submit([this, file_path = std::move(file_path), generation]() mutable {
+
+                auto decode_start = clock::now();
+                auto pixels = _decode(file_path);
+                auto decode_time = clock::now() - decode_start;
+
+                {
+                    std::lock_guard lock { _completed_mutex };
+                    _completed.push_back({ std::move(file_path), std::move(pixels), decode_time, generation });
+                }
+
+                if (_on_completion) _on_completion();
+
+            });
+
+        }
+
+    }
+
+}
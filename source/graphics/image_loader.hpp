@@ -0,0 +1,157 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include <utility/thread_pool.hpp>
+#include <graphics/bitmap.hpp>
+#include <graphics/image.hpp>
+
+// Decodes images on a thread pool and hands the pixels back to the render thread in small batches.
+// The decoder itself is injected, the D2D renderer plugs WIC in while headless tools can use anything.
+// Everything except the decoder and the completion callback runs on the thread owning the loader.
+
+namespace chrome::graphics {
+
+    enum struct image_state : std::uint8_t {
+        unknown,
+        pending,    // Waiting for a decoder slot, being decoded or waiting for upload.
+        resident,
+        failed
+    };
+
+    struct image_timing {
+        std::chrono::nanoseconds decode_time {};
+        std::chrono::nanoseconds upload_time {};
+        std::chrono::nanoseconds latency {};    // From the first request until the upload finished.
+    };
+
+    struct image_loader {
+
+        using clock = std::chrono::steady_clock;
+        using decoder = std::function<std::optional<bitmap>(std::string const& file_path)>;
+        using completion_callback = std::function<void()>;
+
+        // Queue capacity bounds decoded but not yet uploaded images (and with it the memory they hold),
+        // uploads per frame bounds how much upload work a single frame takes on.
+        image_loader(
+            decoder decode, std::size_t const thread_count = 0,
+            std::size_t const queue_capacity = 8, std::size_t const uploads_per_frame = 4
+        );
+
+        image_loader(image_loader const&) = delete;
+        image_loader(image_loader&&) = delete;
+        image_loader& operator=(image_loader const&) = delete;
+        image_loader& operator=(image_loader&&) = delete;
+
+        ~image_loader() = default;
+
+        // Invoked from decoder threads whenever an image is ready for upload, set it before the first request.
+        auto set_completion_callback(completion_callback callback) -> void;
+
+        // Starts decoding the first time an image is seen, later calls just report where it is.
+        auto request(resource::image const& image) -> image_state;
+
+        // Call at frame start. Hands decoded pixels to upload(file_path, bitmap&), bounded per frame.
+        template <typename Upload>
+        auto drain_uploads(Upload&& upload) -> std::size_t;
+
+        // Drops everything known about an image, the next request decodes it again.
+        auto forget(std::string const& file_path) -> void;
+
+        auto get_state(std::string const& file_path) const -> image_state;
+        auto get_timing(std::string const& file_path) const -> image_timing const*;
+        auto has_pending_uploads() -> bool;
+
+    private:
+
+        struct entry {
+            image_state state = image_state::unknown;
+            image_timing timing;
+            clock::time_point requested_at;
+            std::uint32_t generation = 0;
+        };
+
+        struct decoded_image {
+            std::string file_path;
+            std::optional<bitmap> pixels;
+            std::chrono::nanoseconds decode_time;
+            std::uint32_t generation;
+        };
+
+        // Feeds waiting requests to the pool while the queue has room.
+        auto dispatch() -> void;
+
+        decoder _decode;
+        completion_callback _on_completion;
+
+        std::unordered_map<std::string, entry> _entries;
+        std::deque<std::string> _waiting;
+        std::size_t _in_flight = 0;
+        std::size_t _queue_capacity;
+        std::size_t _uploads_per_frame;
+        std::uint32_t _generation = 0;
+
+        std::mutex _completed_mutex;
+        std::deque<decoded_image> _completed;
+
+        // Declared last, so the workers are joined before anything they touch goes away.
+        utility::thread_pool _pool;
+
+    };
+
+    template <typename Upload>
+    auto image_loader::drain_uploads(Upload&& upload) -> std::size_t {
+
+        std::size_t uploaded = 0;
+
+        while (uploaded < _uploads_per_frame) {
+
+            decoded_image image;
+
+            {
+                std::lock_guard lock { _completed_mutex };
+                if (_completed.empty()) break;
+                image = std::move(_completed.front());
+                _completed.pop_front();
+            }
+
+            --_in_flight;
+
+            // Forgotten while it was being decoded, the result is stale.
+            auto lookup_iterator = _entries.find(image.file_path);
+            if (lookup_iterator == _entries.end() || lookup_iterator->second.generation != image.generation) continue;
+
+            auto& entry = lookup_iterator->second;
+            entry.timing.decode_time = image.decode_time;
+
+            if (!image.pixels) { entry.state = image_state::failed; continue; }
+
+            auto upload_start = clock::now();
+            upload(image.file_path, *image.pixels);
+            auto upload_end = clock::now();
+
+            entry.timing.upload_time = upload_end - upload_start;
+            entry.timing.latency = upload_end - entry.requested_at;
+            entry.state = image_state::resident;
+
+            ++uploaded;
+
+        }
+
+        dispatch();
+        return uploaded;
+
+    }
+
+}
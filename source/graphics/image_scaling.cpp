@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <cmath>
+
+#include <graphics/image_scaling.hpp>
+#include <graphics/pixel_kernels.hpp>
+
+namespace chrome::graphics {
+
+    auto downsample_half(bitmap const& source) -> bitmap {
+
+        auto result = bitmap { std::max(1u, (source.width + 1) / 2), std::max(1u, (source.height + 1) / 2) };
+        if (source.width == 0 || source.height == 0) return result;
+
+        // Odd heights repeat the last row, the kernel repeats the last column.
+        for (std::uint32_t y = 0; y < result.height; ++y) {
+            auto top = source.row(std::min(2 * y, source.height - 1));
+            auto bottom = source.row(std::min(2 * y + 1, source.height - 1));
+            kernels::get_kernels().downsample_row(result.row(y), top, bottom, source.width);
+        }
+
+        return result;
+
+    }
+
+    auto build_mip_level(bitmap const& source, std::uint32_t const level) -> bitmap {
+
+        if (level == 0) return source;
+
+        auto result = downsample_half(source);
+        for (auto i = 1u; i < level; ++i) result = downsample_half(result);
+
+        return result;
+
+    }
+
+    auto select_mip_level(std::uint32_t const width, std::uint32_t const height, float const effective_scale) -> std::uint32_t {
+
+        if (!(effective_scale > 0.0f) || effective_scale >= 1.0f) return 0;
+
+        auto level = static_cast<std::uint32_t>(std::floor(std::log2(1.0f / effective_scale)));
+
+        // Never past the level where the smaller side reaches a single pixel.
+        auto smallest_side = std::max(1u, std::min(width, height));
+        auto deepest_level = 0u;
+        while ((smallest_side >> (deepest_level + 1)) > 0) ++deepest_level;
+
+        return std::min(level, deepest_level);
+
+    }
+
+    auto get_mip_size(std::uint32_t const size, std::uint32_t const level) -> std::uint32_t {
+
+        auto result = size;
+        for (auto i = 0u; i < level; ++i) result = std::max(1u, (result + 1) / 2);
+
+        return result;
+
+    }
+
+}
@@ -0,0 +1,28 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+
+#include <graphics/bitmap.hpp>
+
+// CPU downsampling for pre-scaled image variants. Drawing a bitmap at a fraction of its size every
+// frame makes the GPU filter the full-size image each time and linear filtering skips texels past a
+// 2x reduction, so anything drawn much smaller than its source gets a mip level built once instead.
+
+namespace chrome::graphics {
+
+    // Each level halves the one before it (rounding up), level 0 is the image itself.
+    auto downsample_half(bitmap const& source) -> bitmap;
+
+    auto build_mip_level(bitmap const& source, std::uint32_t const level) -> bitmap;
+
+    // Deepest level that's still at least as large as the image ends up on screen, so filtering
+    // only ever shrinks the chosen level by less than half. Effective scale folds in the draw scale,
+    // the current transform and DPI.
+    auto select_mip_level(std::uint32_t const width, std::uint32_t const height, float const effective_scale) -> std::uint32_t;
+
+    auto get_mip_size(std::uint32_t const size, std::uint32_t const level) -> std::uint32_t;
+
+}
@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <utility>
+
+#include <graphics/layer_tree.hpp>
+
+namespace chrome::graphics {
+
+    layer_tree::layer_tree() {
+
+        auto& root_layer = _layers.emplace_back();
+        root_layer.name = "root";
+        root_layer.content_changed = false;
+        root_layer.geometry_changed = false;
+
+    }
+
+    auto layer_tree::add(std::string name, layer_id const parent, bool const is_static) -> layer_id {
+
+        auto id = static_cast<layer_id>(_layers.size());
+
+        auto& new_layer = _layers.emplace_back();
+        new_layer.name = std::move(name);
+        new_layer.parent = parent;
+        new_layer.is_static = is_static;
+
+        _layers[parent].children.push_back(id);
+        sort_children(parent);
+
+        return id;
+
+    }
+
+    auto layer_tree::remove(layer_id const id) -> void {
+
+        if (id == root || !_layers[id].is_alive) return;
+
+        auto& siblings = _layers[_layers[id].parent].children;
+        siblings.erase(std::find(siblings.begin(), siblings.end(), id));
+
+        // Depth first, children are gone before their ids are handed to the backend.
+        std::vector<layer_id> pending { id };
+        while (!pending.empty()) {
+
+            auto current = pending.back();
+            pending.pop_back();
+
+            auto& removed_layer = _layers[current];
+            pending.insert(pending.end(), removed_layer.children.begin(), removed_layer.children.end());
+
+            removed_layer = layer {};
+            removed_layer.is_alive = false;
+            removed_layer.content_changed = false;
+            removed_layer.geometry_changed = false;
+
+            _removed.push_back(current);
+
+        }
+
+        _is_draw_order_valid = false;
+        _order_changed = true;
+
+    }
+
+    auto layer_tree::set_bounds(layer_id const id, measure::rectangle<float> const& bounds) -> void {
+
+        auto& target = _layers[id];
+        auto& [origin, dimension] = bounds;
+
+        auto moved = origin.x != target.bounds.origin.x || origin.y != target.bounds.origin.y;
+        auto resized = dimension.width != target.bounds.dimension.width || dimension.height != target.bounds.dimension.height;
+        if (!moved && !resized) return;
+
+        target.bounds = bounds;
+
+        if (resized) {
+
+            auto& content_size = target.content_size;
+            auto fits = dimension.width <= content_size.width && dimension.height <= content_size.height;
+
+            if (!target.is_static) {
+                content_size = dimension;
+                target.content_changed = true;
+            }
+            else if (!fits) {
+                content_size = { std::max(content_size.width, dimension.width), std::max(content_size.height, dimension.height) };
+                target.content_changed = true;
+            }
+
+        }
+
+        mark_geometry_changed(id);
+
+    }
+
+    auto layer_tree::set_z_index(layer_id const id, std::int32_t const z_index) -> void {
+
+        if (_layers[id].z_index == z_index) return;
+
+        _layers[id].z_index = z_index;
+        sort_children(_layers[id].parent);
+
+    }
+
+    auto layer_tree::set_visible(layer_id const id, bool const is_visible) -> void {
+
+        if (_layers[id].is_visible == is_visible) return;
+
+        _layers[id].is_visible = is_visible;
+        _is_draw_order_valid = false;
+        _order_changed = true;
+
+    }
+
+    auto layer_tree::invalidate_content(layer_id const id) -> void {
+
+        if (id != root) _layers[id].content_changed = true;
+        for (auto child : _layers[id].children) invalidate_content(child);
+
+    }
+
+    auto layer_tree::invalidate(layer_id const id) -> void {
+
+        auto& target = _layers[id];
+        if (id != root && !target.content_changed) target.damage.add({ 0.0f, 0.0f, target.bounds.dimension.width, target.bounds.dimension.height });
+
+        for (auto child : target.children) invalidate(child);
+
+    }
+
+    auto layer_tree::invalidate(measure::rectangle<float> const& area) -> void {
+
+        for (auto id : get_draw_order()) {
+
+            auto& target = _layers[id];
+            if (target.content_changed) continue;
+
+            auto damaged = measure::intersect(get_visible_bounds(id), area);
+            if (damaged.is_empty()) continue;
+
+            auto absolute_bounds = get_absolute_bounds(id);
+            damaged.origin.x -= absolute_bounds.origin.x;
+            damaged.origin.y -= absolute_bounds.origin.y;
+            target.damage.add(damaged);
+
+        }
+
+    }
+
+    auto layer_tree::get_draw_order() const -> std::vector<layer_id> const& {
+
+        if (_is_draw_order_valid) return _draw_order;
+
+        _draw_order.clear();
+
+        // Pre-order walk, children are pushed in reverse so the backmost one comes out first.
+        std::vector<layer_id> pending;
+        for (auto i = _layers[root].children.size(); i-- > 0;) pending.push_back(_layers[root].children[i]);
+
+        while (!pending.empty()) {
+
+            auto id = pending.back();
+            pending.pop_back();
+
+            auto& current = _layers[id];
+            if (!current.is_visible) continue;
+
+            _draw_order.push_back(id);
+            for (auto i = current.children.size(); i-- > 0;) pending.push_back(current.children[i]);
+
+        }
+
+        _is_draw_order_valid = true;
+        return _draw_order;
+
+    }
+
+    auto layer_tree::get_absolute_bounds(layer_id const id) const -> measure::rectangle<float> {
+
+        auto bounds = _layers[id].bounds;
+
+        for (auto ancestor = _layers[id].parent; ancestor != root; ancestor = _layers[ancestor].parent) {
+            bounds.origin.x += _layers[ancestor].bounds.origin.x;
+            bounds.origin.y += _layers[ancestor].bounds.origin.y;
+        }
+
+        return bounds;
+
+    }
+
+    auto layer_tree::get_visible_bounds(layer_id const id) const -> measure::rectangle<float> {
+
+        auto visible = get_absolute_bounds(id);
+
+        for (auto ancestor = _layers[id].parent; ancestor != root; ancestor = _layers[ancestor].parent)
+            visible = measure::intersect(visible, get_absolute_bounds(ancestor));
+
+        return visible;
+
+    }
+
+    auto layer_tree::has_changes() const -> bool {
+
+        if (_order_changed || !_removed.empty()) return true;
+
+        for (auto& current : _layers)
+            if (current.is_alive && (current.content_changed || current.geometry_changed || !current.damage.empty())) return true;
+
+        return false;
+
+    }
+
+    auto layer_tree::clear_changes() -> void {
+
+        for (auto& current : _layers) {
+            current.content_changed = false;
+            current.geometry_changed = false;
+            current.damage.clear();
+        }
+
+        _removed.clear();
+        _order_changed = false;
+
+    }
+
+    auto layer_tree::absorb_changes(layer_tree const& superseded) -> void {
+
+        // Ids are never reused, so the same id is the same layer in both. Layers removed since are
+        // in this tree's removed list already.
+        auto shared_count = std::min(_layers.size(), superseded._layers.size());
+        for (std::size_t id = 0; id < shared_count; ++id) {
+
+            auto& target = _layers[id];
+            auto& older = superseded._layers[id];
+            if (!target.is_alive || !older.is_alive) continue;
+
+            target.content_changed = target.content_changed || older.content_changed;
+            target.geometry_changed = target.geometry_changed || older.geometry_changed;
+
+            // Redrawn in full either way once the content changed.
+            if (target.content_changed) target.damage.clear();
+            else target.damage.add(older.damage);
+
+        }
+
+        _removed.insert(_removed.begin(), superseded._removed.begin(), superseded._removed.end());
+        _order_changed = _order_changed || superseded._order_changed;
+
+    }
+
+    auto layer_tree::mark_geometry_changed(layer_id const id) -> void {
+
+        // Visuals are positioned absolutely, so moving a layer moves everything inside it.
+        _layers[id].geometry_changed = true;
+        for (auto child : _layers[id].children) mark_geometry_changed(child);
+
+    }
+
+    auto layer_tree::sort_children(layer_id const id) -> void {
+
+        auto& children = _layers[id].children;
+        std::stable_sort(children.begin(), children.end(), [this](layer_id lhs, layer_id rhs) {
+            return _layers[lhs].z_index < _layers[rhs].z_index;
+        });
+
+        _is_draw_order_valid = false;
+        _order_changed = true;
+
+    }
+
+}
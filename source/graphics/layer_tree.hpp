@@ -0,0 +1,114 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <utility/measure.hpp>
+#include <utility/region.hpp>
+#include <graphics/command_list.hpp>
+
+// Retained layers of a window, the backend maps each one to its own composition visual and surface.
+// Only the bookkeeping lives here (bounds, stacking order, what changed since the backend last synced),
+// so it runs headless. Every layer is recorded into its own command list, in layer local DIPs.
+
+namespace chrome::graphics {
+
+    using layer_id = std::uint32_t;
+
+    struct layer {
+
+        std::string name;
+        layer_id parent = 0;
+        std::vector<layer_id> children; // Back to front.
+
+        measure::rectangle<float> bounds { 0.0f, 0.0f, 0.0f, 0.0f }; // Relative to the parent.
+        std::int32_t z_index = 0;
+
+        // Static content only depends on the layer's own size and is kept while the layer shrinks,
+        // a resize within what's already recorded just moves and clips it.
+        bool is_static = false;
+        bool is_visible = true;
+        bool is_alive = true;
+
+        // Shared with the copies of the tree handed to the render thread, so describing a frame doesn't copy
+        // what's recorded. Replaced rather than changed, a frame in flight keeps drawing the commands it was given.
+        std::shared_ptr<command_list const> commands = std::make_shared<command_list const>();
+        measure::size<float> content_size { 0.0f, 0.0f }; // What the commands are recorded for.
+
+        // Pending since the last sync. Changed content has to be recorded again and drawn in full,
+        // damage only redraws parts of it with the commands already recorded.
+        bool content_changed = true;
+        bool geometry_changed = true;
+        measure::region<float> damage;
+
+    };
+
+    struct layer_tree {
+
+        static constexpr layer_id root = 0;
+
+        layer_tree();
+
+        // Goes on top of its siblings with the same z index.
+        auto add(std::string name, layer_id const parent = root, bool const is_static = false) -> layer_id;
+
+        // Takes the whole subtree along, ids aren't reused.
+        auto remove(layer_id const id) -> void;
+
+        auto set_bounds(layer_id const id, measure::rectangle<float> const& bounds) -> void;
+        auto set_z_index(layer_id const id, std::int32_t const z_index) -> void;
+        auto set_visible(layer_id const id, bool const is_visible) -> void;
+
+        // The layer and everything below it has to be recorded again.
+        auto invalidate_content(layer_id const id) -> void;
+
+        // Redraws with the recorded commands, the whole layer and everything below it or only what
+        // intersects an area given in root coordinates.
+        auto invalidate(layer_id const id) -> void;
+        auto invalidate(measure::rectangle<float> const& area) -> void;
+
+        auto get(layer_id const id) -> layer& { return _layers[id]; }
+        auto get(layer_id const id) const -> layer const& { return _layers[id]; }
+
+        // Visible layers back to front, parents before their children. The root isn't part of it.
+        auto get_draw_order() const -> std::vector<layer_id> const&;
+
+        auto get_absolute_bounds(layer_id const id) const -> measure::rectangle<float>;
+
+        // Absolute bounds clipped by every ancestor, what ends up on screen.
+        auto get_visible_bounds(layer_id const id) const -> measure::rectangle<float>;
+
+        // Stacking or visibility changed since the last sync, the backend rebuilds its visual order.
+        auto has_order_changed() const { return _order_changed; }
+        auto get_removed() const -> std::vector<layer_id> const& { return _removed; }
+
+        // Anything at all for the backend to do.
+        auto has_changes() const -> bool;
+
+        // Called once the backend synced every pending change.
+        auto clear_changes() -> void;
+
+        // An earlier copy of this tree was never synced, its pending changes are carried over into this one.
+        // Frames the render thread skips are folded into the next this way.
+        auto absorb_changes(layer_tree const& superseded) -> void;
+
+    private:
+
+        auto mark_geometry_changed(layer_id const id) -> void;
+        auto sort_children(layer_id const id) -> void;
+
+        std::vector<layer> _layers;
+        std::vector<layer_id> _removed;
+
+        mutable std::vector<layer_id> _draw_order;
+        mutable bool _is_draw_order_valid = false;
+        bool _order_changed = true;
+
+    };
+
+}
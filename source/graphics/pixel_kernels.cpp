@@ -0,0 +1,600 @@
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define CHROME_PIXEL_KERNELS_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CHROME_TARGET_AVX2
+#else
+#define CHROME_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#include <graphics/pixel_kernels.hpp>
+
+namespace chrome::graphics::kernels {
+
+    namespace {
+
+        // Exact division by 255 for products of two bytes, the SIMD versions do the same per 16 bit lane.
+        inline auto divide_by_255(std::uint32_t value) {
+            value += 128;
+            return (value + (value >> 8)) >> 8;
+        }
+
+        namespace scalar {
+
+            auto swizzle_rgba_to_bgra(std::uint32_t* destination, std::uint32_t const* source, std::size_t count) -> void {
+                for (std::size_t i = 0; i < count; ++i) {
+                    auto pixel = source[i];
+                    destination[i] = (pixel & 0xff00ff00u) | ((pixel >> 16) & 0xffu) | ((pixel & 0xffu) << 16);
+                }
+            }
+
+            auto premultiply_pixel(std::uint32_t pixel) -> std::uint32_t {
+
+                auto alpha = pixel >> 24;
+                auto result = pixel & 0xff000000u;
+                for (auto shift = 0u; shift < 24u; shift += 8u) result |= divide_by_255(((pixel >> shift) & 0xffu) * alpha) << shift;
+
+                return result;
+
+            }
+
+            auto premultiply(std::uint32_t* destination, std::uint32_t const* source, std::size_t count) -> void {
+                for (std::size_t i = 0; i < count; ++i) destination[i] = premultiply_pixel(source[i]);
+            }
+
+            // Floating point so the SIMD versions can match it exactly, they have no integer division.
+            auto unpremultiply_pixel(std::uint32_t pixel) -> std::uint32_t {
+
+                auto alpha = pixel >> 24;
+                if (alpha == 0u) return 0u;
+
+                auto inverse_alpha = 255.0f / static_cast<float>(alpha);
+                auto result = pixel & 0xff000000u;
+
+                for (auto shift = 0u; shift < 24u; shift += 8u) {
+                    auto channel = static_cast<std::uint32_t>(static_cast<float>((pixel >> shift) & 0xffu) * inverse_alpha + 0.5f);
+                    result |= std::min(channel, 255u) << shift;
+                }
+
+                return result;
+
+            }
+
+            auto unpremultiply(std::uint32_t* destination, std::uint32_t const* source, std::size_t count) -> void {
+                for (std::size_t i = 0; i < count; ++i) destination[i] = unpremultiply_pixel(source[i]);
+            }
+
+            auto blend_pixel(std::uint32_t destination, std::uint32_t source, std::uint32_t opacity) -> std::uint32_t {
+
+                auto result = 0u;
+
+                if (opacity != 255u) {
+                    for (auto shift = 0u; shift < 32u; shift += 8u) result |= divide_by_255(((source >> shift) & 0xffu) * opacity) << shift;
+                    source = result; result = 0u;
+                }
+
+                auto inverse_alpha = 255u - (source >> 24);
+                for (auto shift = 0u; shift < 32u; shift += 8u) {
+                    auto d = (destination >> shift) & 0xffu; auto s = (source >> shift) & 0xffu;
+                    result |= std::min(s + divide_by_255(d * inverse_alpha), 255u) << shift;
+                }
+
+                return result;
+
+            }
+
+            auto blend_source_over(std::uint32_t* destination, std::uint32_t const* source, std::size_t count, std::uint32_t opacity) -> void {
+                for (std::size_t i = 0; i < count; ++i) destination[i] = blend_pixel(destination[i], source[i], opacity);
+            }
+
+            auto fill_span(std::uint32_t* destination, std::size_t count, std::uint32_t color) -> void {
+                std::fill_n(destination, count, color);
+            }
+
+            auto blend_span(std::uint32_t* destination, std::size_t count, std::uint32_t color) -> void {
+
+                if ((color >> 24) == 255u) return fill_span(destination, count, color);
+                if (color == 0u) return;
+
+                for (std::size_t i = 0; i < count; ++i) destination[i] = blend_pixel(destination[i], color, 255u);
+
+            }
+
+            // Rounds to nearest.
+            auto average_pixels(std::uint32_t a, std::uint32_t b, std::uint32_t c, std::uint32_t d) -> std::uint32_t {
+
+                auto result = 0u;
+
+                for (auto shift = 0u; shift < 32u; shift += 8u) {
+                    auto sum = ((a >> shift) & 0xffu) + ((b >> shift) & 0xffu) + ((c >> shift) & 0xffu) + ((d >> shift) & 0xffu);
+                    result |= ((sum + 2u) >> 2) << shift;
+                }
+
+                return result;
+
+            }
+
+            auto downsample_row(std::uint32_t* destination, std::uint32_t const* top, std::uint32_t const* bottom, std::size_t source_width) -> void {
+                for (std::size_t x = 0; 2 * x < source_width; ++x) {
+                    auto left = 2 * x, right = std::min(2 * x + 1, source_width - 1);
+                    destination[x] = average_pixels(top[left], top[right], bottom[left], bottom[right]);
+                }
+            }
+
+        }
+
+#if defined(CHROME_PIXEL_KERNELS_X86)
+
+        namespace sse2 {
+
+            // Per 16 bit lane: (value * factor) / 255, rounded like divide_by_255.
+            inline auto multiply_divide_255(__m128i value, __m128i factor) {
+                auto product = _mm_add_epi16(_mm_mullo_epi16(value, factor), _mm_set1_epi16(128));
+                return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+            }
+
+            // Alpha of each pixel in all four of its lanes, for two unpacked pixels.
+            inline auto broadcast_alpha(__m128i pixels) {
+                pixels = _mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3));
+                return _mm_shufflehi_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+
+            auto swizzle_rgba_to_bgra(std::uint32_t* destination, std::uint32_t const* source, std::size_t count) -> void {
+
+                std::size_t i = 0;
+                auto kept = _mm_set1_epi32(static_cast<int>(0xff00ff00u));
+                auto low_byte = _mm_set1_epi32(0xff);
+
+                for (; i + 4 <= count; i += 4) {
+                    auto pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + i));
+                    auto result = _mm_or_si128(_mm_and_si128(pixels, kept), _mm_or_si128(
+                        _mm_and_si128(_mm_srli_epi32(pixels, 16), low_byte), _mm_slli_epi32(_mm_and_si128(pixels, low_byte), 16)
+                    ));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), result);
+                }
+
+                scalar::swizzle_rgba_to_bgra(destination + i, source + i, count - i);
+
+            }
+
+            auto premultiply(std::uint32_t* destination, std::uint32_t const* source, std::size_t count) -> void {
+
+                std::size_t i = 0;
+                auto zero = _mm_setzero_si128();
+                auto alpha_mask = _mm_set1_epi32(static_cast<int>(0xff000000u));
+
+                for (; i + 4 <= count; i += 4) {
+
+                    auto pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + i));
+                    auto low = _mm_unpacklo_epi8(pixels, zero), high = _mm_unpackhi_epi8(pixels, zero);
+
+                    low = multiply_divide_255(low, broadcast_alpha(low));
+                    high = multiply_divide_255(high, broadcast_alpha(high));
+
+                    // Alpha itself comes out as alpha * alpha / 255, put the original back.
+                    auto result = _mm_or_si128(_mm_andnot_si128(alpha_mask, _mm_packus_epi16(low, high)), _mm_and_si128(pixels, alpha_mask));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), result);
+
+                }
+
+                scalar::premultiply(destination + i, source + i, count - i);
+
+            }
+
+            auto unpremultiply(std::uint32_t* destination, std::uint32_t const* source, std::size_t count) -> void {
+
+                std::size_t i = 0;
+                auto byte_mask = _mm_set1_epi32(0xff);
+                auto alpha_mask = _mm_set1_epi32(static_cast<int>(0xff000000u));
+                auto maximum = _mm_set1_epi32(255);
+                auto half = _mm_set1_ps(0.5f);
+
+                for (; i + 4 <= count; i += 4) {
+
+                    auto pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + i));
+                    auto alpha = _mm_srli_epi32(pixels, 24);
+                    auto transparent = _mm_cmpeq_epi32(alpha, _mm_setzero_si128());
+
+                    // Transparent lanes divide by zero, their result is masked off below.
+                    auto inverse_alpha = _mm_div_ps(_mm_set1_ps(255.0f), _mm_cvtepi32_ps(alpha));
+                    auto result = _mm_and_si128(pixels, alpha_mask);
+
+                    for (auto shift = 0; shift < 24; shift += 8) {
+
+                        auto channel = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, shift), byte_mask));
+                        auto scaled = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(channel, inverse_alpha), half));
+
+                        // No 32 bit min in SSE2, clamp through a compare instead.
+                        auto over = _mm_cmpgt_epi32(scaled, maximum);
+                        scaled = _mm_or_si128(_mm_andnot_si128(over, scaled), _mm_and_si128(over, maximum));
+                        result = _mm_or_si128(result, _mm_slli_epi32(scaled, shift));
+
+                    }
+
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_andnot_si128(transparent, result));
+
+                }
+
+                scalar::unpremultiply(destination + i, source + i, count - i);
+
+            }
+
+            auto blend_source_over(std::uint32_t* destination, std::uint32_t const* source, std::size_t count, std::uint32_t opacity) -> void {
+
+                std::size_t i = 0;
+                auto zero = _mm_setzero_si128();
+                auto opacity_8 = _mm_set1_epi16(static_cast<short>(opacity));
+                auto all_255 = _mm_set1_epi16(255);
+
+                for (; i + 4 <= count; i += 4) {
+
+                    auto source_4 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(source + i));
+                    auto destination_4 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(destination + i));
+
+                    auto source_low = _mm_unpacklo_epi8(source_4, zero), source_high = _mm_unpackhi_epi8(source_4, zero);
+                    if (opacity != 255u) {
+                        source_low = multiply_divide_255(source_low, opacity_8);
+                        source_high = multiply_divide_255(source_high, opacity_8);
+                    }
+
+                    auto low = multiply_divide_255(_mm_unpacklo_epi8(destination_4, zero), _mm_sub_epi16(all_255, broadcast_alpha(source_low)));
+                    auto high = multiply_divide_255(_mm_unpackhi_epi8(destination_4, zero), _mm_sub_epi16(all_255, broadcast_alpha(source_high)));
+
+                    auto result = _mm_adds_epu8(_mm_packus_epi16(low, high), _mm_packus_epi16(source_low, source_high));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), result);
+
+                }
+
+                scalar::blend_source_over(destination + i, source + i, count - i, opacity);
+
+            }
+
+            auto fill_span(std::uint32_t* destination, std::size_t count, std::uint32_t color) -> void {
+
+                std::size_t i = 0;
+                auto color_4 = _mm_set1_epi32(static_cast<int>(color));
+                for (; i + 4 <= count; i += 4) _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), color_4);
+
+                scalar::fill_span(destination + i, count - i, color);
+
+            }
+
+            auto blend_span(std::uint32_t* destination, std::size_t count, std::uint32_t color) -> void {
+
+                if ((color >> 24) == 255u) return fill_span(destination, count, color);
+                if (color == 0u) return;
+
+                std::size_t i = 0;
+                auto zero = _mm_setzero_si128();
+                auto color_4 = _mm_set1_epi32(static_cast<int>(color));
+                auto inverse_alpha = _mm_set1_epi16(static_cast<short>(255u - (color >> 24)));
+
+                for (; i + 4 <= count; i += 4) {
+
+                    auto pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(destination + i));
+                    auto low = multiply_divide_255(_mm_unpacklo_epi8(pixels, zero), inverse_alpha);
+                    auto high = multiply_divide_255(_mm_unpackhi_epi8(pixels, zero), inverse_alpha);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_adds_epu8(_mm_packus_epi16(low, high), color_4));
+
+                }
+
+                scalar::blend_span(destination + i, count - i, color);
+
+            }
+
+            auto downsample_row(std::uint32_t* destination, std::uint32_t const* top, std::uint32_t const* bottom, std::size_t source_width) -> void {
+
+                std::size_t x = 0;
+                auto zero = _mm_setzero_si128();
+                auto rounding = _mm_set1_epi16(2);
+
+                // Two destination pixels out of a 4x2 block per iteration.
+                for (; 2 * x + 4 <= source_width; x += 2) {
+
+                    auto top_4 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(top + 2 * x));
+                    auto bottom_4 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(bottom + 2 * x));
+
+                    auto low = _mm_add_epi16(_mm_unpacklo_epi8(top_4, zero), _mm_unpacklo_epi8(bottom_4, zero));
+                    auto high = _mm_add_epi16(_mm_unpackhi_epi8(top_4, zero), _mm_unpackhi_epi8(bottom_4, zero));
+
+                    low = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+                    high = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+
+                    auto sums = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(low, high), rounding), 2);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(destination + x), _mm_packus_epi16(sums, zero));
+
+                }
+
+                scalar::downsample_row(destination + x, top + 2 * x, bottom + 2 * x, source_width - 2 * x);
+
+            }
+
+        }
+
+        namespace avx2 {
+
+            CHROME_TARGET_AVX2 inline auto multiply_divide_255(__m256i value, __m256i factor) {
+                auto product = _mm256_add_epi16(_mm256_mullo_epi16(value, factor), _mm256_set1_epi16(128));
+                return _mm256_srli_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+            }
+
+            // Byte shuffle spreading each pixel's alpha over its four unpacked lanes.
+            CHROME_TARGET_AVX2 inline auto broadcast_alpha(__m256i pixels) {
+                auto alpha_shuffle = _mm256_setr_epi8(
+                    6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15,
+                    6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15
+                );
+                return _mm256_shuffle_epi8(pixels, alpha_shuffle);
+            }
+
+            CHROME_TARGET_AVX2 auto swizzle_rgba_to_bgra(std::uint32_t* destination, std::uint32_t const* source, std::size_t count) -> void {
+
+                std::size_t i = 0;
+                auto swap_shuffle = _mm256_setr_epi8(
+                    2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                    2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15
+                );
+
+                for (; i + 8 <= count; i += 8) {
+                    auto pixels = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(source + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_shuffle_epi8(pixels, swap_shuffle));
+                }
+
+                // The hand-off compiles to a tail jump without vzeroupper, so the upper halves are cleared here.
+                _mm256_zeroupper();
+                sse2::swizzle_rgba_to_bgra(destination + i, source + i, count - i);
+
+            }
+
+            CHROME_TARGET_AVX2 auto premultiply(std::uint32_t* destination, std::uint32_t const* source, std::size_t count) -> void {
+
+                std::size_t i = 0;
+                auto zero = _mm256_setzero_si256();
+                auto alpha_mask = _mm256_set1_epi32(static_cast<int>(0xff000000u));
+
+                for (; i + 8 <= count; i += 8) {
+
+                    auto pixels = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(source + i));
+                    auto low = _mm256_unpacklo_epi8(pixels, zero), high = _mm256_unpackhi_epi8(pixels, zero);
+
+                    low = multiply_divide_255(low, broadcast_alpha(low));
+                    high = multiply_divide_255(high, broadcast_alpha(high));
+
+                    // Unpack and pack both work within 128 bit halves, so the pixel order comes out intact.
+                    auto result = _mm256_or_si256(
+                        _mm256_andnot_si256(alpha_mask, _mm256_packus_epi16(low, high)), _mm256_and_si256(pixels, alpha_mask)
+                    );
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), result);
+
+                }
+
+                _mm256_zeroupper();
+                sse2::premultiply(destination + i, source + i, count - i);
+
+            }
+
+            CHROME_TARGET_AVX2 auto unpremultiply(std::uint32_t* destination, std::uint32_t const* source, std::size_t count) -> void {
+
+                std::size_t i = 0;
+                auto byte_mask = _mm256_set1_epi32(0xff);
+                auto alpha_mask = _mm256_set1_epi32(static_cast<int>(0xff000000u));
+                auto maximum = _mm256_set1_epi32(255);
+                auto half = _mm256_set1_ps(0.5f);
+
+                for (; i + 8 <= count; i += 8) {
+
+                    auto pixels = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(source + i));
+                    auto alpha = _mm256_srli_epi32(pixels, 24);
+                    auto transparent = _mm256_cmpeq_epi32(alpha, _mm256_setzero_si256());
+
+                    auto inverse_alpha = _mm256_div_ps(_mm256_set1_ps(255.0f), _mm256_cvtepi32_ps(alpha));
+                    auto result = _mm256_and_si256(pixels, alpha_mask);
+
+                    for (auto shift = 0; shift < 24; shift += 8) {
+                        auto channel = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels, shift), byte_mask));
+                        auto scaled = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(channel, inverse_alpha), half));
+                        result = _mm256_or_si256(result, _mm256_slli_epi32(_mm256_min_epi32(scaled, maximum), shift));
+                    }
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_andnot_si256(transparent, result));
+
+                }
+
+                _mm256_zeroupper();
+                sse2::unpremultiply(destination + i, source + i, count - i);
+
+            }
+
+            CHROME_TARGET_AVX2 auto blend_source_over(std::uint32_t* destination, std::uint32_t const* source, std::size_t count, std::uint32_t opacity) -> void {
+
+                std::size_t i = 0;
+                auto zero = _mm256_setzero_si256();
+                auto opacity_16 = _mm256_set1_epi16(static_cast<short>(opacity));
+                auto all_255 = _mm256_set1_epi16(255);
+
+                for (; i + 8 <= count; i += 8) {
+
+                    auto source_8 = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(source + i));
+                    auto destination_8 = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(destination + i));
+
+                    auto source_low = _mm256_unpacklo_epi8(source_8, zero), source_high = _mm256_unpackhi_epi8(source_8, zero);
+                    if (opacity != 255u) {
+                        source_low = multiply_divide_255(source_low, opacity_16);
+                        source_high = multiply_divide_255(source_high, opacity_16);
+                    }
+
+                    auto low = multiply_divide_255(_mm256_unpacklo_epi8(destination_8, zero), _mm256_sub_epi16(all_255, broadcast_alpha(source_low)));
+                    auto high = multiply_divide_255(_mm256_unpackhi_epi8(destination_8, zero), _mm256_sub_epi16(all_255, broadcast_alpha(source_high)));
+
+                    auto result = _mm256_adds_epu8(_mm256_packus_epi16(low, high), _mm256_packus_epi16(source_low, source_high));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), result);
+
+                }
+
+                _mm256_zeroupper();
+                sse2::blend_source_over(destination + i, source + i, count - i, opacity);
+
+            }
+
+            CHROME_TARGET_AVX2 auto fill_span(std::uint32_t* destination, std::size_t count, std::uint32_t color) -> void {
+
+                std::size_t i = 0;
+                auto color_8 = _mm256_set1_epi32(static_cast<int>(color));
+                for (; i + 8 <= count; i += 8) _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), color_8);
+
+                _mm256_zeroupper();
+                sse2::fill_span(destination + i, count - i, color);
+
+            }
+
+            CHROME_TARGET_AVX2 auto blend_span(std::uint32_t* destination, std::size_t count, std::uint32_t color) -> void {
+
+                if ((color >> 24) == 255u) return fill_span(destination, count, color);
+                if (color == 0u) return;
+
+                std::size_t i = 0;
+                auto zero = _mm256_setzero_si256();
+                auto color_8 = _mm256_set1_epi32(static_cast<int>(color));
+                auto inverse_alpha = _mm256_set1_epi16(static_cast<short>(255u - (color >> 24)));
+
+                for (; i + 8 <= count; i += 8) {
+
+                    auto pixels = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(destination + i));
+                    auto low = multiply_divide_255(_mm256_unpacklo_epi8(pixels, zero), inverse_alpha);
+                    auto high = multiply_divide_255(_mm256_unpackhi_epi8(pixels, zero), inverse_alpha);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_adds_epu8(_mm256_packus_epi16(low, high), color_8));
+
+                }
+
+                _mm256_zeroupper();
+                sse2::blend_span(destination + i, count - i, color);
+
+            }
+
+            CHROME_TARGET_AVX2 auto downsample_row(std::uint32_t* destination, std::uint32_t const* top, std::uint32_t const* bottom, std::size_t source_width) -> void {
+
+                std::size_t x = 0;
+                auto zero = _mm256_setzero_si256();
+                auto rounding = _mm256_set1_epi16(2);
+
+                // Four destination pixels out of an 8x2 block per iteration, two from each 128 bit half.
+                for (; 2 * x + 8 <= source_width; x += 4) {
+
+                    auto top_8 = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(top + 2 * x));
+                    auto bottom_8 = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(bottom + 2 * x));
+
+                    auto low = _mm256_add_epi16(_mm256_unpacklo_epi8(top_8, zero), _mm256_unpacklo_epi8(bottom_8, zero));
+                    auto high = _mm256_add_epi16(_mm256_unpackhi_epi8(top_8, zero), _mm256_unpackhi_epi8(bottom_8, zero));
+
+                    low = _mm256_add_epi16(low, _mm256_srli_si256(low, 8));
+                    high = _mm256_add_epi16(high, _mm256_srli_si256(high, 8));
+
+                    auto sums = _mm256_srli_epi16(_mm256_add_epi16(_mm256_unpacklo_epi64(low, high), rounding), 2);
+
+                    // Each half packs its two pixels into its low 64 bits, gather both into the low half.
+                    auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sums, zero), _MM_SHUFFLE(3, 1, 2, 0));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + x), _mm256_castsi256_si128(packed));
+
+                }
+
+                _mm256_zeroupper();
+                sse2::downsample_row(destination + x, top + 2 * x, bottom + 2 * x, source_width - 2 * x);
+
+            }
+
+        }
+
+#endif
+
+        constexpr kernel_table scalar_kernels {
+            instruction_set::scalar,
+            scalar::swizzle_rgba_to_bgra, scalar::premultiply, scalar::unpremultiply,
+            scalar::blend_source_over, scalar::fill_span, scalar::blend_span,
+            scalar::downsample_row
+        };
+
+#if defined(CHROME_PIXEL_KERNELS_X86)
+        constexpr kernel_table sse2_kernels {
+            instruction_set::sse2,
+            sse2::swizzle_rgba_to_bgra, sse2::premultiply, sse2::unpremultiply,
+            sse2::blend_source_over, sse2::fill_span, sse2::blend_span,
+            sse2::downsample_row
+        };
+
+        constexpr kernel_table avx2_kernels {
+            instruction_set::avx2,
+            avx2::swizzle_rgba_to_bgra, avx2::premultiply, avx2::unpremultiply,
+            avx2::blend_source_over, avx2::fill_span, avx2::blend_span,
+            avx2::downsample_row
+        };
+#endif
+
+    }
+
+    auto detect_instruction_set() -> instruction_set {
+
+#if defined(CHROME_PIXEL_KERNELS_X86)
+#if defined(_MSC_VER)
+        int registers[4];
+        __cpuid(registers, 0);
+        auto highest_leaf = registers[0];
+
+        __cpuid(registers, 1);
+        auto has_sse2 = (registers[3] & (1 << 26)) != 0;
+        auto has_avx = (registers[2] & (1 << 28)) != 0;
+        auto os_saves_avx = (registers[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+
+        auto has_avx2 = false;
+        if (highest_leaf >= 7) { __cpuidex(registers, 7, 0); has_avx2 = (registers[1] & (1 << 5)) != 0; }
+
+        if (has_avx && os_saves_avx && has_avx2) return instruction_set::avx2;
+        if (has_sse2) return instruction_set::sse2;
+#else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return instruction_set::avx2;
+        if (__builtin_cpu_supports("sse2")) return instruction_set::sse2;
+#endif
+#endif
+
+        return instruction_set::scalar;
+
+    }
+
+    auto get_kernels(instruction_set const set) -> kernel_table const& {
+
+#if defined(CHROME_PIXEL_KERNELS_X86)
+        auto supported = detect_instruction_set();
+        auto chosen = std::min(set, supported);
+
+        if (chosen == instruction_set::avx2) return avx2_kernels;
+        if (chosen == instruction_set::sse2) return sse2_kernels;
+#else
+        static_cast<void>(set);
+#endif
+
+        return scalar_kernels;
+
+    }
+
+    auto get_kernels() -> kernel_table const& {
+
+        static auto& kernels = get_kernels(detect_instruction_set());
+        return kernels;
+
+    }
+
+    auto get_instruction_set_name(instruction_set const set) -> char const* {
+
+        switch (set) {
+            case instruction_set::avx2: return "avx2";
+            case instruction_set::sse2: return "sse2";
+            default: return "scalar";
+        }
+
+    }
+
+}
@@ -0,0 +1,56 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// CPU pixel routines over premultiplied BGRA (0xAARRGGBB) spans, except where noted otherwise.
+// Every kernel has a scalar reference plus SSE2 and AVX2 versions on x86, the best one the CPU
+// supports is picked at runtime. All versions produce bit-identical results.
+
+namespace chrome::graphics::kernels {
+
+    enum struct instruction_set : std::uint8_t {
+        scalar,
+        sse2,
+        avx2
+    };
+
+    struct kernel_table {
+
+        instruction_set set;
+
+        // Straight RGBA (as in memory, R first) to BGRA and back, the same byte swap either way.
+        auto (*swizzle_rgba_to_bgra)(std::uint32_t* destination, std::uint32_t const* source, std::size_t count) -> void;
+
+        // Straight alpha to premultiplied and back, fully transparent pixels unpremultiply to zero.
+        auto (*premultiply)(std::uint32_t* destination, std::uint32_t const* source, std::size_t count) -> void;
+        auto (*unpremultiply)(std::uint32_t* destination, std::uint32_t const* source, std::size_t count) -> void;
+
+        // Source-over of source scaled by opacity (0-255) onto destination.
+        auto (*blend_source_over)(std::uint32_t* destination, std::uint32_t const* source, std::size_t count, std::uint32_t opacity) -> void;
+
+        auto (*fill_span)(std::uint32_t* destination, std::size_t count, std::uint32_t color) -> void;
+
+        // Source-over of a single color onto every destination pixel.
+        auto (*blend_span)(std::uint32_t* destination, std::size_t count, std::uint32_t color) -> void;
+
+        // 2x2 box filter of two source rows into one half as wide, (source_width + 1) / 2 pixels.
+        // An odd last column is repeated, premultiplied channels average correctly as they are.
+        auto (*downsample_row)(std::uint32_t* destination, std::uint32_t const* top, std::uint32_t const* bottom, std::size_t source_width) -> void;
+
+    };
+
+    auto detect_instruction_set() -> instruction_set;
+
+    // Versions the CPU lacks fall back to the best one it has.
+    auto get_kernels(instruction_set const set) -> kernel_table const&;
+
+    // Picked once, on first use.
+    auto get_kernels() -> kernel_table const&;
+
+    auto get_instruction_set_name(instruction_set const set) -> char const*;
+
+}
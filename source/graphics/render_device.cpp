@@ -0,0 +1,589 @@
+#include <algorithm>
+#include <array>
+
+#include <graphics/render_device.hpp>
+#include <graphics/pixel_kernels.hpp>
+#include <graphics/software_renderer.hpp>
+#include <com/runtime_validation.hpp>
+#include <utility/profiler.hpp>
+#include <utility/string_conversion.hpp>
+
+namespace chrome::graphics {
+
+    render_device::render_device(utility::startup_timeline* timeline) {
+
+        // DWrite doesn't depend on any of the GPU devices, so it comes up on a worker in the meantime.
+        // Only the first text layout has to wait for it.
+        _pending_factory_dwrite = std::async(std::launch::async, [timeline] {
+
+            utility::startup_timeline::scope phase { timeline, "dwrite factory" };
+
+            IDWriteFactory* temporary_factory_dwrite;
+            auto hr = DWriteCreateFactory(
+                DWRITE_FACTORY_TYPE_ISOLATED, __uuidof(IDWriteFactory), 
+                reinterpret_cast<IUnknown**>(&temporary_factory_dwrite)
+            );
+
+            com::validate_result(hr, "Failed during the creation of the DWrite factory.");
+            return com::make_unique(temporary_factory_dwrite);
+
+        });
+
+        // Each of these is built on the one before, so they stay in order.
+        {
+
+            utility::startup_timeline::scope phase { timeline, "d3d11 device" };
+
+            std::uint32_t flags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+#if defined(_DEBUG)
+            flags |= D3D11_CREATE_DEVICE_DEBUG;
+#endif
+
+            std::array requested_levels { 
+                D3D_FEATURE_LEVEL_12_1, D3D_FEATURE_LEVEL_12_0, 
+                D3D_FEATURE_LEVEL_11_1, D3D_FEATURE_LEVEL_11_0,
+            };
+
+            D3D_FEATURE_LEVEL received_feature_level; // Any will do in this scenario.
+            ID3D11Device* temporary_device; ID3D11DeviceContext* temporary_context;
+
+            auto create_device = [&](D3D_DRIVER_TYPE driver_type) {
+                return D3D11CreateDevice(nullptr, driver_type, nullptr,
+                    flags, requested_levels.data(), static_cast<std::uint32_t>(requested_levels.size()),
+                    D3D11_SDK_VERSION, &temporary_device, &received_feature_level, &temporary_context
+                );
+            };
+
+            // No usable GPU (remote sessions, broken drivers), fall back to WARP which rasterizes on the CPU.
+            // The surface stays a DComp one, so the headless software_renderer is only used by tooling.
+            auto hr = create_device(D3D_DRIVER_TYPE_HARDWARE);
+            if (FAILED(hr)) hr = create_device(D3D_DRIVER_TYPE_WARP);
+
+            com::validate_result(hr, "Failed during creation of the D3D11 device.");
+            _device_context_d3d11 = com::make_unique(temporary_context);
+            _device_d3d11 = com::make_unique(temporary_device);
+
+        }
+
+        {
+
+            utility::startup_timeline::scope phase { timeline, "d2d device" };
+
+            IDXGIDevice* temporary_device_dxgi;
+            _device_d3d11->QueryInterface<IDXGIDevice>(&temporary_device_dxgi);
+            auto device_dxgi = com::make_unique<IDXGIDevice>(temporary_device_dxgi);
+
+            auto creation_properties = D2D1::CreationProperties(
+                D2D1_THREADING_MODE_SINGLE_THREADED, D2D1_DEBUG_LEVEL_INFORMATION, D2D1_DEVICE_CONTEXT_OPTIONS_NONE
+            );
+
+            ID2D1Device* temporary_device_d2d1;
+            auto hr = D2D1CreateDevice(device_dxgi.get(), creation_properties, &temporary_device_d2d1);
+            _device_d2d1 = com::make_unique(temporary_device_d2d1);
+            com::validate_result(hr, "Failed during the creation of the D2D1 device.");
+
+            ID2D1DeviceContext* temporary_device_context_d2d1;
+            hr = _device_d2d1->CreateDeviceContext(D2D1_DEVICE_CONTEXT_OPTIONS_NONE, &temporary_device_context_d2d1);
+            com::validate_result(hr, "Failed during the creation of the resource creating D2D1 device context.");
+            _resource_device_context_d2d1 = com::make_unique(temporary_device_context_d2d1);
+            _resource_device_context_d2d1->SetDpi(96.0f, 96.0f); // Resources are DPI independent, each window draws at its own.
+
+            ID2D1SolidColorBrush* temporary_brush;
+            _resource_device_context_d2d1->CreateSolidColorBrush(D2D1::ColorF(1.0f, 1.0f, 1.0f), &temporary_brush);
+            _brush = com::make_unique(temporary_brush);
+
+        }
+
+        {
+
+            utility::startup_timeline::scope phase { timeline, "dcomp device" };
+
+            IDCompositionDesktopDevice* temporary_device_dcomp;
+            auto hr = DCompositionCreateDevice2(_device_d2d1.get(), IID_PPV_ARGS(&temporary_device_dcomp));
+            com::validate_result(hr, "Failed during the creation of the DComp device.");
+            _device_dcomp = com::make_unique(temporary_device_dcomp);
+
+        }
+
+    }
+
+    auto render_device::commit() -> void {
+
+        {
+            CHROME_PROFILE_ZONE("Commit");
+            _device_dcomp->Commit();
+        }
+
+        // Whatever this frame drew is safe, the rest is fair game once over budget.
+        _texture_residency.trim([this](std::string const& filename) { evict_texture(filename); });
+        if (_texture_atlas.should_repack()) repack_atlas();
+
+    }
+
+    auto render_device::wait_for_commit_completion() -> void {
+        CHROME_PROFILE_ZONE("WaitForCommitCompletion");
+        _device_dcomp->WaitForCommitCompletion();
+    }
+
+    auto render_device::get_dwrite_factory() -> IDWriteFactory* {
+
+        if (!_factory_dwrite) _factory_dwrite = _pending_factory_dwrite.get();
+        return _factory_dwrite.get();
+
+    }
+
+    auto render_device::get_text_layout(
+        std::string_view text, std::string_view font_family, float const font_size, font_weight const weight
+    ) -> IDWriteTextLayout* {
+
+        // Labels repeat every frame, a hit costs a hash lookup and no conversions or DWrite calls.
+        auto format_key = text_format_view { font_family, font_size, weight, font_style::normal };
+        auto layout_key = text_layout_view { text, format_key, unconstrained_text_extent };
+
+        auto& text_layout = _text_cache.get_layout(layout_key, [this](text_layout_view const& key) {
+
+            auto& text_format = _text_cache.get_format(key.format, [this](text_format_view const& format) {
+
+                utility::utf16_buffer<> wfont_family { format.font_family };
+
+                IDWriteTextFormat* temporary_text_format;
+                auto hr = get_dwrite_factory()->CreateTextFormat(
+                    utility::as_wide(wfont_family), nullptr, static_cast<DWRITE_FONT_WEIGHT>(format.weight),
+                    static_cast<DWRITE_FONT_STYLE>(format.style), DWRITE_FONT_STRETCH_NORMAL,
+                    format.font_size, L"en_US", &temporary_text_format
+                );
+
+                com::validate_result(hr, "Failed during the creation of a text format.");
+                return com::make_unique(temporary_text_format);
+
+            });
+
+            // Labels fit inline, a miss only pays for the DWrite objects.
+            utility::utf16_buffer<> wtext { key.text };
+
+            IDWriteTextLayout* temporary_text_layout;
+            auto hr = get_dwrite_factory()->CreateTextLayout(
+                utility::as_wide(wtext), static_cast<UINT32>(wtext.size()), text_format.get(),
+                key.max_width, unconstrained_text_extent, &temporary_text_layout
+            );
+
+            com::validate_result(hr, "Failed during the creation of a text layout.");
+            return com::make_unique(temporary_text_layout);
+
+        });
+
+        return text_layout.get();
+
+    }
+
+    auto render_device::get_font_advances(std::string_view font_family, font_weight const weight) -> font_advances {
+
+        IDWriteFontCollection* temporary_font_collection;
+        auto hr = get_dwrite_factory()->GetSystemFontCollection(&temporary_font_collection, false);
+        com::validate_result(hr, "Failed to get the system font collection.");
+        auto font_collection = com::make_unique(temporary_font_collection);
+
+        utility::utf16_buffer<> wfont_family { font_family };
+
+        UINT32 family_index = 0; BOOL exists = false;
+        hr = font_collection->FindFamilyName(utility::as_wide(wfont_family), &family_index, &exists);
+        if (FAILED(hr) || !exists) return software_renderer::get_font_advances();
+
+        IDWriteFontFamily* temporary_font_family;
+        hr = font_collection->GetFontFamily(family_index, &temporary_font_family);
+        if (FAILED(hr)) return software_renderer::get_font_advances();
+        auto family = com::make_unique(temporary_font_family);
+
+        IDWriteFont* temporary_font;
+        hr = family->GetFirstMatchingFont(
+            static_cast<DWRITE_FONT_WEIGHT>(weight), DWRITE_FONT_STRETCH_NORMAL, DWRITE_FONT_STYLE_NORMAL, &temporary_font
+        );
+        if (FAILED(hr)) return software_renderer::get_font_advances();
+        auto font = com::make_unique(temporary_font);
+
+        IDWriteFontFace* temporary_font_face;
+        hr = font->CreateFontFace(&temporary_font_face);
+        if (FAILED(hr)) return software_renderer::get_font_advances();
+        auto font_face = com::make_unique(temporary_font_face);
+
+        DWRITE_FONT_METRICS font_metrics;
+        font_face->GetMetrics(&font_metrics);
+
+        // ASCII and the ellipsis in one go, the ellipsis goes last.
+        std::array<UINT32, 129> code_points;
+        for (UINT32 i = 0; i < 128; ++i) code_points[i] = i;
+        code_points[128] = 0x2026;
+
+        std::array<UINT16, 129> glyph_indices;
+        hr = font_face->GetGlyphIndices(code_points.data(), static_cast<UINT32>(code_points.size()), glyph_indices.data());
+        if (FAILED(hr)) return software_renderer::get_font_advances();
+
+        std::array<DWRITE_GLYPH_METRICS, 129> glyph_metrics;
+        hr = font_face->GetDesignGlyphMetrics(glyph_indices.data(), static_cast<UINT32>(glyph_indices.size()), glyph_metrics.data(), false);
+        if (FAILED(hr)) return software_renderer::get_font_advances();
+
+        auto units_per_em = static_cast<float>(font_metrics.designUnitsPerEm);
+        auto to_em = [&](DWRITE_GLYPH_METRICS const& metrics) { return static_cast<float>(metrics.advanceWidth) / units_per_em; };
+
+        font_advances result;
+        for (std::size_t i = 0; i < 128; ++i) result.ascii[i] = to_em(glyph_metrics[i]);
+        result.ellipsis = glyph_indices[128] != 0 ? to_em(glyph_metrics[128]) : 3.0f * result.ascii['.'];
+
+        // Anything else is guessed at from the printable range.
+        auto printable_total = 0.0f;
+        for (std::size_t i = ' '; i < 127; ++i) printable_total += result.ascii[i];
+        result.fallback = printable_total / static_cast<float>(127 - ' ');
+
+        return result;
+
+    }
+
+    auto render_device::prefetch(resource::image const& image) -> void {
+        _image_loader.request(image);
+    }
+
+    auto render_device::set_image_ready_callback(std::function<void()> callback) -> void {
+        _image_loader.set_completion_callback(std::move(callback));
+    }
+
+    auto render_device::pin(resource::image const& image) -> void {
+        _texture_residency.pin(image.get_file_path());
+    }
+
+    auto render_device::unpin(resource::image const& image) -> void {
+
+        auto& file_path = image.get_file_path();
+        _texture_residency.unpin(file_path);
+
+        if (auto lookup_iterator = _image_records.find(file_path); lookup_iterator != _image_records.end()) {
+            for (auto level = 1u; level <= lookup_iterator->second.mip_levels; ++level) {
+                _texture_residency.unpin(get_variant_key(file_path, level));
+            }
+        }
+
+    }
+
+    auto render_device::set_texture_budget(std::uint64_t const budget_bytes) -> void {
+        _texture_residency.set_budget(budget_bytes);
+    }
+
+    auto render_device::upload_pending_images() -> bool {
+
+        _texture_residency.begin_frame();
+
+        _image_loader.drain_uploads([this](std::string const& filename, bitmap& pixels) {
+            upload_texture(filename, pixels);
+            upload_mip_levels(filename, pixels);
+            _upload_generation.fetch_add(1, std::memory_order_release);
+        });
+
+        return _image_loader.has_pending_uploads();
+
+    }
+
+    auto render_device::get_texture(resource::image const& image, float const effective_scale) -> std::optional<texture_region> {
+
+        auto& file_path = image.get_file_path();
+        auto& record = _image_records[file_path];
+        record.smallest_scale = std::min(record.smallest_scale, effective_scale);
+
+        if (!record.size) { _image_loader.request(image); return std::nullopt; }
+
+        auto level = select_mip_level(record.size->width, record.size->height, effective_scale);
+        auto texture = level > 0 ? find_resident_texture(get_variant_key(file_path, level)) : std::nullopt;
+
+        if (!texture) {
+
+            // Only the GPU copy is kept, so a missing level means decoding the image once more.
+            // The full image is drawn in the meantime.
+            if (level > 0 && _image_loader.get_state(file_path) == image_state::resident) _image_loader.forget(file_path);
+
+            _image_loader.request(image);
+            texture = find_resident_texture(file_path);
+
+        }
+
+        if (texture) texture->image_size = *record.size;
+        return texture;
+
+    }
+
+    auto render_device::get_image_size(resource::image const& image) const -> std::optional<measure::size<std::uint32_t>> {
+
+        auto lookup_iterator = _image_records.find(image.get_file_path());
+        return lookup_iterator != _image_records.end() ? lookup_iterator->second.size : std::nullopt;
+
+    }
+
+    auto render_device::find_resident_texture(std::string const& key) -> std::optional<texture_region> {
+
+        if (auto entry = _texture_atlas.find(key)) {
+            _texture_residency.touch(key);
+            auto& [origin, dimension] = entry->area;
+            return texture_region { _atlas_pages[entry->page].get(), D2D1::RectF(
+                static_cast<float>(origin.x), static_cast<float>(origin.y),
+                static_cast<float>(origin.x + dimension.width), static_cast<float>(origin.y + dimension.height)
+            ) };
+        }
+
+        auto lookup_iterator = _resident_textures_map.find(key);
+        if (lookup_iterator != _resident_textures_map.end()) {
+            _texture_residency.touch(key);
+            auto standalone_texture = lookup_iterator->second.get();
+            auto [width, height] = standalone_texture->GetPixelSize();
+            return texture_region { standalone_texture, D2D1::RectF(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)) };
+        }
+
+        return std::nullopt;
+
+    }
+
+    auto render_device::get_variant_key(std::string const& filename, std::uint32_t const level) -> std::string const& {
+
+        _variant_key.assign(filename);
+        _variant_key += "#mip";
+        _variant_key += std::to_string(level);
+
+        return _variant_key;
+
+    }
+
+    auto render_device::upload_texture(std::string const& key, bitmap const& pixels) -> void {
+
+        if (!upload_to_atlas(key, pixels)) {
+
+            auto properties = D2D1::BitmapProperties(
+                D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED), 96.0f, 96.0f
+            );
+
+            ID2D1Bitmap* temporary_bitmap;
+            auto hr = _resource_device_context_d2d1->CreateBitmap(
+                D2D1::SizeU(pixels.width, pixels.height), pixels.pixels.data(),
+                pixels.width * sizeof(std::uint32_t), properties, &temporary_bitmap
+            );
+
+            if (FAILED(hr)) return;
+            _resident_textures_map.insert_or_assign(key, com::make_unique(temporary_bitmap));
+
+        }
+
+        _texture_residency.add(key, pixels.byte_size());
+        CHROME_PROFILE_COUNTER("texture uploads", 1);
+
+    }
+
+    auto render_device::upload_mip_levels(std::string const& filename, bitmap const& pixels) -> void {
+
+        auto& record = _image_records[filename];
+        record.size = measure::size<std::uint32_t> { pixels.width, pixels.height };
+
+        // Every level down to the smallest one drawn so far, each built from the one before it.
+        auto levels = select_mip_level(pixels.width, pixels.height, record.smallest_scale);
+        auto pinned = _texture_residency.is_pinned(filename);
+
+        bitmap level_pixels;
+        for (auto level = 1u; level <= levels; ++level) {
+
+            level_pixels = downsample_half(level == 1 ? pixels : level_pixels);
+
+            auto& key = get_variant_key(filename, level);
+            upload_texture(key, level_pixels);
+            if (pinned) _texture_residency.pin(key);
+
+        }
+
+        record.mip_levels = std::max(record.mip_levels, levels);
+
+    }
+
+    auto render_device::upload_to_atlas(std::string const& key, bitmap const& pixels) -> bool {
+
+        auto entry = _texture_atlas.allocate(key, pixels.width, pixels.height);
+        if (!entry) return false;
+
+        synchronize_atlas_pages();
+
+        // The gutter goes up together with the image, filtering at its edges samples the image itself.
+        auto padding = _texture_atlas.get_padding();
+        auto padded_pixels = extrude_edges(pixels, padding);
+
+        auto& [origin, dimension] = entry->area;
+        auto destination = D2D1::RectU(
+            origin.x - padding, origin.y - padding,
+            origin.x + dimension.width + padding, origin.y + dimension.height + padding
+        );
+
+        auto hr = _atlas_pages[entry->page]->CopyFromMemory(
+            &destination, padded_pixels.pixels.data(), padded_pixels.width * sizeof(std::uint32_t)
+        );
+
+        if (FAILED(hr)) { _texture_atlas.release(key); return false; }
+        return true;
+
+    }
+
+    auto render_device::create_atlas_page(measure::size<std::uint32_t> const& size) -> com::unique_ptr<ID2D1Bitmap> {
+
+        auto properties = D2D1::BitmapProperties(
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED), 96.0f, 96.0f
+        );
+
+        ID2D1Bitmap* temporary_bitmap;
+        auto hr = _resource_device_context_d2d1->CreateBitmap(
+            D2D1::SizeU(size.width, size.height), nullptr, 0, properties, &temporary_bitmap
+        );
+
+        com::validate_result(hr, "Failed during the creation of an atlas page.");
+        return com::make_unique(temporary_bitmap);
+
+    }
+
+    auto render_device::synchronize_atlas_pages() -> void {
+
+        for (std::uint32_t page = 0; page < _texture_atlas.get_page_count(); ++page) {
+
+            auto size = _texture_atlas.get_page_size(page);
+
+            if (page == _atlas_pages.size()) { _atlas_pages.push_back(create_atlas_page(size)); continue; }
+
+            // Grown pages keep every entry in place, the old content is copied over as a whole.
+            auto current_size = _atlas_pages[page]->GetPixelSize();
+            if (current_size.width == size.width && current_size.height == size.height) continue;
+
+            auto grown_page = create_atlas_page(size);
+            auto origin = D2D1::Point2U(0, 0);
+            auto source = D2D1::RectU(0, 0, current_size.width, current_size.height);
+
+            auto hr = grown_page->CopyFromBitmap(&origin, _atlas_pages[page].get(), &source);
+            com::validate_result(hr, "Failed while growing an atlas page.");
+
+            _atlas_pages[page] = std::move(grown_page);
+
+        }
+
+    }
+
+    auto render_device::repack_atlas() -> void {
+
+        auto moves = _texture_atlas.repack();
+        auto padding = _texture_atlas.get_padding();
+
+        // Entries are copied into fresh pages, moving within a page could overwrite what's yet to move.
+        std::vector<com::unique_ptr<ID2D1Bitmap>> repacked_pages;
+        for (std::uint32_t page = 0; page < _texture_atlas.get_page_count(); ++page) {
+            repacked_pages.push_back(create_atlas_page(_texture_atlas.get_page_size(page)));
+        }
+
+        for (auto& [key, from, to] : moves) {
+
+            auto& [from_origin, dimension] = from.area;
+            auto destination = D2D1::Point2U(to.area.origin.x - padding, to.area.origin.y - padding);
+            auto source = D2D1::RectU(
+                from_origin.x - padding, from_origin.y - padding,
+                from_origin.x + dimension.width + padding, from_origin.y + dimension.height + padding
+            );
+
+            auto hr = repacked_pages[to.page]->CopyFromBitmap(&destination, _atlas_pages[from.page].get(), &source);
+            com::validate_result(hr, "Failed while repacking the texture atlas.");
+
+        }
+
+        _atlas_pages = std::move(repacked_pages);
+
+    }
+
+    auto render_device::evict_texture(std::string const& filename) -> void {
+
+        // Atlas space comes back with the next repack, standalone bitmaps are freed right away.
+        if (!_texture_atlas.release(filename)) _resident_textures_map.erase(filename);
+        _image_loader.forget(filename);
+
+    }
+
+    auto render_device::decode_image_file(std::string const& filename) -> std::optional<bitmap> {
+
+        // Runs on the decoder threads, each of them gets its own apartment and WIC factory.
+        thread_local auto com_initialized = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+        thread_local auto factory_wic = [] {
+            IWICImagingFactory* temporary_factory_wic = nullptr;
+            CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&temporary_factory_wic));
+            return com::make_unique(temporary_factory_wic);
+        }();
+
+        if (!com_initialized || !factory_wic) return std::nullopt;
+
+        utility::utf16_buffer<MAX_PATH> wfilename { filename };
+
+        IWICBitmapDecoder* temporary_bitmap_decoder;
+        auto hr = factory_wic->CreateDecoderFromFilename(
+            utility::as_wide(wfilename), nullptr, GENERIC_READ, 
+            WICDecodeOptions::WICDecodeMetadataCacheOnLoad, 
+            &temporary_bitmap_decoder
+        );
+        if (FAILED(hr)) return std::nullopt;
+        auto bitmap_decoder = com::make_unique<IWICBitmapDecoder>(temporary_bitmap_decoder);
+
+        IWICBitmapFrameDecode* temporary_frame_decode;
+        hr = bitmap_decoder->GetFrame(0, &temporary_frame_decode);
+        if (FAILED(hr)) return std::nullopt;
+        auto zero_frame = com::make_unique<IWICBitmapFrameDecode>(temporary_frame_decode);
+
+        WICPixelFormatGUID pixel_format;
+        hr = zero_frame->GetPixelFormat(&pixel_format);
+        if (FAILED(hr)) return std::nullopt;
+
+        UINT width, height;
+        zero_frame->GetSize(&width, &height);
+
+        auto pixels = bitmap { width, height };
+        auto copy_pixels = [&pixels, width](IWICBitmapSource* source) {
+            return source->CopyPixels(
+                nullptr, width * sizeof(std::uint32_t), static_cast<UINT>(pixels.byte_size()),
+                reinterpret_cast<BYTE*>(pixels.pixels.data())
+            );
+        };
+
+        // The 32 bit formats PNGs decode to are converted in place by the pixel kernels,
+        // everything else (palettes, 24 bit, 16 bit, ...) still goes through the WIC converter.
+        auto& pixel_kernels = kernels::get_kernels();
+        auto data = pixels.pixels.data(); auto count = pixels.pixels.size();
+
+        if (pixel_format == GUID_WICPixelFormat32bppPBGRA) {
+            hr = copy_pixels(zero_frame.get());
+        }
+        else if (pixel_format == GUID_WICPixelFormat32bppBGRA) {
+            hr = copy_pixels(zero_frame.get());
+            if (SUCCEEDED(hr)) pixel_kernels.premultiply(data, data, count);
+        }
+        else if (pixel_format == GUID_WICPixelFormat32bppRGBA) {
+            hr = copy_pixels(zero_frame.get());
+            if (SUCCEEDED(hr)) { pixel_kernels.swizzle_rgba_to_bgra(data, data, count); pixel_kernels.premultiply(data, data, count); }
+        }
+        else if (pixel_format == GUID_WICPixelFormat32bppPRGBA) {
+            hr = copy_pixels(zero_frame.get());
+            if (SUCCEEDED(hr)) pixel_kernels.swizzle_rgba_to_bgra(data, data, count);
+        }
+        else {
+
+            IWICFormatConverter* temporary_format_converter;
+            hr = factory_wic->CreateFormatConverter(&temporary_format_converter);
+            if (FAILED(hr)) return std::nullopt;
+            auto format_converter = com::make_unique<IWICFormatConverter>(temporary_format_converter);
+
+            hr = format_converter->Initialize(
+                zero_frame.get(), GUID_WICPixelFormat32bppPBGRA, 
+                WICBitmapDitherTypeNone, nullptr, 0.0f, 
+                WICBitmapPaletteTypeMedianCut
+            );
+            if (FAILED(hr)) return std::nullopt;
+
+            hr = copy_pixels(format_converter.get());
+
+        }
+
+        if (FAILED(hr)) return std::nullopt;
+        return pixels;
+
+    }
+
+}
@@ -0,0 +1,176 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <d2d1.h>
+#include <dwrite.h>
+#include <d3d11.h>
+#include <dxgi.h>
+#include <dcomp.h>
+#include <wincodec.h>
+#include <unordered_map>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <utility/measure.hpp>
+#include <utility/startup_timeline.hpp>
+#include <graphics/image.hpp>
+#include <graphics/font.hpp>
+#include <graphics/text_cache.hpp>
+#include <graphics/image_loader.hpp>
+#include <graphics/texture_atlas.hpp>
+#include <graphics/texture_residency.hpp>
+#include <graphics/image_scaling.hpp>
+#include <graphics/bitmap.hpp>
+#include <com/memory.hpp>
+
+// Everything the windows of the application share: the D3D, D2D, DWrite and DComp devices, uploaded
+// images and text formats and layouts. A renderer per window only adds its composition target and layer
+// surfaces on top, so opening another window doesn't create or upload anything twice.
+//
+// None of it is thread safe on its own. The render thread holds the lock while it renders and commits, not while
+// it waits for the compositor. Anything else touching the device (attaching or dropping a window) takes it as well.
+
+namespace chrome::graphics {
+
+    struct render_device {
+
+        // Phases of bringing the devices up go to the timeline, if there is one.
+        explicit render_device(utility::startup_timeline* timeline = nullptr);
+
+        render_device(render_device const&) = delete;
+        render_device(render_device&&)      = delete;
+
+        render_device& operator=(render_device const&)  = delete;
+        render_device& operator=(render_device&&)       = delete;
+
+        ~render_device() = default;
+
+        auto lock() { return std::unique_lock { _mutex }; }
+
+        // Commits the composition changes of every window at once, then trims textures over budget.
+        auto commit() -> void;
+
+        // Blocks until the compositor picked up the last commit, paces the render thread to the compositor.
+        // Safe without the lock, DirectComposition devices are thread safe themselves.
+        auto wait_for_commit_completion() -> void;
+
+        // Starts decoding ahead of the first draw, so startup and first paint don't wait on it.
+        auto prefetch(resource::image const& image) -> void;
+
+        // Called from decoder threads when an image can be uploaded, marshal to the UI thread from there.
+        auto set_image_ready_callback(std::function<void()> callback) -> void;
+
+        // Call at frame start, uploads a bounded number of decoded images.
+        // Returns true if more are waiting for the next frame.
+        auto upload_pending_images() -> bool;
+
+        // Bumped by every upload, windows that drew before it repaint to pick the images up. Safe without the lock.
+        auto get_upload_generation() const { return _upload_generation.load(std::memory_order_acquire); }
+
+        // Pinned images stay resident no matter the budget, for things that are always on screen.
+        auto pin(resource::image const& image) -> void;
+        auto unpin(resource::image const& image) -> void;
+
+        // Images not drawn recently are evicted at commit once uploads exceed this, and decoded again when needed.
+        auto set_texture_budget(std::uint64_t const budget_bytes) -> void;
+
+        // Either an atlas page and the image's area on it, or a standalone bitmap covering all of it.
+        // The source area can belong to a mip level, the draw is still sized after the full image.
+        struct texture_region {
+            ID2D1Bitmap* bitmap;
+            D2D1_RECT_F source;
+            measure::size<std::uint32_t> image_size {};
+        };
+
+        // Picks the mip level closest to the on screen size, falls back to the full image while it's built.
+        auto get_texture(resource::image const& image, float const effective_scale) -> std::optional<texture_region>;
+
+        // Known once the image has been decoded, evictions don't forget it.
+        auto get_image_size(resource::image const& image) const -> std::optional<measure::size<std::uint32_t>>;
+
+        // Laid out in an unconstrained box, cached across frames and windows.
+        auto get_text_layout(
+            std::string_view text, std::string_view font_family, float const font_size, font_weight const weight
+        ) -> IDWriteTextLayout*;
+
+        // Design advances of the first matching system font, for fitting labels without laying them out.
+        // A family that isn't installed gets the software renderer's advances, DWrite falls back to something similar.
+        auto get_font_advances(std::string_view font_family, font_weight const weight) -> font_advances;
+
+        auto get_composition_device() const { return _device_dcomp.get(); }
+        auto get_brush() const { return _brush.get(); }
+
+        auto& get_text_cache() const { return _text_cache; }
+        auto& get_image_loader() const { return _image_loader; }
+        auto& get_texture_atlas() const { return _texture_atlas; }
+        auto& get_texture_residency() const { return _texture_residency; }
+
+    private:
+
+        // Layout box used for labels, large enough to never wrap.
+        static constexpr auto unconstrained_text_extent = 5000.0f;
+
+        // What's known about an image across evictions, the size picks the mip level before anything is resident.
+        struct image_record {
+            std::optional<measure::size<std::uint32_t>> size;
+            float smallest_scale = 1.0f;    // Deepest mip level wanted so far, built with the next upload.
+            std::uint32_t mip_levels = 0;
+        };
+
+        // Waits for the worker creating it the first time.
+        auto get_dwrite_factory() -> IDWriteFactory*;
+
+        auto find_resident_texture(std::string const& key) -> std::optional<texture_region>;
+        auto get_variant_key(std::string const& filename, std::uint32_t const level) -> std::string const&;
+
+        auto upload_texture(std::string const& key, bitmap const& pixels) -> void;
+        auto upload_mip_levels(std::string const& filename, bitmap const& pixels) -> void;
+        auto upload_to_atlas(std::string const& key, bitmap const& pixels) -> bool;
+        auto create_atlas_page(measure::size<std::uint32_t> const& size) -> com::unique_ptr<ID2D1Bitmap>;
+        auto synchronize_atlas_pages() -> void;
+        auto repack_atlas() -> void;
+        auto evict_texture(std::string const& filename) -> void;
+
+        static auto decode_image_file(std::string const& filename) -> std::optional<bitmap>;
+
+        com::unique_ptr<ID3D11Device>           _device_d3d11;
+        com::unique_ptr<ID3D11DeviceContext>    _device_context_d3d11;
+        com::unique_ptr<IDWriteFactory>         _factory_dwrite;
+        std::future<com::unique_ptr<IDWriteFactory>> _pending_factory_dwrite;
+
+        com::unique_ptr<ID2D1Device>            _device_d2d1;
+        com::unique_ptr<ID2D1DeviceContext>     _resource_device_context_d2d1;
+
+        com::unique_ptr<ID2D1SolidColorBrush>   _brush;
+
+        com::unique_ptr<IDCompositionDesktopDevice> _device_dcomp;
+
+        // Images too large for an atlas page.
+        std::unordered_map<std::string, com::unique_ptr<ID2D1Bitmap>> _resident_textures_map;
+
+        texture_atlas _texture_atlas;
+        std::vector<com::unique_ptr<ID2D1Bitmap>> _atlas_pages;
+
+        texture_residency _texture_residency;
+
+        std::unordered_map<std::string, image_record> _image_records;
+        std::string _variant_key; // Reused, so looking up a mip level doesn't allocate.
+        std::atomic<std::uint64_t> _upload_generation { 0 };
+
+        std::mutex _mutex;
+
+        text_cache<com::unique_ptr<IDWriteTextFormat>, com::unique_ptr<IDWriteTextLayout>> _text_cache;
+
+        image_loader _image_loader { decode_image_file };
+
+    };
+
+}
@@ -1,155 +1,260 @@
-#include <array>
+#include <algorithm>
 
 #include <graphics/renderer.hpp>
 #include <com/runtime_validation.hpp>
-#include <utility/string_conversion.hpp>
+#include <utility/profiler.hpp>
 
 namespace chrome::graphics {
 
-    renderer::renderer() {
+    renderer::renderer(render_device& device) : _device(&device) {
 
-        std::uint32_t flags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
-#if defined(_DEBUG)
-        flags |= D3D11_CREATE_DEVICE_DEBUG;
-#endif
+        IDCompositionVisual2* temporary_visual;
+        auto hr = _device->get_composition_device()->CreateVisual(&temporary_visual);
+        com::validate_result(hr, "Failed during the creation of the window's root visual.");
+        _primary_visual_dcomp = com::make_unique(temporary_visual);
 
-        std::array requested_levels { 
-            D3D_FEATURE_LEVEL_12_1, D3D_FEATURE_LEVEL_12_0, 
-            D3D_FEATURE_LEVEL_11_1, D3D_FEATURE_LEVEL_11_0,
-        };
+    }
 
-        D3D_FEATURE_LEVEL received_feature_level; // Any will do in this scenario.
-        ID3D11Device* temporary_device; ID3D11DeviceContext* temporary_context;
+    auto renderer::attach_to_window(HWND window_handle) -> void {
 
-        auto hr = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr,
-            flags, requested_levels.data(), static_cast<std::uint32_t>(requested_levels.size()),
-            D3D11_SDK_VERSION, &temporary_device, &received_feature_level, &temporary_context
-        );
+        _associated_window = window_handle;
+        _dpi_x = _dpi_y = static_cast<float>(GetDpiForWindow(window_handle));
 
-        com::validate_result(hr, "Failed during creation of the D3D11 device.");
-        _device_context_d3d11 = com::make_unique(temporary_context);
-        _device_d3d11 = com::make_unique(temporary_device);
-
-        ID2D1Factory* temporary_factory;
-        hr = D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, &temporary_factory);
-        com::validate_result(hr, "Failed during creation of the D2D1 factory.");
-        _factory_d2d1 = com::make_unique(temporary_factory);
-        
-        auto pixel_format = D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED);
-
-        IDWriteFactory* temporary_factory_dwrite;
-        hr = DWriteCreateFactory(
-            DWRITE_FACTORY_TYPE_ISOLATED, __uuidof(IDWriteFactory), 
-            reinterpret_cast<IUnknown**>(&temporary_factory_dwrite)
-        );
+        IDCompositionTarget* temporary_target;
+        auto hr = _device->get_composition_device()->CreateTargetForHwnd(window_handle, true, &temporary_target);
+        com::validate_result(hr, "Failed during creation of the DComp window target.");
+        _window_target_dcomp = com::make_unique(temporary_target);
+        _window_target_dcomp->SetRoot(_primary_visual_dcomp.get());
 
-        com::validate_result(hr, "Failed during the creation of the DWrite factory.");
-        _factory_dwrite = com::make_unique(temporary_factory_dwrite);
+    }
 
-        com::validate_result(CoInitialize(nullptr), "Failed to CoInitialize.");
+    auto renderer::render_layers(layer_tree const& layers) -> void {
 
-        IWICImagingFactory* temporary_factory_wic;
-        hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&temporary_factory_wic));
-        com::validate_result(hr, "Failed during the creation of the WIC factory.");
-        _factory_wic = com::make_unique(temporary_factory_wic);
+        CHROME_PROFILE_ZONE("render_layers");
 
-        IDXGIDevice* temporary_device_dxgi;
-        _device_d3d11->QueryInterface<IDXGIDevice>(&temporary_device_dxgi);
-        auto device_dxgi = com::make_unique<IDXGIDevice>(temporary_device_dxgi);
+        auto scale = _dpi_x / 96.0f;
 
-        auto creation_properties = D2D1::CreationProperties(
-            D2D1_THREADING_MODE_SINGLE_THREADED, D2D1_DEBUG_LEVEL_INFORMATION, D2D1_DEVICE_CONTEXT_OPTIONS_NONE
-        );
+        // Anything shown stretched since the last redraw is drawn at its real size again.
+        if (_is_presenting_resized) {
+            _primary_visual_dcomp->SetTransform(D2D1::Matrix3x2F::Identity());
+            _is_presenting_resized = false;
+        }
 
-        ID2D1Device* temporary_device_d2d1;
-        hr = D2D1CreateDevice(device_dxgi.get(), creation_properties, &temporary_device_d2d1);
-        _device_d2d1 = com::make_unique(temporary_device_d2d1);
-        com::validate_result(hr, "Failed during the creation of the D2D1 device.");
-
-        ID2D1DeviceContext* temporary_device_context_d2d1;
-        hr = _device_d2d1->CreateDeviceContext(D2D1_DEVICE_CONTEXT_OPTIONS_NONE, &temporary_device_context_d2d1);
-        com::validate_result(hr, "Failed during the creation of the resource creating D2D1 device context.");
-        _resource_device_context_d2d1 = com::make_unique(temporary_device_context_d2d1);
-        _resource_device_context_d2d1->SetDpi(_dpi_x, _dpi_x);
-
-        IDCompositionDesktopDevice* temporary_device_dcomp;
-        hr = DCompositionCreateDevice2(_device_d2d1.get(), IID_PPV_ARGS(&temporary_device_dcomp));
-        com::validate_result(hr, "Failed during the creation of the DComp device.");
-        _device_dcomp = com::make_unique(temporary_device_dcomp);
-        
-        IDCompositionVisual2* temporary_visual;
-        _device_dcomp->CreateVisual(&temporary_visual);
-        _primary_visual_dcomp = com::make_unique(temporary_visual);
+        for (auto id : layers.get_removed()) {
+            if (auto lookup_iterator = _layer_visuals.find(id); lookup_iterator != _layer_visuals.end()) {
+                _primary_visual_dcomp->RemoveVisual(lookup_iterator->second.visual.get());
+                _layer_visuals.erase(lookup_iterator);
+            }
+        }
+
+        auto& draw_order = layers.get_draw_order();
+
+        // Reordering is rare, re-adding everything is simpler than working out the moves.
+        // No reference visual and not inserting above puts each one on top of the previous.
+        if (layers.has_order_changed()) {
+            _primary_visual_dcomp->RemoveAllVisuals();
+            for (auto id : draw_order) _primary_visual_dcomp->AddVisual(get_layer_visual(id).visual.get(), FALSE, nullptr);
+        }
+
+        for (auto id : draw_order) {
+
+            auto& layer = layers.get(id);
+            auto& entry = get_layer_visual(id);
+            auto& [visual, surface, surface_size, content_extent] = entry;
+
+            if (layer.content_changed) {
+
+                content_extent = {
+                    static_cast<std::uint32_t>(std::ceil(layer.content_size.width * scale)),
+                    static_cast<std::uint32_t>(std::ceil(layer.content_size.height * scale))
+                };
+
+                // Sized in buckets, a resize drag mostly lands within the surface it already has.
+                auto size = get_surface_size(surface_size, content_extent, _is_live_resizing);
+
+                if (content_extent.width > 0 && content_extent.height > 0 && !surface) {
+
+                    IDCompositionVirtualSurface* temporary_surface;
+                    auto hr = _device->get_composition_device()->CreateVirtualSurface(
+                        size.width, size.height, DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_ALPHA_MODE_PREMULTIPLIED, &temporary_surface
+                    );
 
-        _transforms.emplace(D2D1::Matrix3x2F::Identity());
+                    com::validate_result(hr, "Failed during the creation of a layer surface.");
+                    surface = com::make_unique(temporary_surface);
+                    visual->SetContent(surface.get());
+                    surface_size = size;
 
-        ID2D1SolidColorBrush* temporary_brush;
-        _resource_device_context_d2d1->CreateSolidColorBrush(D2D1::ColorF(1.0f, 1.0f, 1.0f), &temporary_brush);
-        _brush = com::make_unique(temporary_brush);
+                }
+                else if (surface && (size.width != surface_size.width || size.height != surface_size.height)) {
+                    surface->Resize(size.width, size.height);
+                    surface_size = size;
+                }
+
+            }
+
+            if (layer.geometry_changed) {
+
+                // Whole pixel offsets, so layers stay as sharp as the single surface was.
+                auto bounds = layers.get_absolute_bounds(id);
+                auto visible = layers.get_visible_bounds(id);
+                auto offset_x = std::round(bounds.origin.x * scale), offset_y = std::round(bounds.origin.y * scale);
+
+                visual->SetOffsetX(offset_x);
+                visual->SetOffsetY(offset_y);
+                visual->SetClip(D2D1::RectF(
+                    std::round(visible.origin.x * scale) - offset_x, std::round(visible.origin.y * scale) - offset_y,
+                    std::round(visible.right() * scale) - offset_x, std::round(visible.bottom() * scale) - offset_y
+                ));
+
+            }
+
+            if (!surface || content_extent.width == 0 || content_extent.height == 0) continue;
+
+            // Only the content is drawn, the rest of an over-allocated surface is never shown.
+            auto content_area = measure::rectangle<std::int32_t> {
+                0, 0, static_cast<std::int32_t>(content_extent.width), static_cast<std::int32_t>(content_extent.height)
+            };
+
+            auto draw = [&](measure::rectangle<std::int32_t> const& area) {
+
+                auto update_area = measure::intersect(area, content_area);
+                if (update_area.is_empty()) return;
+
+                begin_draw(entry.surface.get(), update_area);
+                execute(*layer.commands);
+                end_draw(entry.surface.get());
+
+            };
+
+            if (layer.content_changed) { draw(content_area); continue; }
+
+            for (auto& damaged : layer.damage.get_rectangles()) {
+
+                // Snap outwards to whole pixels, so antialiased edges are covered too.
+                auto left = static_cast<std::int32_t>(std::floor(damaged.origin.x * scale));
+                auto top = static_cast<std::int32_t>(std::floor(damaged.origin.y * scale));
+                auto right = static_cast<std::int32_t>(std::ceil(damaged.right() * scale));
+                auto bottom = static_cast<std::int32_t>(std::ceil(damaged.bottom() * scale));
+
+                draw({ left, top, right - left, bottom - top });
+
+            }
+
+        }
 
     }
 
-    auto renderer::attach_to_window(HWND window_handle) -> void {
+    auto renderer::set_live_resize(bool const is_live_resizing) -> void {
 
-        _associated_window = window_handle;
-        _dpi_x = _dpi_y = static_cast<float>(GetDpiForWindow(window_handle));
+        _is_live_resizing = is_live_resizing;
+        if (is_live_resizing) return;
 
-        IDCompositionTarget* temporary_target;
-        auto hr = _device_dcomp->CreateTargetForHwnd(window_handle, true, &temporary_target);
-        com::validate_result(hr, "Failed during creation of the DComp window target.");
-        _window_target_dcomp = com::make_unique(temporary_target);
-        _window_target_dcomp->SetRoot(_primary_visual_dcomp.get());
+        // Shrinking keeps what's inside the new size, so trimming needs no redraw.
+        for (auto& [id, entry] : _layer_visuals) {
 
-        RECT window_rectangle;
-        GetClientRect(_associated_window, &window_rectangle);
+            if (!entry.surface) continue;
 
-        IDCompositionVirtualSurface* temporary_surface;
-        _device_dcomp->CreateVirtualSurface(
-            window_rectangle.right, window_rectangle.bottom,
-            DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_ALPHA_MODE_PREMULTIPLIED,
-            &temporary_surface
-        );
+            auto size = get_surface_size(entry.surface_size, entry.content_extent, false);
+            if (size.width == entry.surface_size.width && size.height == entry.surface_size.height) continue;
 
-        _window_surface_dcomp = com::make_unique(temporary_surface);
-        _primary_visual_dcomp->SetContent(_window_surface_dcomp.get());
+            entry.surface->Resize(size.width, size.height);
+            entry.surface_size = size;
+
+        }
+
+    }
+
+    auto renderer::present_resized(measure::size<float> const& frame_size, measure::size<float> const& client_size) -> void {
+
+        if (frame_size.width <= 0.0f || frame_size.height <= 0.0f) return;
+
+        // Growing stretches the last frame so no uncovered area shows, shrinking leaves it to the window to clip.
+        auto scale_x = std::max(1.0f, client_size.width / frame_size.width);
+        auto scale_y = std::max(1.0f, client_size.height / frame_size.height);
+
+        _primary_visual_dcomp->SetTransform(D2D1::Matrix3x2F::Scale(scale_x, scale_y));
+        _is_presenting_resized = true;
+
+    }
+
+    auto renderer::get_layer_visual(layer_id const id) -> layer_visual& {
+
+        auto& entry = _layer_visuals[id];
+        if (entry.visual) return entry;
+
+        IDCompositionVisual2* temporary_visual;
+        auto hr = _device->get_composition_device()->CreateVisual(&temporary_visual);
+        com::validate_result(hr, "Failed during the creation of a layer visual.");
+        entry.visual = com::make_unique(temporary_visual);
+
+        return entry;
 
     }
 
-    auto renderer::begin_draw() -> void {
+    auto renderer::begin_draw(IDCompositionVirtualSurface* surface, measure::rectangle<std::int32_t> const& update_area) -> void {
+
+        auto& [origin, dimension] = update_area;
+        RECT update_rectangle { origin.x, origin.y, origin.x + dimension.width, origin.y + dimension.height };
+
+        CHROME_PROFILE_ZONE("BeginDraw");
 
         ID2D1DeviceContext* temporary_device_context_d2d1; POINT offset = {};
-        _window_surface_dcomp->BeginDraw(nullptr, IID_PPV_ARGS(&temporary_device_context_d2d1), &offset);
+        auto hr = surface->BeginDraw(&update_rectangle, IID_PPV_ARGS(&temporary_device_context_d2d1), &offset);
+        com::validate_result(hr, "Failed to begin drawing into the DComp surface.");
         _device_context_d2d1 = com::make_unique(temporary_device_context_d2d1);
         _device_context_d2d1->SetDpi(_dpi_x, _dpi_y);
-        auto offsetX = static_cast<float>(offset.x);
-        auto offsetY = static_cast<float>(offset.y);
 
-        push_transform(D2D1::Matrix3x2F::Translation(
+        // The update rectangle is handed out at offset, shift everything so we keep drawing in surface coordinates.
+        auto offsetX = static_cast<float>(offset.x - origin.x);
+        auto offsetY = static_cast<float>(offset.y - origin.y);
+
+        push_transform(transform::translation(
             offsetX * 96.0f / _dpi_x, offsetY * 96.0f / _dpi_y
         ));
 
+        // Everything outside the update rectangle keeps its previous content.
+        auto clip_area = measure::rectangle<float> {
+            static_cast<float>(origin.x) * 96.0f / _dpi_x, static_cast<float>(origin.y) * 96.0f / _dpi_y,
+            static_cast<float>(dimension.width) * 96.0f / _dpi_x, static_cast<float>(dimension.height) * 96.0f / _dpi_y
+        };
+
+        _device_context_d2d1->PushAxisAlignedClip(D2D1::RectF(
+            clip_area.origin.x, clip_area.origin.y, clip_area.right(), clip_area.bottom()
+        ), D2D1_ANTIALIAS_MODE_ALIASED);
+
+        // The clip goes through the offset like everything else, draws are culled against where it lands.
+        _culler.set_cull_area(measure::transform_bounds(_transforms.top(), clip_area));
+
         _device_context_d2d1->Clear(D2D1::ColorF(0.0f, 0.0f, 0.0, 0.0f));
 
     }
 
-    auto renderer::end_draw() -> void {
+    auto renderer::end_draw(IDCompositionVirtualSurface* surface) -> void {
 
+        _device_context_d2d1->PopAxisAlignedClip();
         clear_transforms();
 
-        _window_surface_dcomp->EndDraw();
-        // _device_dcomp->WaitForCommitCompletion(); // Uncomment if you care about trailing while resizing
-        _device_dcomp->Commit();
+        CHROME_PROFILE_ZONE("EndDraw");
+        surface->EndDraw();
+
+    }
 
+    auto renderer::commit() -> void {
+        _device->commit();
     }
 
     auto renderer::fill_rectangle(measure::rectangle<float> const& fill_area, measure::color const& fill_color) -> void {
 
-        _brush->SetColor(D2D1::ColorF(fill_color.r, fill_color.g, fill_color.b, fill_color.a));
+        if (!_culler.accept(_transforms.top(), fill_area)) return;
+        CHROME_PROFILE_COUNTER("draw calls", 1);
+
+        CHROME_PROFILE_COUNTER("state changes", 1);
+        _device->get_brush()->SetColor(D2D1::ColorF(fill_color.r, fill_color.g, fill_color.b, fill_color.a));
 
         auto& [origin, dimension] = fill_area;
         auto& [x, y] = origin; auto [w, h] = dimension;
 
-        _device_context_d2d1->FillRectangle(D2D1::RectF(x, y, x + w, y + h), _brush.get());
+        _device_context_d2d1->FillRectangle(D2D1::RectF(x, y, x + w, y + h), _device->get_brush());
 
     }
 
@@ -158,126 +263,107 @@ namespace chrome::graphics {
         float const stroke_width, measure::color const& stroke_color
     ) -> void {
 
+        if (!_culler.accept(_transforms.top(), get_line_bounds(start_point, end_point, stroke_width))) return;
+        CHROME_PROFILE_COUNTER("draw calls", 1);
+
         auto& [r, g, b, a] = stroke_color;
-        _brush->SetColor(D2D1::ColorF(r, g, b, a));
+        CHROME_PROFILE_COUNTER("state changes", 1);
+        _device->get_brush()->SetColor(D2D1::ColorF(r, g, b, a));
 
         auto& p = start_point; auto& q = end_point;
 
         _device_context_d2d1->DrawLine(
             D2D1::Point2F(p.x, p.y), D2D1::Point2F(q.x, q.y), 
-            _brush.get(), stroke_width
+            _device->get_brush(), stroke_width
         );
 
     }
 
     auto renderer::draw_image(resource::image const* image, float scale, measure::point<float> const& top_left, float const opacity) -> void {
 
-        auto resident_texture = get_texture(image->get_file_path());
-        auto dimensions = resident_texture->GetSize();
+        auto& current_transform = _transforms.top();
+
+        // The size is known once the image has been decoded, until then get_texture has nothing to draw anyway.
+        if (auto size = _device->get_image_size(*image)) {
+            auto& [width, height] = *size;
+            auto image_area = measure::rectangle<float> { top_left, { static_cast<float>(width) * scale, static_cast<float>(height) * scale } };
+            if (!_culler.accept(current_transform, image_area)) return;
+        }
 
+        // How large the image ends up on screen, in pixels per source pixel.
+        auto effective_scale = scale * current_transform.get_scale() * _dpi_x / 96.0f;
+
+        // Images still being decoded are skipped, the window repaints once they're uploaded.
+        auto texture = _device->get_texture(*image, effective_scale);
+        if (!texture) return;
+
+        auto& [texture_bitmap, source, image_size] = *texture;
         auto& [x, y] = top_left;
-        auto& [width, height] = dimensions;
+        auto& [width, height] = image_size;
 
+        // Consecutive draws out of the same atlas page don't switch bitmaps, D2D batches them.
+        CHROME_PROFILE_COUNTER("draw calls", 1);
         _device_context_d2d1->DrawBitmap(
-            resident_texture, D2D1::RectF(x, y, x + width * scale, y + height * scale),
-            opacity, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR
+            texture_bitmap, D2D1::RectF(x, y, x + static_cast<float>(width) * scale, y + static_cast<float>(height) * scale),
+            opacity, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR, &source
         );
 
     }
 
     auto renderer::draw_text(
-        std::string const& text, measure::point<float> const& top_left, std::string const& font_family,
-        float const font_size, measure::color const& text_color, DWRITE_FONT_WEIGHT const font_weight
+        std::string_view text, measure::point<float> const& top_left, std::string_view font_family,
+        float const font_size, measure::color const& text_color, font_weight const weight
     ) -> void {
 
-        auto wtext = utility::convert_utf8_to_utf16(text);
-        auto wfont_family = utility::convert_utf8_to_utf16(font_family);
+        auto text_layout = _device->get_text_layout(text, font_family, font_size, weight);
 
-        IDWriteTextFormat* temporary_text_format;
-        _factory_dwrite->CreateTextFormat(
-            wfont_family.c_str(), nullptr, font_weight, DWRITE_FONT_STYLE_NORMAL,
-            DWRITE_FONT_STRETCH_NORMAL, font_size, L"en_US", &temporary_text_format
-        );
+        // The layout box is unconstrained, the metrics say where the text actually is. Half an em on
+        // each side covers overhangs of italics and accents.
+        DWRITE_TEXT_METRICS metrics;
+        if (SUCCEEDED(text_layout->GetMetrics(&metrics))) {
 
-        auto text_format = com::make_unique(temporary_text_format);
+            auto margin = 0.5f * font_size;
+            auto text_area = measure::rectangle<float> {
+                top_left.x + metrics.left - margin, top_left.y + metrics.top - margin,
+                metrics.widthIncludingTrailingWhitespace + 2.0f * margin, metrics.height + 2.0f * margin
+            };
 
-        _brush->SetColor(D2D1::ColorF(text_color.r, text_color.g, text_color.b, text_color.a));
-        _device_context_d2d1->DrawTextW(wtext.c_str(), static_cast<UINT32>(wtext.size()), text_format.get(),
-            D2D1::RectF(top_left.x, top_left.y, 5000.f, 5000.f), _brush.get()
-        );
+            if (!_culler.accept(_transforms.top(), text_area)) return;
 
-    }
-
-    auto renderer::push_transform(D2D1::Matrix3x2F const& transform) -> void {
+        }
 
-        auto& previous_transform = _transforms.top();
-        _transforms.emplace(previous_transform * transform);
-        _device_context_d2d1->SetTransform(_transforms.top());
+        CHROME_PROFILE_COUNTER("state changes", 1);
+        _device->get_brush()->SetColor(D2D1::ColorF(text_color.r, text_color.g, text_color.b, text_color.a));
+        CHROME_PROFILE_COUNTER("draw calls", 1);
+        _device_context_d2d1->DrawTextLayout(D2D1::Point2F(top_left.x, top_left.y), text_layout, _device->get_brush());
 
     }
 
-    auto renderer::pop_transform() -> void {
+    auto renderer::push_transform(transform const& transform) -> void {
 
-        _transforms.pop();
-        _device_context_d2d1->SetTransform(_transforms.top());
+        auto& [m11, m12, m21, m22, dx, dy] = _transforms.push(transform);
+        _device_context_d2d1->SetTransform(D2D1::Matrix3x2F(m11, m12, m21, m22, dx, dy));
+        CHROME_PROFILE_COUNTER("state changes", 1);
 
     }
 
-    auto renderer::resize_buffers() -> void {
-
-        RECT window_rectangle;
-        GetClientRect(_associated_window, &window_rectangle);
-
-        _window_surface_dcomp->Resize(window_rectangle.right, window_rectangle.bottom);
-
-    }
-
-    auto renderer::clear_transforms() -> void {
+    auto renderer::pop_transform() -> void {
 
-        _transforms = {}; _transforms.emplace(D2D1::Matrix3x2F::Identity());
-        _device_context_d2d1->SetTransform(_transforms.top());
+        auto& [m11, m12, m21, m22, dx, dy] = _transforms.pop();
+        _device_context_d2d1->SetTransform(D2D1::Matrix3x2F(m11, m12, m21, m22, dx, dy));
+        CHROME_PROFILE_COUNTER("state changes", 1);
 
     }
 
-    auto renderer::get_texture(std::string const& filename) -> ID2D1Bitmap* {
-
-        auto lookup_iterator = _resident_textures_map.find(filename);
-        return lookup_iterator != _resident_textures_map.end() ? lookup_iterator->second.get() : load_image_into_pool(filename);
-
+    auto renderer::execute(command_list const& commands) -> void {
+        commands.replay(*this);
     }
 
-    auto renderer::load_image_into_pool(std::string const& filename) -> ID2D1Bitmap* {
-
-        auto wfilename = utility::convert_utf8_to_utf16(filename);
-
-        IWICBitmapDecoder* temporary_bitmap_decoder;
-        _factory_wic->CreateDecoderFromFilename(
-            wfilename.c_str(), nullptr, GENERIC_READ, 
-            WICDecodeOptions::WICDecodeMetadataCacheOnLoad, 
-            &temporary_bitmap_decoder
-        );
-        auto bitmap_decoder = com::make_unique<IWICBitmapDecoder>(temporary_bitmap_decoder);
-
-        IWICBitmapFrameDecode* temporary_frame_decode;
-        bitmap_decoder->GetFrame(0, &temporary_frame_decode);
-        auto zero_frame = com::make_unique<IWICBitmapFrameDecode>(temporary_frame_decode);
-
-        IWICFormatConverter* temporary_format_converter;
-        _factory_wic->CreateFormatConverter(&temporary_format_converter);
-        auto format_converter = com::make_unique<IWICFormatConverter>(temporary_format_converter);
-
-        format_converter->Initialize(
-            zero_frame.get(), GUID_WICPixelFormat32bppPBGRA, 
-            WICBitmapDitherTypeNone, nullptr, 0.0f, 
-            WICBitmapPaletteTypeMedianCut
-        );
-
-        ID2D1Bitmap* temporary_bitmap;
-        _resource_device_context_d2d1->CreateBitmapFromWicBitmap(format_converter.get(), &temporary_bitmap);
-        _resident_textures_map.emplace(filename, temporary_bitmap);
+    auto renderer::clear_transforms() -> void {
 
-        return temporary_bitmap;
+        _transforms.reset();
+        _device_context_d2d1->SetTransform(D2D1::Matrix3x2F::Identity());
 
     }
 
-}
\ No newline at end of file
+}
@@ -4,32 +4,55 @@
 #pragma once
 
 #include <d2d1.h>
-#include <dwrite.h>
-#include <d3d11.h>
-#include <dxgi.h>
 #include <dcomp.h>
-#include <wincodec.h>
 #include <unordered_map>
-#include <string>
+#include <string_view>
 #include <cmath>
-#include <stack>
 
 #include <utility/measure.hpp>
 #include <graphics/image.hpp>
+#include <graphics/font.hpp>
+#include <graphics/transform.hpp>
+#include <graphics/command_list.hpp>
+#include <graphics/draw_culler.hpp>
+#include <graphics/layer_tree.hpp>
+#include <graphics/surface_sizing.hpp>
+#include <graphics/render_device.hpp>
 #include <com/memory.hpp>
 
 namespace chrome::graphics {
 
-    // Just a simple renderer.
+    // Just a simple renderer, one per window. Devices, textures and text come from the shared render_device,
+    // only the composition target and the layer visuals and surfaces belong to the window.
     struct renderer {
 
-        renderer();
+        explicit renderer(render_device& device);
+
+        renderer(renderer const&) = delete;
+        renderer(renderer&&)      = delete;
+
+        renderer& operator=(renderer const&)  = delete;
+        renderer& operator=(renderer&&)       = delete;
+
+        ~renderer() = default;
 
         auto attach_to_window(HWND window_handle) -> void;
 
-        auto begin_draw() -> void;
+        // Brings the window's visuals in line with the layer tree. Every layer gets its own visual and
+        // surface: moved or clipped layers are only repositioned, changed ones are redrawn in full and
+        // damaged ones only where damaged. Nothing shows up before the commit.
+        auto render_layers(layer_tree const& layers) -> void;
+
+        // Commits through the shared device, pending changes of other windows go along.
+        auto commit() -> void;
 
-        auto end_draw() -> void;
+        // While live resizing layer surfaces only grow, ending it trims them back to their content.
+        auto set_live_resize(bool const is_live_resizing) -> void;
+        auto is_live_resizing() const { return _is_live_resizing; }
+
+        // Shows the last frame at a new client size without drawing anything, stretched where the client area
+        // grew and clipped where it shrank. Needs a commit, the next render_layers puts it back at its real size.
+        auto present_resized(measure::size<float> const& frame_size, measure::size<float> const& client_size) -> void;
 
         auto fill_rectangle(
             measure::rectangle<float> const& fill_area, 
@@ -47,50 +70,59 @@ namespace chrome::graphics {
         ) -> void;
 
         auto draw_text(
-            std::string const& text, measure::point<float> const& top_left, std::string const& font_family, 
+            std::string_view text, measure::point<float> const& top_left, std::string_view font_family, 
             float const font_size, measure::color const& text_color, 
-            DWRITE_FONT_WEIGHT const font_weight = DWRITE_FONT_WEIGHT_NORMAL
+            font_weight const weight = font_weight::normal
         ) -> void;
 
-        auto push_transform(D2D1::Matrix3x2F const& transform) -> void;
+        auto push_transform(transform const& transform) -> void;
 
         auto pop_transform() -> void;
 
-        auto resize_buffers() -> void;
+        // Replays recorded commands into the layer being drawn.
+        auto execute(command_list const& commands) -> void;
+
+        // Draws rejected up front for missing the update area, counted since the last reset.
+        auto get_culling_statistics() const -> culling_statistics const& { return _culler.get_statistics(); }
+        auto reset_culling_statistics() -> void { _culler.reset_statistics(); }
+
+        auto& get_device() const { return *_device; }
 
     private:
 
         auto clear_transforms() -> void;
 
-        auto get_texture(std::string const& filename)-> ID2D1Bitmap*;
-        auto load_image_into_pool(std::string const& filename) -> ID2D1Bitmap*;
+        struct layer_visual {
+            com::unique_ptr<IDCompositionVisual2> visual;
+            com::unique_ptr<IDCompositionVirtualSurface> surface;
+            measure::size<std::uint32_t> surface_size { 0, 0 };
+            measure::size<std::uint32_t> content_extent { 0, 0 }; // Pixels drawn into, can be less than allocated.
+        };
 
-        com::unique_ptr<ID3D11Device>           _device_d3d11;
-        com::unique_ptr<ID3D11DeviceContext>    _device_context_d3d11;
-        com::unique_ptr<ID2D1Factory>           _factory_d2d1;
-        com::unique_ptr<ID2D1RenderTarget>      _dxgi_render_target_d2d1;
-        com::unique_ptr<IDWriteFactory>         _factory_dwrite;
-        com::unique_ptr<IWICImagingFactory>     _factory_wic;
+        auto get_layer_visual(layer_id const id) -> layer_visual&;
 
-        com::unique_ptr<ID2D1Device>            _device_d2d1;
-        com::unique_ptr<ID2D1DeviceContext>     _device_context_d2d1;
-        com::unique_ptr<ID2D1DeviceContext>     _resource_device_context_d2d1;
+        // Only the update area (in surface pixels) is redrawn, everything else is retained by DComp.
+        auto begin_draw(IDCompositionVirtualSurface* surface, measure::rectangle<std::int32_t> const& update_area) -> void;
+        auto end_draw(IDCompositionVirtualSurface* surface) -> void;
 
-        com::unique_ptr<ID2D1SolidColorBrush>   _brush;
-        com::unique_ptr<IDWriteTextFormat>      _standard_text_format;
+        render_device* _device;
+        com::unique_ptr<ID2D1DeviceContext>     _device_context_d2d1; // Handed out by the surface being drawn.
 
-        com::unique_ptr<IDCompositionDesktopDevice>     _device_dcomp;
-        com::unique_ptr<IDCompositionTarget>            _window_target_dcomp;
-        com::unique_ptr<IDCompositionVisual2>           _primary_visual_dcomp;
-        com::unique_ptr<IDCompositionVirtualSurface>    _window_surface_dcomp;
+        com::unique_ptr<IDCompositionTarget>    _window_target_dcomp;
+        com::unique_ptr<IDCompositionVisual2>   _primary_visual_dcomp;
 
-        std::unordered_map<std::string, com::unique_ptr<ID2D1Bitmap>> _resident_textures_map;
+        // Flat below the primary visual in draw order, positioned and clipped absolutely.
+        std::unordered_map<layer_id, layer_visual> _layer_visuals;
 
         HWND _associated_window = nullptr;
 
         float _dpi_x = 96.0f, _dpi_y = 96.0f;
 
-        std::stack<D2D1::Matrix3x2F> _transforms;
+        bool _is_live_resizing = false;
+        bool _is_presenting_resized = false;
+
+        transform_stack _transforms;
+        draw_culler _culler; // Culls in DIPs, after the surface offset.
 
     };
 
@@ -0,0 +1,120 @@
+#include <limits>
+
+#include <graphics/skyline_packer.hpp>
+
+namespace chrome::graphics {
+
+    skyline_packer::skyline_packer(std::uint32_t const width, std::uint32_t const height)
+    : _width(width), _height(height) {
+        reset();
+    }
+
+    auto skyline_packer::pack(std::uint32_t const width, std::uint32_t const height) -> std::optional<measure::point<std::uint32_t>> {
+
+        if (width == 0 || height == 0 || width > _width || height > _height) return std::nullopt;
+
+        auto best_index = _skyline.size();
+        auto best_bottom = std::numeric_limits<std::uint32_t>::max();
+        auto best_width = std::numeric_limits<std::uint32_t>::max();
+        auto best_y = 0u;
+
+        // Bottom-left: lowest resulting top edge wins, ties go to the narrower segment to limit waste.
+        for (std::size_t i = 0; i < _skyline.size(); ++i) {
+
+            auto y = fit(i, width, height);
+            if (!y) continue;
+
+            auto bottom = *y + height;
+            if (bottom < best_bottom || (bottom == best_bottom && _skyline[i].width < best_width)) {
+                best_index = i; best_bottom = bottom; best_width = _skyline[i].width; best_y = *y;
+            }
+
+        }
+
+        if (best_index == _skyline.size()) return std::nullopt;
+
+        auto x = _skyline[best_index].x;
+        place(best_index, x, best_y, width, height);
+
+        return measure::point<std::uint32_t> { x, best_y };
+
+    }
+
+    auto skyline_packer::grow(std::uint32_t const width, std::uint32_t const height) -> void {
+
+        if (width > _width) {
+
+            auto& last = _skyline.back();
+            if (last.y == 0) last.width += width - _width;
+            else _skyline.push_back({ _width, 0, width - _width });
+
+            _width = width;
+
+        }
+
+        if (height > _height) _height = height;
+
+    }
+
+    auto skyline_packer::reset() -> void {
+
+        _skyline.clear();
+        _skyline.push_back({ 0, 0, _width });
+        _used_area = 0;
+
+    }
+
+    auto skyline_packer::fit(std::size_t const index, std::uint32_t const width, std::uint32_t const height) const -> std::optional<std::uint32_t> {
+
+        auto x = _skyline[index].x;
+        if (x + width > _width) return std::nullopt;
+
+        auto y = 0u;
+        auto covered = 0u;
+
+        for (auto i = index; covered < width; ++i) {
+
+            if (_skyline[i].y > y) y = _skyline[i].y;
+            if (y + height > _height) return std::nullopt;
+            covered += _skyline[i].width;
+
+        }
+
+        return y;
+
+    }
+
+    auto skyline_packer::place(std::size_t const index, std::uint32_t const x, std::uint32_t const y, std::uint32_t const width, std::uint32_t const height) -> void {
+
+        _skyline.insert(_skyline.begin() + index, segment { x, y + height, width });
+
+        // Trim or drop whatever the new segment now shadows.
+        auto right = x + width;
+        for (auto i = index + 1; i < _skyline.size();) {
+
+            auto& current = _skyline[i];
+            if (current.x >= right) break;
+
+            auto shadowed = right - current.x;
+            if (current.width <= shadowed) { _skyline.erase(_skyline.begin() + i); continue; }
+
+            current.x += shadowed;
+            current.width -= shadowed;
+            break;
+
+        }
+
+        // Neighbours at the same height become one segment.
+        for (std::size_t i = 0; i + 1 < _skyline.size();) {
+            if (_skyline[i].y == _skyline[i + 1].y) {
+                _skyline[i].width += _skyline[i + 1].width;
+                _skyline.erase(_skyline.begin() + i + 1);
+            }
+            else ++i;
+        }
+
+        _used_area += static_cast<std::uint64_t>(width) * height;
+
+    }
+
+}
@@ -0,0 +1,52 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <utility/measure.hpp>
+
+namespace chrome::graphics {
+
+    // Skyline rectangle packer with the bottom-left heuristic, placements are never freed individually.
+    // The skyline is the upper contour of everything placed so far, stored as horizontal segments.
+    struct skyline_packer {
+
+        skyline_packer(std::uint32_t const width, std::uint32_t const height);
+
+        auto pack(std::uint32_t const width, std::uint32_t const height) -> std::optional<measure::point<std::uint32_t>>;
+
+        // Enlarges the packing area, everything packed so far keeps its position.
+        auto grow(std::uint32_t const width, std::uint32_t const height) -> void;
+
+        auto reset() -> void;
+
+        auto get_width() const { return _width; }
+        auto get_height() const { return _height; }
+        auto get_used_area() const { return _used_area; }
+
+        auto get_occupancy() const {
+            return static_cast<float>(_used_area) / (static_cast<float>(_width) * static_cast<float>(_height));
+        }
+
+    private:
+
+        struct segment {
+            std::uint32_t x, y, width;
+        };
+
+        // Lowest y a rectangle starting at segment index can sit at, or nothing if it doesn't fit.
+        auto fit(std::size_t const index, std::uint32_t const width, std::uint32_t const height) const -> std::optional<std::uint32_t>;
+
+        auto place(std::size_t const index, std::uint32_t const x, std::uint32_t const y, std::uint32_t const width, std::uint32_t const height) -> void;
+
+        std::vector<segment> _skyline;
+        std::uint32_t _width, _height;
+        std::uint64_t _used_area = 0;
+
+    };
+
+}
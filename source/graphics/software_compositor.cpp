@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cmath>
+
+#include <graphics/pixel_kernels.hpp>
+#include <graphics/software_compositor.hpp>
+#include <utility/profiler.hpp>
+
+namespace chrome::graphics {
+
+    software_compositor::software_compositor(std::uint32_t const width, std::uint32_t const height, float const dpi)
+    : _target(width, height), _dpi(dpi) {}
+
+    auto software_compositor::set_image_provider(image_provider provider) -> void {
+
+        _image_provider = std::move(provider);
+        for (auto& [id, surface] : _surfaces) surface.set_image_provider(_image_provider);
+
+    }
+
+    auto software_compositor::render_layers(layer_tree const& layers) -> void {
+
+        CHROME_PROFILE_ZONE("software_compositor::render_layers");
+
+        auto scale = _dpi / 96.0f;
+
+        for (auto id : layers.get_removed()) _surfaces.erase(id);
+
+        auto& draw_order = layers.get_draw_order();
+
+        for (auto id : draw_order) {
+
+            auto& layer = layers.get(id);
+            auto& surface = get_layer_surface(id);
+
+            // Sized to the content exactly, there's no resize drag to bucket for.
+            if (layer.content_changed) {
+
+                auto width = static_cast<std::uint32_t>(std::ceil(layer.content_size.width * scale));
+                auto height = static_cast<std::uint32_t>(std::ceil(layer.content_size.height * scale));
+
+                auto& current = surface.get_target();
+                if (current.width != width || current.height != height) surface.resize_buffers(width, height);
+
+                surface.begin_draw();
+                surface.execute(*layer.commands);
+                surface.end_draw();
+
+                continue;
+
+            }
+
+            for (auto& damaged : layer.damage.get_rectangles()) {
+
+                // Snap outwards to whole pixels, so antialiased edges are covered too.
+                auto left = static_cast<std::int32_t>(std::floor(damaged.origin.x * scale));
+                auto top = static_cast<std::int32_t>(std::floor(damaged.origin.y * scale));
+                auto right = static_cast<std::int32_t>(std::ceil(damaged.right() * scale));
+                auto bottom = static_cast<std::int32_t>(std::ceil(damaged.bottom() * scale));
+
+                surface.begin_draw({ left, top, right - left, bottom - top });
+                surface.execute(*layer.commands);
+                surface.end_draw();
+
+            }
+
+        }
+
+        auto& pixel_kernels = kernels::get_kernels();
+
+        for (std::uint32_t y = 0; y < _target.height; ++y) pixel_kernels.fill_span(_target.row(y), _target.width, 0u);
+
+        for (auto id : draw_order) {
+
+            auto& content = _surfaces.at(id).get_target();
+            if (content.width == 0 || content.height == 0) continue;
+
+            auto bounds = layers.get_absolute_bounds(id);
+            auto visible = layers.get_visible_bounds(id);
+            auto offset_x = static_cast<std::int32_t>(std::round(bounds.origin.x * scale));
+            auto offset_y = static_cast<std::int32_t>(std::round(bounds.origin.y * scale));
+
+            // Clipped to what's visible, the content and the target, all in target pixels.
+            auto left = std::max({ static_cast<std::int32_t>(std::round(visible.origin.x * scale)), offset_x, 0 });
+            auto top = std::max({ static_cast<std::int32_t>(std::round(visible.origin.y * scale)), offset_y, 0 });
+            auto right = std::min({
+                static_cast<std::int32_t>(std::round(visible.right() * scale)),
+                offset_x + static_cast<std::int32_t>(content.width), static_cast<std::int32_t>(_target.width)
+            });
+            auto bottom = std::min({
+                static_cast<std::int32_t>(std::round(visible.bottom() * scale)),
+                offset_y + static_cast<std::int32_t>(content.height), static_cast<std::int32_t>(_target.height)
+            });
+
+            if (left >= right || top >= bottom) continue;
+
+            for (auto y = top; y < bottom; ++y) {
+
+                auto source = content.row(static_cast<std::uint32_t>(y - offset_y)) + (left - offset_x);
+                pixel_kernels.blend_source_over(_target.row(static_cast<std::uint32_t>(y)) + left, source, static_cast<std::size_t>(right - left), 255u);
+
+            }
+
+        }
+
+    }
+
+    auto software_compositor::resize_buffers(std::uint32_t const width, std::uint32_t const height) -> void {
+        _target = bitmap { width, height };
+    }
+
+    auto software_compositor::get_layer_surface(layer_id const id) -> software_renderer& {
+
+        auto [lookup_iterator, inserted] = _surfaces.try_emplace(id, 0u, 0u, _dpi);
+        if (inserted) lookup_iterator->second.set_image_provider(_image_provider);
+
+        return lookup_iterator->second;
+
+    }
+
+}
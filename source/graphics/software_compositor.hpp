@@ -0,0 +1,55 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include <utility/measure.hpp>
+#include <graphics/bitmap.hpp>
+#include <graphics/layer_tree.hpp>
+#include <graphics/software_renderer.hpp>
+
+// Headless counterpart of what the renderer and DComp do with a layer tree. Every layer keeps its own
+// software surface that's only redrawn where the tree says it changed, then the visible ones are blended
+// back to front into a single target, offsets and clips rounded to whole pixels the same way the visuals are.
+
+namespace chrome::graphics {
+
+    struct software_compositor {
+
+        using image_provider = software_renderer::image_provider;
+
+        software_compositor(std::uint32_t const width, std::uint32_t const height, float const dpi = 96.0f);
+
+        software_compositor(software_compositor const&) = delete;
+        software_compositor(software_compositor&&) = default;
+        software_compositor& operator=(software_compositor const&) = delete;
+        software_compositor& operator=(software_compositor&&) = default;
+
+        ~software_compositor() = default;
+
+        auto set_image_provider(image_provider provider) -> void;
+
+        // Syncs the pending changes of the tree, clearing them is left to the caller like with the renderer.
+        // The target is composited again in full every time.
+        auto render_layers(layer_tree const& layers) -> void;
+
+        auto resize_buffers(std::uint32_t const width, std::uint32_t const height) -> void;
+
+        auto get_target() const -> bitmap const& { return _target; }
+
+    private:
+
+        auto get_layer_surface(layer_id const id) -> software_renderer&;
+
+        bitmap _target;
+        float _dpi = 96.0f;
+
+        image_provider _image_provider;
+        std::unordered_map<layer_id, software_renderer> _surfaces;
+
+    };
+
+}
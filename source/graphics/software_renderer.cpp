@@ -0,0 +1,368 @@
+#include <algorithm>
+#include <cmath>
+
+#include <graphics/software_renderer.hpp>
+#include <graphics/pixel_kernels.hpp>
+#include <utility/profiler.hpp>
+
+namespace chrome::graphics {
+
+    namespace {
+
+        auto premultiply(measure::color const& color, float const coverage) -> std::uint32_t {
+
+            auto alpha = std::clamp(color.a * coverage, 0.0f, 1.0f);
+            auto to_byte = [alpha](float channel) {
+                return static_cast<std::uint32_t>(std::clamp(channel, 0.0f, 1.0f) * alpha * 255.0f + 0.5f);
+            };
+
+            auto a = static_cast<std::uint32_t>(alpha * 255.0f + 0.5f);
+            return (a << 24) | (to_byte(color.r) << 16) | (to_byte(color.g) << 8) | to_byte(color.b);
+
+        }
+
+        // Single pixels go through the span kernel too, so edges blend exactly like the spans between them.
+        inline auto blend_pixel(std::uint32_t& destination, std::uint32_t source) {
+            kernels::get_kernels().blend_span(&destination, 1, source);
+        }
+
+        auto sample_bilinear(bitmap const& source, float u, float v) -> std::uint32_t {
+
+            auto max_x = static_cast<float>(source.width - 1);
+            auto max_y = static_cast<float>(source.height - 1);
+            u = std::clamp(u, 0.0f, max_x); v = std::clamp(v, 0.0f, max_y);
+
+            auto x0 = static_cast<std::uint32_t>(u); auto y0 = static_cast<std::uint32_t>(v);
+            auto x1 = std::min(x0 + 1, source.width - 1); auto y1 = std::min(y0 + 1, source.height - 1);
+
+            auto fx = static_cast<std::uint32_t>((u - static_cast<float>(x0)) * 256.0f);
+            auto fy = static_cast<std::uint32_t>((v - static_cast<float>(y0)) * 256.0f);
+
+            auto top = source.row(y0); auto bottom = source.row(y1);
+
+            auto result = 0u;
+            for (auto shift = 0u; shift < 32u; shift += 8u) {
+
+                auto channel = [shift](std::uint32_t pixel) { return (pixel >> shift) & 0xffu; };
+                auto upper = channel(top[x0]) * (256u - fx) + channel(top[x1]) * fx;
+                auto lower = channel(bottom[x0]) * (256u - fx) + channel(bottom[x1]) * fx;
+                result |= (((upper * (256u - fy) + lower * fy) + 32768u) >> 16) << shift;
+
+            }
+
+            return result;
+
+        }
+
+        // Text is "greeked": every glyph becomes a box of average ink density, which is close enough
+        // to real glyph coverage for frame cost measurements. Metrics roughly follow Segoe UI.
+        constexpr auto average_advance_em = 0.52f;
+        constexpr auto space_advance_em = 0.27f;
+        constexpr auto glyph_inset_em = 0.08f;
+        constexpr auto ascent_em = 1.0f;
+        constexpr auto cap_height_em = 0.7f;
+        constexpr auto x_height_em = 0.5f;
+
+    }
+
+    software_renderer::software_renderer(std::uint32_t const width, std::uint32_t const height, float const dpi)
+    : _target(width, height), _dpi(dpi) {
+        set_clip(get_target_area());
+    }
+
+    auto software_renderer::set_image_provider(image_provider provider) -> void {
+        _image_provider = std::move(provider);
+    }
+
+    auto software_renderer::set_shared_target(bitmap* target) -> void {
+
+        _shared_target = target;
+        set_clip(get_target_area());
+
+    }
+
+    auto software_renderer::get_text_bounds(std::string_view text, measure::point<float> const& top_left, float const font_size) -> measure::rectangle<float> {
+
+        // Every glyph advances at most the average, so counting code points bounds the run.
+        auto glyph_count = std::count_if(text.begin(), text.end(), [](char character) {
+            return (static_cast<unsigned char>(character) & 0xc0u) != 0x80u;
+        });
+
+        return { top_left.x, top_left.y, static_cast<float>(glyph_count) * font_size * average_advance_em, font_size * ascent_em };
+
+    }
+
+    auto software_renderer::get_font_advances() -> font_advances {
+
+        font_advances result;
+        result.ascii.fill(average_advance_em);
+        result.ascii[' '] = space_advance_em;
+        result.fallback = average_advance_em;
+        result.ellipsis = average_advance_em;
+
+        return result;
+
+    }
+
+    auto software_renderer::get_device_line_bounds(
+        transform const& device, measure::point<float> const& start_point, measure::point<float> const& end_point, float const stroke_width
+    ) -> measure::rectangle<float> {
+
+        // The stroke gets the transform's average scale, a non-uniform one stretches it past the
+        // transformed local bounds along one of the axes.
+        auto p = device.transform_point(start_point);
+        auto q = device.transform_point(end_point);
+        return get_line_bounds(p, q, 2.0f * get_device_half_width(device, stroke_width));
+
+    }
+
+    auto software_renderer::begin_draw() -> void {
+        begin_draw(get_target_area());
+    }
+
+    auto software_renderer::begin_draw(measure::rectangle<std::int32_t> const& update_area) -> void {
+
+        set_clip(measure::intersect(update_area, get_target_area()));
+
+        if (_clip.is_empty()) return;
+
+        for (auto y = _clip.origin.y; y < _clip.bottom(); ++y)
+            kernels::get_kernels().fill_span(get_row(static_cast<std::uint32_t>(y)) + _clip.origin.x, static_cast<std::size_t>(_clip.dimension.width), 0u);
+
+    }
+
+    auto software_renderer::end_draw() -> void {
+        clear_transforms();
+    }
+
+    auto software_renderer::fill_rectangle(measure::rectangle<float> const& fill_area, measure::color const& fill_color) -> void {
+
+        auto& [origin, dimension] = fill_area;
+        auto device = _transforms.top() * transform::scale(_dpi / 96.0f, _dpi / 96.0f);
+        if (!_culler.accept(device, fill_area)) return;
+        CHROME_PROFILE_COUNTER("draw calls", 1);
+
+        // Rotations aren't used by the chrome, anything but axis aligned gets its bounding box filled.
+        auto p = device.transform_point(origin);
+        auto q = device.transform_point({ origin.x + dimension.width, origin.y + dimension.height });
+
+        fill_device_rectangle(std::min(p.x, q.x), std::min(p.y, q.y), std::max(p.x, q.x), std::max(p.y, q.y), fill_color);
+
+    }
+
+    auto software_renderer::draw_line(
+        measure::point<float> const& start_point, measure::point<float> const& end_point,
+        float const stroke_width, measure::color const& stroke_color
+    ) -> void {
+
+        auto device = _transforms.top() * transform::scale(_dpi / 96.0f, _dpi / 96.0f);
+        if (!_culler.accept(transform::identity(), get_device_line_bounds(device, start_point, end_point, stroke_width))) return;
+        CHROME_PROFILE_COUNTER("draw calls", 1);
+
+        auto p = device.transform_point(start_point);
+        auto q = device.transform_point(end_point);
+        auto half_width = get_device_half_width(device, stroke_width);
+
+        // Flat caps, so axis aligned lines are just thin rectangles.
+        if (p.y == q.y)
+            return fill_device_rectangle(std::min(p.x, q.x), p.y - half_width, std::max(p.x, q.x), p.y + half_width, stroke_color);
+
+        if (p.x == q.x)
+            return fill_device_rectangle(p.x - half_width, std::min(p.y, q.y), p.x + half_width, std::max(p.y, q.y), stroke_color);
+
+        auto dx = q.x - p.x, dy = q.y - p.y;
+        auto length = std::sqrt(dx * dx + dy * dy);
+        auto nx = dx / length, ny = dy / length;
+
+        auto left = std::max(static_cast<float>(_clip.origin.x), std::floor(std::min(p.x, q.x) - half_width));
+        auto top = std::max(static_cast<float>(_clip.origin.y), std::floor(std::min(p.y, q.y) - half_width));
+        auto right = std::min(static_cast<float>(_clip.right()), std::ceil(std::max(p.x, q.x) + half_width));
+        auto bottom = std::min(static_cast<float>(_clip.bottom()), std::ceil(std::max(p.y, q.y) + half_width));
+
+        for (auto y = top; y < bottom; y += 1.0f) {
+
+            auto row = get_row(static_cast<std::uint32_t>(y));
+
+            for (auto x = left; x < right; x += 1.0f) {
+
+                auto rx = x + 0.5f - p.x, ry = y + 0.5f - p.y;
+                auto along = rx * nx + ry * ny;
+                auto across = std::abs(rx * ny - ry * nx);
+
+                auto coverage = std::clamp(half_width + 0.5f - across, 0.0f, 1.0f)
+                              * std::clamp(std::min(along, length - along) + 0.5f, 0.0f, 1.0f);
+
+                if (coverage > 0.0f) blend_pixel(row[static_cast<std::uint32_t>(x)], premultiply(stroke_color, coverage));
+
+            }
+
+        }
+
+    }
+
+    auto software_renderer::draw_image(resource::image const* image, float scale, measure::point<float> const& top_left, float const opacity) -> void {
+
+        auto source = _image_provider ? _image_provider(*image) : nullptr;
+        if (source == nullptr || source->width == 0 || source->height == 0) return;
+
+        auto image_area = measure::rectangle<float> {
+            top_left, { static_cast<float>(source->width) * scale, static_cast<float>(source->height) * scale }
+        };
+
+        auto device = _transforms.top() * transform::scale(_dpi / 96.0f, _dpi / 96.0f);
+        if (!_culler.accept(device, image_area)) return;
+        CHROME_PROFILE_COUNTER("draw calls", 1);
+
+        auto p = device.transform_point(top_left);
+        auto q = device.transform_point({ image_area.right(), image_area.bottom() });
+
+        auto x0 = std::min(p.x, q.x), y0 = std::min(p.y, q.y);
+        auto x1 = std::max(p.x, q.x), y1 = std::max(p.y, q.y);
+
+        auto step_u = static_cast<float>(source->width) / (x1 - x0);
+        auto step_v = static_cast<float>(source->height) / (y1 - y0);
+        auto opacity_factor = static_cast<std::uint32_t>(std::clamp(opacity, 0.0f, 1.0f) * 255.0f + 0.5f);
+
+        auto first_x = std::max(_clip.origin.x, static_cast<std::int32_t>(std::round(x0)));
+        auto last_x = std::min(_clip.right(), static_cast<std::int32_t>(std::round(x1)));
+        auto first_y = std::max(_clip.origin.y, static_cast<std::int32_t>(std::round(y0)));
+        auto last_y = std::min(_clip.bottom(), static_cast<std::int32_t>(std::round(y1)));
+
+        if (first_x >= last_x) return;
+        _scanline.resize(static_cast<std::size_t>(last_x - first_x));
+
+        // Sampled a row at a time, so the blend runs over the whole span with the SIMD kernel.
+        for (auto y = first_y; y < last_y; ++y) {
+
+            auto row = get_row(static_cast<std::uint32_t>(y));
+            auto v = (static_cast<float>(y) + 0.5f - y0) * step_v - 0.5f;
+
+            for (auto x = first_x; x < last_x; ++x) {
+                auto u = (static_cast<float>(x) + 0.5f - x0) * step_u - 0.5f;
+                _scanline[static_cast<std::size_t>(x - first_x)] = sample_bilinear(*source, u, v);
+            }
+
+            kernels::get_kernels().blend_source_over(row + first_x, _scanline.data(), _scanline.size(), opacity_factor);
+
+        }
+
+    }
+
+    auto software_renderer::draw_text(
+        std::string_view text, measure::point<float> const& top_left, std::string_view,
+        float const font_size, measure::color const& text_color, font_weight const weight
+    ) -> void {
+
+        auto text_area = get_text_bounds(text, top_left, font_size);
+        auto device = _transforms.top() * transform::scale(_dpi / 96.0f, _dpi / 96.0f);
+        if (!_culler.accept(device, text_area)) return;
+        CHROME_PROFILE_COUNTER("draw calls", 1);
+
+        auto ink_density = std::clamp(0.4f + (static_cast<float>(weight) - 400.0f) / 2000.0f, 0.2f, 0.7f);
+        auto ink = measure::color { text_color.r, text_color.g, text_color.b, text_color.a * ink_density };
+
+        auto pen = top_left.x;
+        auto baseline = top_left.y + font_size * ascent_em;
+
+        for (auto character : text) {
+
+            auto code_unit = static_cast<unsigned char>(character);
+            if ((code_unit & 0xc0u) == 0x80u) continue; // UTF-8 continuation bytes belong to the previous glyph.
+
+            if (code_unit == ' ') { pen += font_size * space_advance_em; continue; }
+
+            auto is_tall = (code_unit >= 'A' && code_unit <= 'Z') || (code_unit >= '0' && code_unit <= '9');
+            auto glyph_top = baseline - font_size * (is_tall ? cap_height_em : x_height_em);
+
+            auto p = device.transform_point({ pen + font_size * glyph_inset_em, glyph_top });
+            auto q = device.transform_point({ pen + font_size * (average_advance_em - glyph_inset_em), baseline });
+            fill_device_rectangle(std::min(p.x, q.x), std::min(p.y, q.y), std::max(p.x, q.x), std::max(p.y, q.y), ink);
+
+            pen += font_size * average_advance_em;
+
+        }
+
+    }
+
+    auto software_renderer::push_transform(transform const& transform) -> void {
+
+        _transforms.push(transform);
+
+    }
+
+    auto software_renderer::pop_transform() -> void {
+        _transforms.pop();
+    }
+
+    auto software_renderer::execute(command_list const& commands) -> void {
+
+        CHROME_PROFILE_ZONE("software_renderer::execute");
+        commands.replay(*this);
+
+    }
+
+    auto software_renderer::resize_buffers(std::uint32_t const width, std::uint32_t const height) -> void {
+
+        _target = bitmap { width, height };
+        set_clip(get_target_area());
+
+    }
+
+    auto software_renderer::fill_device_rectangle(float x0, float y0, float x1, float y1, measure::color const& color) -> void {
+
+        x0 = std::max(x0, static_cast<float>(_clip.origin.x)); y0 = std::max(y0, static_cast<float>(_clip.origin.y));
+        x1 = std::min(x1, static_cast<float>(_clip.right()));
+        y1 = std::min(y1, static_cast<float>(_clip.bottom()));
+        if (x0 >= x1 || y0 >= y1) return;
+
+        auto first_column = static_cast<std::uint32_t>(x0);
+        auto last_column = static_cast<std::uint32_t>(std::ceil(x1)) - 1;
+        auto left_coverage = std::min(x1, static_cast<float>(first_column + 1)) - x0;
+        auto right_coverage = x1 - static_cast<float>(last_column);
+
+        for (auto y = static_cast<std::uint32_t>(y0); static_cast<float>(y) < y1; ++y) {
+
+            auto row = get_row(y);
+            auto row_coverage = std::min(y1, static_cast<float>(y + 1)) - std::max(y0, static_cast<float>(y));
+
+            if (first_column == last_column) {
+                blend_pixel(row[first_column], premultiply(color, left_coverage * row_coverage));
+                continue;
+            }
+
+            blend_pixel(row[first_column], premultiply(color, left_coverage * row_coverage));
+            kernels::get_kernels().blend_span(row + first_column + 1, last_column - first_column - 1, premultiply(color, row_coverage));
+            blend_pixel(row[last_column], premultiply(color, right_coverage * row_coverage));
+
+        }
+
+    }
+
+    auto software_renderer::get_device_half_width(transform const& device, float const stroke_width) -> float {
+        return 0.5f * stroke_width * std::sqrt(std::abs(device.m11 * device.m22 - device.m12 * device.m21));
+    }
+
+    auto software_renderer::get_target_area() const -> measure::rectangle<std::int32_t> {
+
+        auto& target = get_target();
+        return { 0, 0, static_cast<std::int32_t>(target.width), static_cast<std::int32_t>(target.height) };
+
+    }
+
+    auto software_renderer::clear_transforms() -> void {
+
+        _transforms.reset();
+
+    }
+
+    auto software_renderer::set_clip(measure::rectangle<std::int32_t> const& clip) -> void {
+
+        _clip = clip;
+        _culler.set_cull_area({
+            static_cast<float>(clip.origin.x), static_cast<float>(clip.origin.y),
+            static_cast<float>(clip.dimension.width), static_cast<float>(clip.dimension.height)
+        });
+
+    }
+
+}
@@ -0,0 +1,125 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include <utility/measure.hpp>
+#include <graphics/bitmap.hpp>
+#include <graphics/command_list.hpp>
+#include <graphics/draw_culler.hpp>
+#include <graphics/font.hpp>
+#include <graphics/image.hpp>
+#include <graphics/transform.hpp>
+
+// Headless implementation of the renderer surface, rasterizing into a premultiplied BGRA bitmap.
+// Doesn't need D3D11, D2D or DComp, meaning it runs on machines without a GPU or Windows at all,
+// which is what frame cost measurements on CI use. Coordinates are DIPs, same as the D2D renderer.
+
+namespace chrome::graphics {
+
+    struct software_renderer {
+
+        // Decoding is left to the caller, the renderer only needs premultiplied pixels.
+        // Returning nullptr skips the draw.
+        using image_provider = std::function<bitmap const*(resource::image const&)>;
+
+        software_renderer(std::uint32_t const width, std::uint32_t const height, float const dpi = 96.0f);
+
+        software_renderer(software_renderer const&) = delete;
+        software_renderer(software_renderer&&) = default;
+        software_renderer& operator=(software_renderer const&) = delete;
+        software_renderer& operator=(software_renderer&&) = default;
+
+        ~software_renderer() = default;
+
+        auto set_image_provider(image_provider provider) -> void;
+
+        // Draws into a bitmap owned by someone else, or into the renderer's own again given nullptr.
+        // Renderers sharing a target can draw at the same time as long as their update areas don't overlap.
+        auto set_shared_target(bitmap* target) -> void;
+
+        // Without an update area the whole target is redrawn, otherwise drawing is clipped to it.
+        auto begin_draw() -> void;
+        auto begin_draw(measure::rectangle<std::int32_t> const& update_area) -> void;
+
+        auto end_draw() -> void;
+
+        auto fill_rectangle(
+            measure::rectangle<float> const& fill_area,
+            measure::color const& fill_color
+        ) -> void;
+
+        auto draw_line(
+            measure::point<float> const& start, measure::point<float> const& end,
+            float const stroke_width, measure::color const& stroke_color
+        ) -> void;
+
+        auto draw_image(
+            resource::image const* image, float scale,
+            measure::point<float> const& top_left, float const opacity
+        ) -> void;
+
+        auto draw_text(
+            std::string_view text, measure::point<float> const& top_left, std::string_view font_family,
+            float const font_size, measure::color const& text_color,
+            font_weight const weight = font_weight::normal
+        ) -> void;
+
+        auto push_transform(transform const& transform) -> void;
+
+        auto pop_transform() -> void;
+
+        auto execute(command_list const& commands) -> void;
+
+        auto resize_buffers(std::uint32_t const width, std::uint32_t const height) -> void;
+
+        auto get_target() const -> bitmap const& { return _shared_target ? *_shared_target : _target; }
+
+        // Area greeked text covers in DIPs, every glyph ends up inside it.
+        static auto get_text_bounds(std::string_view text, measure::point<float> const& top_left, float const font_size) -> measure::rectangle<float>;
+
+        // The advances greeked text is drawn with, same for every family and weight.
+        static auto get_font_advances() -> font_advances;
+
+        // Device pixels a stroked line can touch, the device transform includes the DPI scale.
+        static auto get_device_line_bounds(
+            transform const& device, measure::point<float> const& start, measure::point<float> const& end, float const stroke_width
+        ) -> measure::rectangle<float>;
+
+        // Draws rejected up front for missing the update area, counted since the last reset.
+        auto get_culling_statistics() const -> culling_statistics const& { return _culler.get_statistics(); }
+        auto reset_culling_statistics() -> void { _culler.reset_statistics(); }
+
+    private:
+
+        // Axis aligned fill in device pixels, edges get fractional coverage.
+        auto fill_device_rectangle(float x0, float y0, float x1, float y1, measure::color const& color) -> void;
+
+        auto clear_transforms() -> void;
+
+        static auto get_device_half_width(transform const& device, float const stroke_width) -> float;
+
+        auto get_target_area() const -> measure::rectangle<std::int32_t>;
+        auto get_row(std::uint32_t const y) { return (_shared_target ? *_shared_target : _target).row(y); }
+
+        auto set_clip(measure::rectangle<std::int32_t> const& clip) -> void;
+
+        bitmap _target;
+        bitmap* _shared_target = nullptr;
+        measure::rectangle<std::int32_t> _clip;
+        image_provider _image_provider;
+
+        float _dpi = 96.0f;
+
+        transform_stack _transforms;
+        draw_culler _culler; // Culls in device pixels.
+        std::vector<std::uint32_t> _scanline; // Sampled image row, reused between draws.
+
+    };
+
+}
@@ -0,0 +1,38 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+
+#include <utility/measure.hpp>
+
+// How big a layer's backing surface gets for the content it holds. Surfaces are sized in buckets,
+// so a resize drag only reallocates when it crosses one, and while live resizing they're never shrunk.
+// Everything past the content is clipped away by the visual, whatever it holds.
+
+namespace chrome::graphics {
+
+    constexpr auto surface_bucket = 128u;
+
+    constexpr auto get_bucketed_extent(std::uint32_t const extent) -> std::uint32_t {
+        return (extent + surface_bucket - 1) / surface_bucket * surface_bucket;
+    }
+
+    // Required is the content in surface pixels. Outside of live resize a surface settles at
+    // the bucket its content falls in, so one left large by a drag is trimmed back.
+    constexpr auto get_surface_size(
+        measure::size<std::uint32_t> const& current, measure::size<std::uint32_t> const& required, bool const is_live_resizing
+    ) {
+
+        auto fit = [is_live_resizing](std::uint32_t const current_extent, std::uint32_t const required_extent) {
+            if (required_extent == 0) return current_extent;
+            if (is_live_resizing && required_extent <= current_extent) return current_extent;
+            return get_bucketed_extent(required_extent);
+        };
+
+        return measure::size<std::uint32_t> { fit(current.width, required.width), fit(current.height, required.height) };
+
+    }
+
+}
@@ -0,0 +1,127 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <utility/hash.hpp>
+#include <utility/lru_cache.hpp>
+#include <graphics/font.hpp>
+
+// Keys and eviction for text formats and laid out text. The platform objects themselves are
+// template parameters, so the D2D renderer stores DWrite objects while the lookups stay portable.
+// Keys come in an owning (std::string) and a viewing (std::string_view) flavor, lookups are done
+// with views so a hit doesn't allocate.
+
+namespace chrome::graphics {
+
+    template <typename String>
+    struct basic_text_format_key {
+        String font_family;
+        float font_size;
+        font_weight weight;
+        font_style style;
+    };
+
+    template <typename String>
+    struct basic_text_layout_key {
+        String text;
+        basic_text_format_key<String> format;
+        float max_width;
+    };
+
+    using text_format_key = basic_text_format_key<std::string>;
+    using text_format_view = basic_text_format_key<std::string_view>;
+    using text_layout_key = basic_text_layout_key<std::string>;
+    using text_layout_view = basic_text_layout_key<std::string_view>;
+
+    template <typename String>
+    inline auto make_owning(basic_text_format_key<String> const& key) {
+        return text_format_key { std::string { key.font_family }, key.font_size, key.weight, key.style };
+    }
+
+    template <typename String>
+    inline auto make_owning(basic_text_layout_key<String> const& key) {
+        return text_layout_key { std::string { key.text }, make_owning(key.format), key.max_width };
+    }
+
+    struct text_key_hash {
+
+        using is_transparent = void;
+
+        template <typename String>
+        auto operator()(basic_text_format_key<String> const& key) const -> std::size_t {
+
+            auto hash = utility::hash_string(key.font_family);
+            hash = utility::hash_value(key.font_size, hash);
+            hash = utility::hash_value(key.weight, hash);
+            return static_cast<std::size_t>(utility::hash_value(key.style, hash));
+
+        }
+
+        template <typename String>
+        auto operator()(basic_text_layout_key<String> const& key) const -> std::size_t {
+
+            auto hash = utility::hash_string(key.text);
+            hash = utility::hash_value(key.max_width, hash);
+            return utility::hash_combine(static_cast<std::size_t>(hash), operator()(key.format));
+
+        }
+
+    };
+
+    struct text_key_equal {
+
+        using is_transparent = void;
+
+        template <typename LhsString, typename RhsString>
+        auto operator()(basic_text_format_key<LhsString> const& lhs, basic_text_format_key<RhsString> const& rhs) const -> bool {
+            return lhs.font_size == rhs.font_size && lhs.weight == rhs.weight && lhs.style == rhs.style
+                && std::string_view { lhs.font_family } == std::string_view { rhs.font_family };
+        }
+
+        template <typename LhsString, typename RhsString>
+        auto operator()(basic_text_layout_key<LhsString> const& lhs, basic_text_layout_key<RhsString> const& rhs) const -> bool {
+            return lhs.max_width == rhs.max_width && operator()(lhs.format, rhs.format)
+                && std::string_view { lhs.text } == std::string_view { rhs.text };
+        }
+
+    };
+
+    template <typename Format, typename Layout>
+    struct text_cache {
+
+        text_cache(std::size_t const format_capacity = 32, std::size_t const layout_capacity = 256)
+        : _formats(format_capacity), _layouts(layout_capacity) {}
+
+        // Create is only called on a miss and receives the key that missed.
+        template <typename Create>
+        auto get_format(text_format_view const& key, Create&& create) -> Format& {
+            return _formats.get_or_create(key, [&] { return std::pair { make_owning(key), create(key) }; });
+        }
+
+        template <typename Create>
+        auto get_layout(text_layout_view const& key, Create&& create) -> Layout& {
+            return _layouts.get_or_create(key, [&] { return std::pair { make_owning(key), create(key) }; });
+        }
+
+        auto& get_format_statistics() const { return _formats.get_statistics(); }
+        auto& get_layout_statistics() const { return _layouts.get_statistics(); }
+
+        auto clear() -> void {
+            _layouts.clear();
+            _formats.clear();
+        }
+
+    private:
+
+        utility::lru_cache<text_format_key, Format, text_key_hash, text_key_equal> _formats;
+        utility::lru_cache<text_layout_key, Layout, text_key_hash, text_key_equal> _layouts;
+
+    };
+
+}
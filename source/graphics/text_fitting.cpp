@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include <graphics/text_fitting.hpp>
+
+namespace chrome::graphics {
+
+    text_fitter::text_fitter(advance_provider provider, float const width_bucket, std::size_t const capacity)
+    : _advance_provider(std::move(provider)), _width_bucket(width_bucket > 0.0f ? width_bucket : 1.0f), _measurements(capacity) {}
+
+    auto text_fitter::set_advance_provider(advance_provider provider) -> void {
+
+        _advance_provider = std::move(provider);
+        _advances.clear();
+        _measurements.clear();
+
+    }
+
+    auto text_fitter::measure(std::string_view text, font_id const font, float const font_size, font_weight const weight) -> float {
+
+        auto& advances = get_measurement({ text, font, weight }).advances;
+        return advances.empty() ? 0.0f : advances.back() * font_size;
+
+    }
+
+    auto text_fitter::fit(
+        std::string_view text, font_id const font, float const font_size, float const max_width, font_weight const weight
+    ) -> fitted_text const& {
+
+        auto& measured = get_measurement({ text, font, weight });
+
+        auto bucket = static_cast<std::int32_t>(std::floor(max_width / _width_bucket));
+        auto key = (static_cast<std::uint64_t>(std::bit_cast<std::uint32_t>(font_size)) << 32) | static_cast<std::uint32_t>(bucket);
+
+        auto lookup_iterator = std::find_if(measured.cuts.begin(), measured.cuts.end(), [key](auto& entry) { return entry.first == key; });
+
+        if (lookup_iterator != measured.cuts.end()) ++_fit_statistics.hits;
+        else {
+
+            ++_fit_statistics.misses;
+
+            if (measured.cuts.size() >= cuts_per_label) {
+                _fit_statistics.evictions += measured.cuts.size();
+                measured.cuts.clear();
+            }
+
+            lookup_iterator = measured.cuts.emplace(measured.cuts.end(), key, make_cut(text, measured, font_size, bucket));
+
+        }
+
+        // Reusing the string keeps a hit from allocating once it's grown to the longest label.
+        auto& [length, width, is_truncated] = lookup_iterator->second;
+
+        _fitted.text.assign(text.substr(0, length));
+        if (is_truncated) _fitted.text.append(ellipsis);
+
+        _fitted.width = width;
+        _fitted.is_truncated = is_truncated;
+
+        return _fitted;
+
+    }
+
+    auto text_fitter::get_statistics() const -> text_fitting_statistics {
+        return { _measurements.get_statistics(), _fit_statistics };
+    }
+
+    auto text_fitter::get_measurement(basic_measurement_key<std::string_view> const& key) -> measurement& {
+
+        return _measurements.get_or_create(key, [&] {
+
+            auto& font = get_advances(key.font, key.weight);
+
+            measurement result;
+            result.ellipsis = font.ellipsis;
+
+            // A code point starts at every byte that isn't a continuation, same as the renderers count glyphs.
+            auto total = 0.0f;
+            auto& text = key.text;
+
+            for (std::size_t position = 0; position < text.size();) {
+
+                auto lead = static_cast<unsigned char>(text[position]);
+                total += lead < 0x80 ? font.ascii[lead] : font.fallback;
+
+                do ++position; while (position < text.size() && (static_cast<unsigned char>(text[position]) & 0xc0u) == 0x80u);
+
+                result.advances.push_back(total);
+                result.ends.push_back(static_cast<std::uint32_t>(position));
+
+            }
+
+            return std::pair { basic_measurement_key<std::string> { std::string { text }, key.font, key.weight }, std::move(result) };
+
+        });
+
+    }
+
+    auto text_fitter::make_cut(std::string_view text, measurement const& measured, float const font_size, std::int32_t const bucket) const -> cut {
+
+        auto& [advances, ends, ellipsis_width, cuts] = measured;
+
+        // The whole bucket shares one cut, made for its narrowest width.
+        auto available = static_cast<float>(bucket) * _width_bucket / font_size;
+
+        auto total = advances.empty() ? 0.0f : advances.back();
+        if (total <= available) return { ends.empty() ? 0u : ends.back(), total * font_size, false };
+
+        // Code points that fit ahead of the ellipsis, the totals only ever grow.
+        auto kept = static_cast<std::size_t>(std::upper_bound(advances.begin(), advances.end(), available - ellipsis_width) - advances.begin());
+        while (kept > 0 && text[ends[kept - 1] - 1] == ' ') --kept;
+
+        auto length = kept > 0 ? ends[kept - 1] : 0u;
+        auto width = (kept > 0 ? advances[kept - 1] : 0.0f) + ellipsis_width;
+
+        return { length, width * font_size, true };
+
+    }
+
+    auto text_fitter::get_advances(font_id const font, font_weight const weight) -> font_advances const& {
+
+        auto key = (static_cast<std::uint64_t>(font) << 16) | static_cast<std::uint16_t>(weight);
+
+        auto lookup_iterator = _advances.find(key);
+        if (lookup_iterator == _advances.end()) lookup_iterator = _advances.emplace(key, _advance_provider(get_font_family(font), weight)).first;
+
+        return lookup_iterator->second;
+
+    }
+
+}
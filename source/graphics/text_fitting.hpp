@@ -0,0 +1,134 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <utility/hash.hpp>
+#include <utility/lru_cache.hpp>
+#include <graphics/font.hpp>
+
+// Fits single line labels such as tab titles into a width, cutting them off with an ellipsis. Every label is
+// measured once per font into running totals of its code point advances, in ems so one measurement serves
+// every font size. Fitting binary searches those totals. Where each label gets cut is kept with its
+// measurement per size and width bucket, so a resize that moves every tab by a pixel or two costs a lookup
+// per tab and re-fits the rest without touching the text again.
+
+namespace chrome::graphics {
+
+    struct fitted_text {
+        std::string text;           // What to draw, the label itself or a prefix of it followed by an ellipsis.
+        float width = 0.0f;         // Of text, in DIPs.
+        bool is_truncated = false;
+    };
+
+    struct text_fitting_statistics {
+        utility::cache_statistics measurements;
+        utility::cache_statistics fits;
+    };
+
+    struct text_fitter {
+
+        static constexpr auto ellipsis = std::string_view { "\xe2\x80\xa6" };
+
+        // Called once per font family and weight, on the thread doing the fitting.
+        using advance_provider = std::function<font_advances(std::string_view font_family, font_weight weight)>;
+
+        // Widths within the same bucket share a result, fitted to the bucket's lower edge so it never overflows.
+        explicit text_fitter(advance_provider provider, float const width_bucket = 2.0f, std::size_t const capacity = 1024);
+
+        text_fitter(text_fitter const&) = delete;
+        text_fitter(text_fitter&&) = default;
+        text_fitter& operator=(text_fitter const&) = delete;
+        text_fitter& operator=(text_fitter&&) = default;
+
+        ~text_fitter() = default;
+
+        // Forgets everything measured with the previous one.
+        auto set_advance_provider(advance_provider provider) -> void;
+
+        auto measure(std::string_view text, font_id const font, float const font_size, font_weight const weight = font_weight::normal) -> float;
+
+        // Valid until the next call to fit, copy what has to outlive it. Truncation drops trailing spaces before the
+        // ellipsis, a width too small for the ellipsis itself still gets it.
+        auto fit(
+            std::string_view text, font_id const font, float const font_size, float const max_width,
+            font_weight const weight = font_weight::normal
+        ) -> fitted_text const&;
+
+        auto get_statistics() const -> text_fitting_statistics;
+
+    private:
+
+        template <typename String>
+        struct basic_measurement_key {
+            String text;
+            font_id font;
+            font_weight weight;
+        };
+
+        struct key_hash {
+
+            using is_transparent = void;
+
+            // Titles run long, the standard hash takes them a word at a time where FNV goes byte by byte.
+            template <typename String>
+            auto operator()(basic_measurement_key<String> const& key) const -> std::size_t {
+                auto hash = utility::hash_value(key.weight, utility::hash_value(key.font));
+                return utility::hash_combine(std::hash<std::string_view> {}(key.text), static_cast<std::size_t>(hash));
+            }
+
+        };
+
+        struct key_equal {
+
+            using is_transparent = void;
+
+            template <typename LhsString, typename RhsString>
+            auto operator()(basic_measurement_key<LhsString> const& lhs, basic_measurement_key<RhsString> const& rhs) const -> bool {
+                return lhs.font == rhs.font && lhs.weight == rhs.weight && std::string_view { lhs.text } == std::string_view { rhs.text };
+            }
+
+        };
+
+        // Where a label was cut, the byte length of what's kept ahead of the ellipsis.
+        struct cut {
+            std::uint32_t length;
+            float width;
+            bool is_truncated;
+        };
+
+        // Running totals, advances[i] is where code point i ends and ends[i] the byte after it. Cuts are keyed
+        // by font size and width bucket, few enough per label to search linearly, and forgotten all at once
+        // when a label collects too many.
+        struct measurement {
+            std::vector<float> advances;
+            std::vector<std::uint32_t> ends;
+            float ellipsis = 0.0f;
+            std::vector<std::pair<std::uint64_t, cut>> cuts;
+        };
+
+        static constexpr auto cuts_per_label = 64u;
+
+        auto get_measurement(basic_measurement_key<std::string_view> const& key) -> measurement&;
+        auto make_cut(std::string_view text, measurement const& measured, float const font_size, std::int32_t const bucket) const -> cut;
+        auto get_advances(font_id const font, font_weight const weight) -> font_advances const&;
+
+        advance_provider _advance_provider;
+        float _width_bucket;
+
+        std::unordered_map<std::uint64_t, font_advances> _advances;
+        utility::lru_cache<basic_measurement_key<std::string>, measurement, key_hash, key_equal> _measurements;
+        utility::cache_statistics _fit_statistics;
+
+        fitted_text _fitted;
+
+    };
+
+}
@@ -0,0 +1,154 @@
+#include <algorithm>
+
+#include <graphics/texture_atlas.hpp>
+
+namespace chrome::graphics {
+
+    texture_atlas::texture_atlas(std::uint32_t const initial_page_size, std::uint32_t const maximum_page_size, std::uint32_t const padding)
+    : _initial_page_size(initial_page_size), _maximum_page_size(std::max(initial_page_size, maximum_page_size)), _padding(padding) {}
+
+    auto texture_atlas::allocate(std::string const& key, std::uint32_t const width, std::uint32_t const height) -> std::optional<atlas_entry> {
+
+        if (auto existing = find(key)) return *existing;
+        if (!fits(width, height)) return std::nullopt;
+
+        auto entry = place(width, height);
+        if (entry) _entries.emplace(key, *entry);
+
+        return entry;
+
+    }
+
+    auto texture_atlas::find(std::string const& key) const -> atlas_entry const* {
+
+        auto lookup_iterator = _entries.find(key);
+        return lookup_iterator != _entries.end() ? &lookup_iterator->second : nullptr;
+
+    }
+
+    auto texture_atlas::release(std::string const& key) -> bool {
+
+        auto lookup_iterator = _entries.find(key);
+        if (lookup_iterator == _entries.end()) return false;
+
+        auto& [width, height] = lookup_iterator->second.area.dimension;
+        _released_area += static_cast<std::uint64_t>(width + 2 * _padding) * (height + 2 * _padding);
+        _entries.erase(lookup_iterator);
+
+        return true;
+
+    }
+
+    auto texture_atlas::should_repack() const -> bool {
+
+        std::uint64_t used_area = 0;
+        for (auto& page : _pages) used_area += page.get_used_area();
+
+        return used_area > 0 && _released_area * 2 > used_area;
+
+    }
+
+    auto texture_atlas::repack() -> std::vector<atlas_move> {
+
+        std::vector<std::pair<std::string, atlas_entry>> live { _entries.begin(), _entries.end() };
+        std::sort(live.begin(), live.end(), [](auto& lhs, auto& rhs) {
+            return lhs.second.area.dimension.height > rhs.second.area.dimension.height;
+        });
+
+        for (auto& page : _pages) page.reset();
+        _released_area = 0;
+
+        std::vector<atlas_move> moves;
+        moves.reserve(live.size());
+
+        for (auto& [key, from] : live) {
+
+            auto to = *place(from.area.dimension.width, from.area.dimension.height);
+            _entries[key] = to;
+            moves.push_back({ key, from, to });
+
+        }
+
+        // Pages left empty at the end are dropped.
+        while (!_pages.empty() && _pages.back().get_used_area() == 0) _pages.pop_back();
+
+        return moves;
+
+    }
+
+    auto texture_atlas::get_occupancy() const -> float {
+
+        std::uint64_t used_area = 0, total_area = 0;
+        for (auto& page : _pages) {
+            used_area += page.get_used_area();
+            total_area += static_cast<std::uint64_t>(page.get_width()) * page.get_height();
+        }
+
+        return total_area > 0 ? static_cast<float>(used_area - _released_area) / static_cast<float>(total_area) : 0.0f;
+
+    }
+
+    auto texture_atlas::place(std::uint32_t const width, std::uint32_t const height) -> std::optional<atlas_entry> {
+
+        auto padded_width = width + 2 * _padding;
+        auto padded_height = height + 2 * _padding;
+
+        auto make_entry = [this, width, height](std::uint32_t page, measure::point<std::uint32_t> const& position) {
+            return atlas_entry { page, { position.x + _padding, position.y + _padding, width, height } };
+        };
+
+        for (std::uint32_t page = 0; page < _pages.size(); ++page) {
+
+            auto& packer = _pages[page];
+            if (auto position = packer.pack(padded_width, padded_height)) return make_entry(page, *position);
+
+            // Doubling keeps what's already packed in place, the backend copies the old page over.
+            while (packer.get_width() < _maximum_page_size || packer.get_height() < _maximum_page_size) {
+
+                packer.grow(
+                    std::min(packer.get_width() * 2, _maximum_page_size),
+                    std::min(packer.get_height() * 2, _maximum_page_size)
+                );
+
+                if (auto position = packer.pack(padded_width, padded_height)) return make_entry(page, *position);
+
+            }
+
+        }
+
+        auto page_size = _initial_page_size;
+        while (page_size < std::max(padded_width, padded_height)) page_size *= 2;
+        page_size = std::min(page_size, _maximum_page_size);
+
+        auto& packer = _pages.emplace_back(page_size, page_size);
+        auto position = packer.pack(padded_width, padded_height);
+
+        return make_entry(static_cast<std::uint32_t>(_pages.size() - 1), *position);
+
+    }
+
+    auto extrude_edges(bitmap const& source, std::uint32_t const padding) -> bitmap {
+
+        auto result = bitmap { source.width + 2 * padding, source.height + 2 * padding };
+        if (source.width == 0 || source.height == 0) return result;
+
+        for (std::uint32_t y = 0; y < result.height; ++y) {
+
+            auto source_y = static_cast<std::uint32_t>(std::clamp<std::int64_t>(
+                static_cast<std::int64_t>(y) - padding, 0, source.height - 1
+            ));
+
+            auto source_row = source.row(source_y);
+            auto destination_row = result.row(y);
+
+            std::fill_n(destination_row, padding, source_row[0]);
+            std::copy_n(source_row, source.width, destination_row + padding);
+            std::fill_n(destination_row + padding + source.width, padding, source_row[source.width - 1]);
+
+        }
+
+        return result;
+
+    }
+
+}
@@ -0,0 +1,86 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <utility/measure.hpp>
+#include <graphics/bitmap.hpp>
+#include <graphics/skyline_packer.hpp>
+
+// Bookkeeping for packing many small images into a few large pages, so consecutive image draws
+// sample the same texture. Pages start small, grow up to a maximum size and then new ones are added.
+// Every entry is surrounded by a gutter of replicated edge pixels, so bilinear filtering at the
+// entry's border never picks up a neighbour. Pixels themselves are owned by the backend.
+
+namespace chrome::graphics {
+
+    struct atlas_entry {
+        std::uint32_t page;
+        measure::rectangle<std::uint32_t> area; // Excluding the gutter.
+    };
+
+    // Where an entry went during repacking, the backend copies the padded area over.
+    struct atlas_move {
+        std::string key;
+        atlas_entry from, to;
+    };
+
+    struct texture_atlas {
+
+        texture_atlas(
+            std::uint32_t const initial_page_size = 512, std::uint32_t const maximum_page_size = 2048,
+            std::uint32_t const padding = 1
+        );
+
+        // Nothing is returned when the image can't fit a page at all, those stay standalone textures.
+        auto allocate(std::string const& key, std::uint32_t const width, std::uint32_t const height) -> std::optional<atlas_entry>;
+
+        auto find(std::string const& key) const -> atlas_entry const*;
+
+        // Released space is only reclaimed by repacking.
+        auto release(std::string const& key) -> bool;
+
+        // Worth repacking once enough of the packed area belongs to released entries.
+        auto should_repack() const -> bool;
+
+        // Packs every live entry again from scratch, tallest first. Pages can shrink in count but
+        // never in size, the returned moves describe where everything went.
+        auto repack() -> std::vector<atlas_move>;
+
+        auto get_page_count() const { return static_cast<std::uint32_t>(_pages.size()); }
+        auto get_page_size(std::uint32_t const page) const {
+            return measure::size<std::uint32_t> { _pages[page].get_width(), _pages[page].get_height() };
+        }
+
+        auto get_padding() const { return _padding; }
+        auto get_entry_count() const { return _entries.size(); }
+        auto get_occupancy() const -> float;
+
+        auto fits(std::uint32_t const width, std::uint32_t const height) const {
+            return width + 2 * _padding <= _maximum_page_size && height + 2 * _padding <= _maximum_page_size;
+        }
+
+    private:
+
+        auto place(std::uint32_t const width, std::uint32_t const height) -> std::optional<atlas_entry>;
+
+        std::vector<skyline_packer> _pages;
+        std::unordered_map<std::string, atlas_entry> _entries;
+
+        std::uint32_t _initial_page_size;
+        std::uint32_t _maximum_page_size;
+        std::uint32_t _padding;
+        std::uint64_t _released_area = 0;
+
+    };
+
+    // Copies the image into a buffer padding pixels larger on every side, replicating the edges outward.
+    auto extrude_edges(bitmap const& source, std::uint32_t const padding) -> bitmap;
+
+}
@@ -0,0 +1,53 @@
+#include <algorithm>
+
+#include <graphics/texture_residency.hpp>
+
+namespace chrome::graphics {
+
+    texture_residency::texture_residency(std::uint64_t const budget_bytes) : _budget_bytes(budget_bytes) {}
+
+    auto texture_residency::add(std::string const& key, std::uint64_t const byte_size) -> void {
+
+        remove(key);
+
+        if (_evicted.erase(key)) ++_statistics.reloads;
+
+        _entries.push_front({ key, byte_size, _frame });
+        _index.emplace(key, _entries.begin());
+
+        _statistics.resident_bytes += byte_size;
+        _statistics.peak_resident_bytes = std::max(_statistics.peak_resident_bytes, _statistics.resident_bytes);
+
+    }
+
+    auto texture_residency::touch(std::string const& key) -> void {
+
+        auto lookup_iterator = _index.find(key);
+        if (lookup_iterator == _index.end()) return;
+
+        auto entry_iterator = lookup_iterator->second;
+        entry_iterator->last_used_frame = _frame;
+        _entries.splice(_entries.begin(), _entries, entry_iterator);
+
+    }
+
+    auto texture_residency::remove(std::string const& key) -> void {
+
+        auto lookup_iterator = _index.find(key);
+        if (lookup_iterator == _index.end()) return;
+
+        _statistics.resident_bytes -= lookup_iterator->second->byte_size;
+        _entries.erase(lookup_iterator->second);
+        _index.erase(lookup_iterator);
+
+    }
+
+    auto texture_residency::pin(std::string const& key) -> void {
+        _pinned.insert(key);
+    }
+
+    auto texture_residency::unpin(std::string const& key) -> void {
+        _pinned.erase(key);
+    }
+
+}
@@ -0,0 +1,120 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <utility/lru_cache.hpp>
+
+// Keeps track of which uploaded images are worth their memory. Every image that goes up is added
+// with its size, every draw touches it, and once the total goes over budget the least recently
+// drawn ones are handed back for eviction. Evicted images are decoded again the next time they're drawn.
+
+namespace chrome::graphics {
+
+    struct residency_statistics {
+        std::uint64_t resident_bytes = 0, peak_resident_bytes = 0;
+        std::uint64_t evictions = 0, reloads = 0;
+    };
+
+    struct texture_residency {
+
+        explicit texture_residency(std::uint64_t const budget_bytes = default_budget_bytes);
+
+        texture_residency(texture_residency const&) = delete;
+        texture_residency(texture_residency&&) = default;
+        texture_residency& operator=(texture_residency const&) = delete;
+        texture_residency& operator=(texture_residency&&) = default;
+
+        ~texture_residency() = default;
+
+        // Images drawn during the current frame are never evicted, even if that means going over budget.
+        auto begin_frame() -> void { ++_frame; }
+
+        auto add(std::string const& key, std::uint64_t const byte_size) -> void;
+        auto touch(std::string const& key) -> void;
+        auto remove(std::string const& key) -> void;
+
+        // Pinned images are never evicted, pins can be placed before the image is resident.
+        auto pin(std::string const& key) -> void;
+        auto unpin(std::string const& key) -> void;
+
+        // Hands the least recently used images to evict(key) until the budget is met, returns how many went.
+        template <typename Evict>
+        auto trim(Evict&& evict) -> std::size_t;
+
+        auto set_budget(std::uint64_t const budget_bytes) -> void { _budget_bytes = budget_bytes; }
+        auto get_budget() const { return _budget_bytes; }
+
+        auto is_resident(std::string const& key) const { return _index.find(key) != _index.end(); }
+        auto is_pinned(std::string const& key) const { return _pinned.find(key) != _pinned.end(); }
+        auto is_over_budget() const { return _statistics.resident_bytes > _budget_bytes; }
+
+        auto get_resident_count() const { return _entries.size(); }
+        auto& get_statistics() const { return _statistics; }
+
+        static constexpr std::uint64_t default_budget_bytes = 64ull * 1024 * 1024;
+
+        // Evicted keys are remembered to count reloads, only the most recent ones so images that never
+        // come back don't pile up over a long session.
+        static constexpr std::size_t remembered_evictions = 4096;
+
+    private:
+
+        struct entry {
+            std::string key;
+            std::uint64_t byte_size;
+            std::uint64_t last_used_frame;
+        };
+
+        // Most recently used first.
+        std::list<entry> _entries;
+        std::unordered_map<std::string, std::list<entry>::iterator> _index;
+
+        std::unordered_set<std::string> _pinned;
+        utility::lru_cache<std::string, bool> _evicted { remembered_evictions }; // Only the keys matter.
+
+        std::uint64_t _budget_bytes;
+        std::uint64_t _frame = 0;
+
+        residency_statistics _statistics;
+
+    };
+
+    template <typename Evict>
+    auto texture_residency::trim(Evict&& evict) -> std::size_t {
+
+        std::size_t evicted = 0;
+
+        for (auto entry_iterator = _entries.end(); is_over_budget() && entry_iterator != _entries.begin();) {
+
+            --entry_iterator;
+
+            // Everything further up the list has been used this frame as well.
+            if (entry_iterator->last_used_frame == _frame) break;
+            if (is_pinned(entry_iterator->key)) continue;
+
+            auto key = std::move(entry_iterator->key);
+            _statistics.resident_bytes -= entry_iterator->byte_size;
+            _index.erase(key);
+            entry_iterator = _entries.erase(entry_iterator);
+
+            ++_statistics.evictions;
+            ++evicted;
+
+            evict(key);
+            _evicted.insert(std::move(key), true);
+
+        }
+
+        return evicted;
+
+    }
+
+}
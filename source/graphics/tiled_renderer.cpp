@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include <graphics/tiled_renderer.hpp>
+#include <graphics/pixel_kernels.hpp>
+#include <utility/profiler.hpp>
+
+namespace chrome::graphics {
+
+    tiled_renderer::tiled_renderer(std::uint32_t const width, std::uint32_t const height, utility::work_stealing_pool& pool, float const dpi)
+    : _target(width, height), _dpi(dpi), _pool(pool) {
+
+        _tile_renderers.reserve(pool.get_worker_count());
+
+        for (std::size_t worker = 0; worker < pool.get_worker_count(); ++worker) {
+
+            // All of them draw straight into the target, each clipped to the tile it's on.
+            // Workers only ever read the resolved images, the caller's provider isn't assumed to be thread safe.
+            auto& renderer = _tile_renderers.emplace_back(0, 0, dpi);
+            renderer.set_shared_target(&_target);
+            renderer.set_image_provider([this](resource::image const& image) -> bitmap const* {
+                auto found = _images.find(&image);
+                return found != _images.end() ? found->second : nullptr;
+            });
+
+        }
+
+    }
+
+    auto tiled_renderer::set_image_provider(image_provider provider) -> void {
+        _image_provider = std::move(provider);
+    }
+
+    auto tiled_renderer::render(command_list const& commands) -> void {
+        render(commands, { 0, 0, static_cast<std::int32_t>(_target.width), static_cast<std::int32_t>(_target.height) });
+    }
+
+    auto tiled_renderer::render(command_list const& commands, measure::rectangle<std::int32_t> const& update_area) -> void {
+
+        CHROME_PROFILE_ZONE("tiled_renderer::render");
+
+        _update_area = measure::intersect(update_area, { 0, 0, static_cast<std::int32_t>(_target.width), static_cast<std::int32_t>(_target.height) });
+        _statistics = {};
+
+        if (_update_area.is_empty()) return;
+
+        auto first_column = _update_area.origin.x / tile_width, first_row = _update_area.origin.y / tile_height;
+        auto last_column = (_update_area.right() - 1) / tile_width, last_row = (_update_area.bottom() - 1) / tile_height;
+        _tile_range = { first_column, first_row, last_column - first_column + 1, last_row - first_row + 1 };
+
+        _commands = &commands;
+        bin(commands);
+
+        _pool.run(_bins.size(), [this](std::size_t const tile, std::size_t const worker) {
+            render_tile(tile, worker);
+        });
+
+        _commands = nullptr;
+
+    }
+
+    auto tiled_renderer::resize_buffers(std::uint32_t const width, std::uint32_t const height) -> void {
+        _target = bitmap { width, height };
+    }
+
+    auto tiled_renderer::bin(command_list const& commands) -> void {
+
+        CHROME_PROFILE_ZONE("tiled_renderer::bin");
+
+        auto tile_count = static_cast<std::size_t>(_tile_range.dimension.width) * static_cast<std::size_t>(_tile_range.dimension.height);
+        _bins.resize(tile_count);
+        for (auto& tile_bin : _bins) tile_bin.clear();
+
+        _transforms.clear();
+        _primitives.clear();
+        _images.clear();
+
+        // Accumulated the same way the tile renderers do, so every draw sees the exact same transform.
+        transform_stack transforms;
+        _transforms.push_back(transforms.top());
+
+        auto scale = transform::scale(_dpi / 96.0f, _dpi / 96.0f);
+        auto device = transforms.top() * scale;
+
+        commands.visit([&](command_type, auto const& command) {
+
+            using command_t = std::decay_t<decltype(command)>;
+            auto current = static_cast<std::uint32_t>(_transforms.size() - 1);
+
+            if constexpr (std::is_same_v<command_t, command::push_transform> || std::is_same_v<command_t, command::pop_transform>) {
+
+                if constexpr (std::is_same_v<command_t, command::push_transform>) transforms.push(command.transform);
+                else transforms.pop();
+
+                _transforms.push_back(transforms.top());
+                device = transforms.top() * scale;
+
+            }
+
+            else if constexpr (std::is_same_v<command_t, command::fill_rectangle>)
+                bin({ command, current }, command.area, device);
+
+            else if constexpr (std::is_same_v<command_t, command::draw_line>)
+                bin({ command, current }, software_renderer::get_device_line_bounds(device, command.start, command.end, command.stroke_width), transform::identity());
+
+            else if constexpr (std::is_same_v<command_t, command::draw_image>) {
+
+                auto [found, is_new] = _images.try_emplace(command.image, nullptr);
+                if (is_new && _image_provider) found->second = _image_provider(*command.image);
+
+                auto source = found->second;
+                if (source == nullptr || source->width == 0 || source->height == 0) return;
+
+                bin({ command, current }, {
+                    command.top_left, { static_cast<float>(source->width) * command.scale, static_cast<float>(source->height) * command.scale }
+                }, device);
+
+            }
+
+            else if constexpr (std::is_same_v<command_t, command::draw_text>)
+                bin({ command, current }, software_renderer::get_text_bounds(commands.get_string(command.text), command.top_left, command.font_size), device);
+
+        });
+
+        _statistics.tiles = static_cast<std::uint32_t>(tile_count);
+        _statistics.primitives = static_cast<std::uint32_t>(_primitives.size());
+        _statistics.empty_tiles = static_cast<std::uint32_t>(std::count_if(_bins.begin(), _bins.end(), [](auto const& tile_bin) { return tile_bin.empty(); }));
+
+    }
+
+    auto tiled_renderer::bin(primitive const& binned, measure::rectangle<float> const& local_bounds, transform const& device) -> void {
+
+        auto bounds = measure::transform_bounds(device, local_bounds);
+
+        // Antialiased and rounded edges can reach a pixel past the exact bounds. Clamped as floats,
+        // bounds way off screen don't fit an integer.
+        auto to_tile = [](float const coordinate, std::int32_t const size, std::int32_t const first, std::int32_t const last) {
+            return static_cast<std::int32_t>(std::clamp(std::floor(coordinate / static_cast<float>(size)), static_cast<float>(first), static_cast<float>(last)));
+        };
+
+        auto& range = _tile_range;
+        if (bounds.right() + 1.0f < static_cast<float>(_update_area.origin.x) || bounds.origin.x - 1.0f >= static_cast<float>(_update_area.right())) return;
+        if (bounds.bottom() + 1.0f < static_cast<float>(_update_area.origin.y) || bounds.origin.y - 1.0f >= static_cast<float>(_update_area.bottom())) return;
+
+        auto first_column = to_tile(bounds.origin.x - 1.0f, tile_width, range.origin.x, range.right() - 1);
+        auto last_column = to_tile(bounds.right() + 1.0f, tile_width, range.origin.x, range.right() - 1);
+        auto first_row = to_tile(bounds.origin.y - 1.0f, tile_height, range.origin.y, range.bottom() - 1);
+        auto last_row = to_tile(bounds.bottom() + 1.0f, tile_height, range.origin.y, range.bottom() - 1);
+
+        auto index = static_cast<std::uint32_t>(_primitives.size());
+        _primitives.push_back(binned);
+
+        for (auto row = first_row; row <= last_row; ++row) {
+            for (auto column = first_column; column <= last_column; ++column) {
+                auto tile = static_cast<std::size_t>(row - range.origin.y) * static_cast<std::size_t>(range.dimension.width) + static_cast<std::size_t>(column - range.origin.x);
+                _bins[tile].push_back(index);
+            }
+        }
+
+        _statistics.binned += static_cast<std::uint64_t>(last_row - first_row + 1) * static_cast<std::uint64_t>(last_column - first_column + 1);
+
+    }
+
+    auto tiled_renderer::render_tile(std::size_t const tile, std::size_t const worker) -> void {
+
+        auto area = measure::intersect(get_tile_area(tile), _update_area);
+
+        auto& tile_bin = _bins[tile];
+        if (tile_bin.empty()) {
+
+            for (auto y = area.origin.y; y < area.bottom(); ++y)
+                kernels::get_kernels().fill_span(_target.row(static_cast<std::uint32_t>(y)) + area.origin.x, static_cast<std::size_t>(area.dimension.width), 0u);
+
+            return;
+
+        }
+
+        auto& renderer = _tile_renderers[worker];
+        renderer.begin_draw(area);
+
+        // The recorded transform is pushed onto the renderer's identity, which leaves it exactly as is.
+        for (auto index : tile_bin) {
+
+            auto& [binned, transform_index] = _primitives[index];
+            renderer.push_transform(_transforms[transform_index]);
+
+            std::visit([this, &renderer](auto const& command) {
+
+                using command_t = std::decay_t<decltype(command)>;
+
+                if constexpr (std::is_same_v<command_t, command::fill_rectangle>)
+                    renderer.fill_rectangle(command.area, command.color);
+
+                else if constexpr (std::is_same_v<command_t, command::draw_line>)
+                    renderer.draw_line(command.start, command.end, command.stroke_width, command.color);
+
+                else if constexpr (std::is_same_v<command_t, command::draw_image>)
+                    renderer.draw_image(command.image, command.scale, command.top_left, command.opacity);
+
+                else if constexpr (std::is_same_v<command_t, command::draw_text>)
+                    renderer.draw_text(
+                        _commands->get_string(command.text), command.top_left, get_font_family(command.font_family),
+                        command.font_size, command.color, command.weight
+                    );
+
+            }, binned);
+
+            renderer.pop_transform();
+
+        }
+
+        renderer.end_draw();
+
+    }
+
+    auto tiled_renderer::get_tile_area(std::size_t const tile) const -> measure::rectangle<std::int32_t> {
+
+        auto column = _tile_range.origin.x + static_cast<std::int32_t>(tile % static_cast<std::size_t>(_tile_range.dimension.width));
+        auto row = _tile_range.origin.y + static_cast<std::int32_t>(tile / static_cast<std::size_t>(_tile_range.dimension.width));
+
+        return { column * tile_width, row * tile_height, tile_width, tile_height };
+
+    }
+
+}
@@ -0,0 +1,102 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include <utility/measure.hpp>
+#include <utility/work_stealing_pool.hpp>
+#include <graphics/bitmap.hpp>
+#include <graphics/command_list.hpp>
+#include <graphics/software_renderer.hpp>
+#include <graphics/transform.hpp>
+
+// Software rasterization split over a work stealing pool. A single threaded pass walks the command list
+// once and sorts every draw into the fixed size tiles its device bounds touch, then every tile is drawn
+// on its own by whichever worker gets to it, through a software_renderer clipped to the tile. Each tile
+// only writes its own pixels and draws in command order, so the output is the same for any number of
+// threads and matches rendering the whole target with a single software_renderer.
+
+namespace chrome::graphics {
+
+    struct tiling_statistics {
+        std::uint32_t tiles = 0;
+        std::uint32_t empty_tiles = 0; // Nothing binned, cleared without a renderer.
+        std::uint32_t primitives = 0;
+        std::uint64_t binned = 0; // Primitive and tile pairs, a primitive lands in every tile it touches.
+    };
+
+    struct tiled_renderer {
+
+        // Wide rather than square, every row of a draw has a fixed setup cost on top of its pixels.
+        static constexpr std::int32_t tile_width = 256, tile_height = 32;
+
+        using image_provider = software_renderer::image_provider;
+
+        tiled_renderer(std::uint32_t const width, std::uint32_t const height, utility::work_stealing_pool& pool, float const dpi = 96.0f);
+
+        tiled_renderer(tiled_renderer const&) = delete;
+        tiled_renderer(tiled_renderer&&) = delete;
+        tiled_renderer& operator=(tiled_renderer const&) = delete;
+        tiled_renderer& operator=(tiled_renderer&&) = delete;
+
+        ~tiled_renderer() = default;
+
+        // Only called from the thread calling render, images are resolved while binning.
+        auto set_image_provider(image_provider provider) -> void;
+
+        // Without an update area the whole target is redrawn, otherwise only tiles it touches and
+        // only pixels inside it. Returns once every tile is done.
+        auto render(command_list const& commands) -> void;
+        auto render(command_list const& commands, measure::rectangle<std::int32_t> const& update_area) -> void;
+
+        auto resize_buffers(std::uint32_t const width, std::uint32_t const height) -> void;
+
+        auto get_target() const -> bitmap const& { return _target; }
+
+        // Of the last render.
+        auto get_statistics() const -> tiling_statistics const& { return _statistics; }
+
+    private:
+
+        using primitive_command = std::variant<command::fill_rectangle, command::draw_line, command::draw_image, command::draw_text>;
+
+        struct primitive {
+            primitive_command command;
+            std::uint32_t transform; // Into _transforms, the accumulated transform in DIPs.
+        };
+
+        auto bin(command_list const& commands) -> void;
+        auto bin(primitive const& binned, measure::rectangle<float> const& local_bounds, transform const& device) -> void;
+
+        auto render_tile(std::size_t const tile, std::size_t const worker) -> void;
+
+        auto get_tile_area(std::size_t const tile) const -> measure::rectangle<std::int32_t>;
+
+        bitmap _target;
+        float _dpi = 96.0f;
+
+        utility::work_stealing_pool& _pool;
+        std::vector<software_renderer> _tile_renderers; // One per worker.
+
+        image_provider _image_provider;
+        std::unordered_map<resource::image const*, bitmap const*> _images; // Resolved for this render.
+
+        // Tiles covering the update area of the current render, row major.
+        measure::rectangle<std::int32_t> _update_area;
+        measure::rectangle<std::int32_t> _tile_range;
+        command_list const* _commands = nullptr;
+
+        std::vector<transform> _transforms;
+        std::vector<primitive> _primitives;
+        std::vector<std::vector<std::uint32_t>> _bins;
+
+        tiling_statistics _statistics;
+
+    };
+
+}
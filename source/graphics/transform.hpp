@@ -0,0 +1,61 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+
+#include <utility/affine.hpp>
+
+namespace chrome::graphics {
+
+    using transform = measure::affine2d;
+
+    // Accumulated transforms of nested push/pop pairs, with inline storage so a frame's worth of
+    // pushes never touches the heap. The bottom entry is always the identity.
+    struct transform_stack {
+
+        static constexpr std::size_t capacity = 32;
+
+        transform_stack() { reset(); }
+
+        // Composed with the current top, so the pushed transform applies inside the ones below it.
+        auto push(transform const& local) -> transform const& {
+
+            if (_depth == capacity) throw std::length_error { "Transform stack overflow." };
+
+            _transforms[_depth] = local * _transforms[_depth - 1];
+            return _transforms[_depth++];
+
+        }
+
+        // The identity at the bottom is never popped, an unbalanced pop is as much a bug as too deep a push.
+        auto pop() -> transform const& {
+
+            if (_depth == 1) throw std::out_of_range { "Transform stack underflow." };
+
+            --_depth;
+            return _transforms[_depth - 1];
+
+        }
+
+        auto reset() -> void {
+
+            _transforms[0] = transform::identity();
+            _depth = 1;
+
+        }
+
+        auto top() const -> transform const& { return _transforms[_depth - 1]; }
+        auto get_depth() const { return _depth; }
+
+    private:
+
+        std::array<transform, capacity> _transforms;
+        std::size_t _depth = 1;
+
+    };
+
+}
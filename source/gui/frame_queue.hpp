@@ -0,0 +1,84 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include <utility/spsc_queue.hpp>
+
+// Frames are described on the UI thread and rendered on the render thread. The queue is short on purpose:
+// a renderer that falls behind pushes back, submitting fails and the UI keeps collecting changes into the
+// next frame instead of piling up stale ones. Whatever is queued anyway collapses into the latest frame.
+
+namespace chrome::gui {
+
+    struct frame_queue_statistics {
+        std::uint64_t submitted = 0;
+        std::uint64_t rejected = 0;     // Submitted into a full queue.
+        std::uint64_t acquired = 0;     // Handed to the renderer.
+        std::uint64_t dropped = 0;      // Superseded by a later frame before the renderer got to them.
+    };
+
+    template <typename Frame, std::size_t Capacity = 2>
+    struct frame_queue {
+
+        // UI thread. The frame is only described if there's room for it, so a rejected one costs nothing.
+        template <typename Describe>
+        auto try_submit(Describe&& describe) -> bool {
+
+            if (_frames.is_full()) {
+                _rejected.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            // Can't fail, the consumer only ever makes room.
+            Frame frame = describe();
+            _frames.try_push(frame);
+            _submitted.fetch_add(1, std::memory_order_relaxed);
+
+            return true;
+
+        }
+
+        // Render thread. Latest frame wins, every older one is folded into the one after it with
+        // merge(later, std::move(older)), oldest first, so no change described by the UI gets lost.
+        template <typename Merge>
+        auto acquire_latest(Merge&& merge) -> std::optional<Frame> {
+
+            auto latest = _frames.try_pop();
+            if (!latest) return std::nullopt;
+
+            while (auto next = _frames.try_pop()) {
+                merge(*next, std::move(*latest));
+                latest = std::move(next);
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            _acquired.fetch_add(1, std::memory_order_relaxed);
+            return latest;
+
+        }
+
+        // Any thread, the counters are read one at a time.
+        auto get_statistics() const {
+            return frame_queue_statistics {
+                _submitted.load(std::memory_order_relaxed), _rejected.load(std::memory_order_relaxed),
+                _acquired.load(std::memory_order_relaxed), _dropped.load(std::memory_order_relaxed)
+            };
+        }
+
+    private:
+
+        utility::spsc_queue<Frame, Capacity> _frames;
+
+        std::atomic<std::uint64_t> _submitted { 0 }, _rejected { 0 };
+        std::atomic<std::uint64_t> _acquired { 0 }, _dropped { 0 };
+
+    };
+
+}
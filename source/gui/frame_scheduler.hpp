@@ -0,0 +1,115 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <utility>
+
+// Decides when a frame gets painted, so the message loop can sleep in between.
+// Repaint requests are coalesced and paced to the display refresh, a hidden window never wakes
+// the loop on its own. The clock is a template parameter, so pacing can be driven by a manual clock.
+
+namespace chrome::gui {
+
+    template <typename Clock = std::chrono::steady_clock>
+    struct basic_frame_scheduler {
+
+        using time_point = typename Clock::time_point;
+        using duration = typename Clock::duration;
+
+        basic_frame_scheduler(Clock clock = {}, duration const refresh_interval = default_refresh_interval())
+        : _clock(std::move(clock)), _refresh_interval(refresh_interval) {}
+
+        static constexpr auto default_refresh_interval() {
+            return std::chrono::duration_cast<duration>(std::chrono::duration<double>(1.0 / 60.0));
+        }
+
+        auto set_refresh_interval(duration const refresh_interval) -> void {
+            if (refresh_interval > duration::zero()) _refresh_interval = refresh_interval;
+        }
+
+        // Something got invalidated, a frame will be produced at the next refresh slot.
+        auto request_frame() -> void {
+            _frame_requested = true;
+        }
+
+        // Timer driven frames (animations, caret blinking), the earliest deadline wins.
+        auto request_frame_at(time_point const deadline) -> void {
+            _timer_deadline = _timer_deadline ? std::min(*_timer_deadline, deadline) : deadline;
+        }
+
+        // Minimized or occluded windows go fully idle, becoming visible again repaints.
+        auto set_visible(bool const visible) -> void {
+
+            if (visible && !_visible) _frame_requested = true;
+            _visible = visible;
+
+        }
+
+        // How long the loop may block waiting for messages, no value means indefinitely.
+        auto get_wait_timeout() const -> std::optional<duration> {
+
+            if (!_visible) return std::nullopt;
+
+            auto now = _clock.now();
+
+            if (_frame_requested) return std::max(duration::zero(), get_next_slot() - now);
+            if (_timer_deadline) return std::max(duration::zero(), std::max(*_timer_deadline, get_next_slot()) - now);
+
+            return std::nullopt;
+
+        }
+
+        // Returns true once per refresh slot when there's something to paint, the caller paints right after.
+        auto begin_frame() -> bool {
+
+            auto now = _clock.now();
+
+            if (_timer_deadline && now >= *_timer_deadline) {
+                _timer_deadline.reset();
+                _frame_requested = true;
+            }
+
+            if (!_visible || !_frame_requested || now < get_next_slot()) return false;
+
+            // Stay on the refresh cadence unless we've been idle for longer than a frame.
+            auto slot = get_next_slot();
+            _last_frame = _last_frame && now - slot < _refresh_interval ? slot : now;
+            _frame_requested = false;
+            ++_frame_count;
+
+            return true;
+
+        }
+
+        auto has_pending_frame() const { return _frame_requested || _timer_deadline.has_value(); }
+        auto is_visible() const { return _visible; }
+        auto get_frame_count() const { return _frame_count; }
+        auto get_refresh_interval() const { return _refresh_interval; }
+
+        auto& get_clock() { return _clock; }
+
+    private:
+
+        auto get_next_slot() const {
+            return _last_frame ? *_last_frame + _refresh_interval : time_point {};
+        }
+
+        Clock _clock;
+        duration _refresh_interval;
+
+        std::optional<time_point> _last_frame;
+        std::optional<time_point> _timer_deadline;
+
+        bool _frame_requested = false;
+        bool _visible = true;
+        unsigned long long _frame_count = 0;
+
+    };
+
+    using frame_scheduler = basic_frame_scheduler<>;
+
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+
+#include <gui/hit_test_map.hpp>
+
+namespace chrome::gui {
+
+    hit_test_map::hit_test_map(std::int32_t const cell_size) : _cell_size(std::max(cell_size, 1)) {}
+
+    auto hit_test_map::reset(measure::rectangle<std::int32_t> const& bounds) -> void {
+
+        _bounds = bounds;
+        _regions.clear();
+        _cell_offsets.clear();
+        _cell_regions.clear();
+        _columns = _rows = 0;
+
+    }
+
+    auto hit_test_map::add_resize_borders(std::int32_t const border) -> void {
+
+        auto left = _bounds.origin.x, top = _bounds.origin.y;
+        auto right = _bounds.right(), bottom = _bounds.bottom();
+        auto width = _bounds.dimension.width, height = _bounds.dimension.height;
+
+        // Half open areas matching the strict comparisons classify_window_sector makes, e.g. x > right - border.
+        auto near_right = right - border + 1, near_bottom = bottom - border + 1;
+
+        auto add_border = [this](measure::rectangle<std::int32_t> const& area, window_sector sector) {
+            add(area, { hit_region_kind::resize_border, sector, 0 });
+        };
+
+        add_border({ left, top, border, border }, window_sector::top_left);
+        add_border({ near_right, top, right - near_right, border }, window_sector::top_right);
+        add_border({ near_right, near_bottom, right - near_right, bottom - near_bottom }, window_sector::bottom_right);
+        add_border({ left, near_bottom, border, bottom - near_bottom }, window_sector::bottom_left);
+
+        add_border({ left + 1, top, width - 1, border }, window_sector::top);
+        add_border({ left + 1, near_bottom, width - 1, bottom - near_bottom }, window_sector::bottom);
+        add_border({ left, top + 1, border, height - 1 }, window_sector::left);
+        add_border({ near_right, top + 1, right - near_right, height - 1 }, window_sector::right);
+
+    }
+
+    auto hit_test_map::add_caption(measure::rectangle<std::int32_t> const& area) -> void {
+        add(area, { hit_region_kind::caption, window_sector::caption, 0 });
+    }
+
+    auto hit_test_map::add_interactive(measure::rectangle<std::int32_t> const& area, std::uint32_t const id) -> void {
+        add(area, { hit_region_kind::interactive, window_sector::nowhere, id });
+    }
+
+    auto hit_test_map::add(measure::rectangle<std::int32_t> const& area, hit_test_result const& result) -> void {
+
+        auto clipped = measure::intersect(area, _bounds);
+        if (clipped.is_empty()) return;
+
+        _regions.push_back({ clipped, result });
+
+    }
+
+    auto hit_test_map::build() -> void {
+
+        // Query order is kind first (borders over interactive over caption). Borders keep the order they were
+        // added in (corners first), interactive regions go latest first since they're stacked on top of each other.
+        // Sorting the regions once means every cell's list ends up in that order and a query stops at the first hit.
+        std::vector<std::uint32_t> order(_regions.size());
+        for (std::uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+
+        std::sort(order.begin(), order.end(), [this](std::uint32_t lhs, std::uint32_t rhs) {
+            auto lhs_kind = _regions[lhs].result.kind, rhs_kind = _regions[rhs].result.kind;
+            if (lhs_kind != rhs_kind) return lhs_kind < rhs_kind;
+            return lhs_kind == hit_region_kind::interactive ? lhs > rhs : lhs < rhs;
+        });
+
+        std::vector<region> sorted_regions;
+        sorted_regions.reserve(_regions.size());
+        for (auto index : order) sorted_regions.push_back(_regions[index]);
+        _regions = std::move(sorted_regions);
+
+        _columns = (_bounds.dimension.width + _cell_size - 1) / _cell_size;
+        _rows = (_bounds.dimension.height + _cell_size - 1) / _cell_size;
+
+        auto cell_count = static_cast<std::size_t>(std::max(_columns, 0)) * static_cast<std::size_t>(std::max(_rows, 0));
+        _cell_offsets.assign(cell_count + 1, 0u);
+
+        auto for_each_cell = [this](measure::rectangle<std::int32_t> const& area, auto&& visit) {
+
+            auto first_column = (area.origin.x - _bounds.origin.x) / _cell_size;
+            auto last_column = (area.right() - 1 - _bounds.origin.x) / _cell_size;
+            auto first_row = (area.origin.y - _bounds.origin.y) / _cell_size;
+            auto last_row = (area.bottom() - 1 - _bounds.origin.y) / _cell_size;
+
+            for (auto row = first_row; row <= last_row; ++row)
+                for (auto column = first_column; column <= last_column; ++column)
+                    visit(static_cast<std::size_t>(row) * static_cast<std::size_t>(_columns) + static_cast<std::size_t>(column));
+
+        };
+
+        // Counting pass, then a prefix sum and a filling pass.
+        for (auto& [area, result] : _regions) for_each_cell(area, [this](std::size_t cell) { ++_cell_offsets[cell + 1]; });
+        for (std::size_t cell = 0; cell < cell_count; ++cell) _cell_offsets[cell + 1] += _cell_offsets[cell];
+
+        _cell_regions.resize(_cell_offsets.back());
+        auto cursors = std::vector<std::uint32_t>(_cell_offsets.begin(), _cell_offsets.end() - 1);
+
+        for (std::uint32_t index = 0; index < _regions.size(); ++index)
+            for_each_cell(_regions[index].area, [this, &cursors, index](std::size_t cell) { _cell_regions[cursors[cell]++] = index; });
+
+    }
+
+    auto hit_test_map::hit_test(measure::point<std::int32_t> const& point) const -> hit_test_result {
+
+        if (!_bounds.contains(point) || _columns == 0) return {};
+
+        auto column = static_cast<std::size_t>((point.x - _bounds.origin.x) / _cell_size);
+        auto row = static_cast<std::size_t>((point.y - _bounds.origin.y) / _cell_size);
+        auto cell = row * static_cast<std::size_t>(_columns) + column;
+
+        for (auto i = _cell_offsets[cell]; i < _cell_offsets[cell + 1]; ++i) {
+            auto& [area, result] = _regions[_cell_regions[i]];
+            if (area.contains(point)) return result;
+        }
+
+        return {};
+
+    }
+
+}
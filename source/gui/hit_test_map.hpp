@@ -0,0 +1,75 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <utility/measure.hpp>
+#include <gui/window_sector.hpp>
+
+// Answers WM_NCHITTEST without touching the window. Resize borders, caption drag areas and interactive
+// chrome (tabs, buttons) are registered once per resize or layout change and bucketed into a uniform
+// grid, so a query only looks at the few regions overlapping the cursor's cell.
+
+namespace chrome::gui {
+
+    enum struct hit_region_kind : std::uint8_t {
+        nowhere,
+        resize_border,
+        interactive,
+        caption
+    };
+
+    struct hit_test_result {
+        hit_region_kind kind = hit_region_kind::nowhere;
+        window_sector sector = window_sector::nowhere;  // Which border, or caption for drag areas.
+        std::uint32_t id = 0;                           // Interactive regions only.
+    };
+
+    struct hit_test_map {
+
+        explicit hit_test_map(std::int32_t const cell_size = 32);
+
+        // Starts over, bounds is the window in whatever coordinates queries come in.
+        auto reset(measure::rectangle<std::int32_t> const& bounds) -> void;
+
+        // The same sectors classify_window_sector produces, border pixels in from every edge.
+        auto add_resize_borders(std::int32_t const border) -> void;
+
+        auto add_caption(measure::rectangle<std::int32_t> const& area) -> void;
+
+        // Interactive regions win over the caption they sit in, later ones over earlier ones.
+        auto add_interactive(measure::rectangle<std::int32_t> const& area, std::uint32_t const id) -> void;
+
+        // Has to be called after adding regions and before querying.
+        auto build() -> void;
+
+        auto hit_test(measure::point<std::int32_t> const& point) const -> hit_test_result;
+
+        auto get_bounds() const -> measure::rectangle<std::int32_t> const& { return _bounds; }
+        auto get_region_count() const { return _regions.size(); }
+
+    private:
+
+        struct region {
+            measure::rectangle<std::int32_t> area;
+            hit_test_result result;
+        };
+
+        auto add(measure::rectangle<std::int32_t> const& area, hit_test_result const& result) -> void;
+
+        measure::rectangle<std::int32_t> _bounds;
+        std::vector<region> _regions;
+
+        // Region indices per cell, stored back to back in query priority order.
+        std::vector<std::uint32_t> _cell_offsets;
+        std::vector<std::uint32_t> _cell_regions;
+
+        std::int32_t _cell_size;
+        std::int32_t _columns = 0, _rows = 0;
+
+    };
+
+}
@@ -0,0 +1,290 @@
+#include <algorithm>
+
+#include <gui/layout_tree.hpp>
+
+namespace chrome::gui {
+
+    namespace {
+
+        auto same_length(layout_length const& lhs, layout_length const& rhs) {
+            return lhs.value == rhs.value && lhs.is_flexible == rhs.is_flexible;
+        }
+
+        auto same_margin(layout_margin const& lhs, layout_margin const& rhs) {
+            return lhs.left == rhs.left && lhs.top == rhs.top && lhs.right == rhs.right && lhs.bottom == rhs.bottom;
+        }
+
+        auto same_bounds(measure::rectangle<float> const& lhs, measure::rectangle<float> const& rhs) {
+            return lhs.origin.x == rhs.origin.x && lhs.origin.y == rhs.origin.y
+                && lhs.dimension.width == rhs.dimension.width && lhs.dimension.height == rhs.dimension.height;
+        }
+
+        auto get_alignment_factor(layout_alignment const alignment) {
+
+            switch (alignment) {
+                case layout_alignment::start:  return 0.0f;
+                case layout_alignment::center: return 0.5f;
+                case layout_alignment::end:    return 1.0f;
+            }
+
+            return 0.0f;
+
+        }
+
+    }
+
+    layout_tree::layout_tree() {
+
+        add(none);
+
+    }
+
+    auto layout_tree::add(layout_id const parent, layout_direction const direction) -> layout_id {
+
+        auto id = static_cast<layout_id>(_parent.size());
+
+        _parent.push_back(parent);
+        _first_child.push_back(none);
+        _last_child.push_back(none);
+        _next_sibling.push_back(none);
+        _depth.push_back(parent != none ? _depth[parent] + 1 : 0);
+
+        _direction.push_back(direction);
+        _alignment.push_back(layout_alignment::start);
+        _spacing.push_back(0.0f);
+        _width.push_back(flexible_length());
+        _height.push_back(flexible_length());
+        _margin.push_back({});
+
+        _bounds.push_back({ 0.0f, 0.0f, 0.0f, 0.0f });
+        _is_marked.push_back(0);
+        _has_moved.push_back(0);
+
+        if (parent == none) return id;
+
+        if (_last_child[parent] == none) _first_child[parent] = id;
+        else _next_sibling[_last_child[parent]] = id;
+
+        _last_child[parent] = id;
+        mark(parent);
+
+        return id;
+
+    }
+
+    auto layout_tree::set_root_bounds(measure::rectangle<float> const& bounds) -> void {
+
+        if (move(root, bounds)) mark(root);
+
+    }
+
+    auto layout_tree::set_width(layout_id const id, layout_length const width) -> void {
+
+        if (same_length(_width[id], width)) return;
+
+        _width[id] = width;
+        if (id != root) mark(_parent[id]);
+
+    }
+
+    auto layout_tree::set_height(layout_id const id, layout_length const height) -> void {
+
+        if (same_length(_height[id], height)) return;
+
+        _height[id] = height;
+        if (id != root) mark(_parent[id]);
+
+    }
+
+    auto layout_tree::set_margin(layout_id const id, layout_margin const& margin) -> void {
+
+        if (same_margin(_margin[id], margin)) return;
+
+        _margin[id] = margin;
+        if (id != root) mark(_parent[id]);
+
+    }
+
+    auto layout_tree::set_direction(layout_id const id, layout_direction const direction) -> void {
+
+        if (_direction[id] == direction) return;
+
+        _direction[id] = direction;
+        mark(id);
+
+    }
+
+    auto layout_tree::set_alignment(layout_id const id, layout_alignment const alignment) -> void {
+
+        if (_alignment[id] == alignment) return;
+
+        _alignment[id] = alignment;
+        mark(id);
+
+    }
+
+    auto layout_tree::set_spacing(layout_id const id, float const spacing) -> void {
+
+        if (_spacing[id] == spacing) return;
+
+        _spacing[id] = spacing;
+        mark(id);
+
+    }
+
+    auto layout_tree::update() -> void {
+
+        if (_marked.empty()) return;
+
+        // Outer containers first, laying one out may move (and so lay out) marked ones further down, those
+        // are skipped once they come up.
+        std::stable_sort(_marked.begin(), _marked.end(), [this](layout_id lhs, layout_id rhs) { return _depth[lhs] < _depth[rhs]; });
+
+        for (auto marked : _marked) {
+
+            if (!_is_marked[marked]) continue;
+
+            _pending.push_back(marked);
+            while (!_pending.empty()) {
+
+                auto id = _pending.back();
+                _pending.pop_back();
+
+                _is_marked[id] = 0;
+                ++_statistics.containers_laid_out;
+
+                lay_out_children(id, _pending);
+
+            }
+
+        }
+
+        _marked.clear();
+
+    }
+
+    auto layout_tree::clear_changes() -> void {
+
+        for (auto id : _moved) _has_moved[id] = 0;
+
+        _moved.clear();
+
+    }
+
+    auto layout_tree::mark(layout_id const id) -> void {
+
+        if (_is_marked[id]) return;
+
+        _is_marked[id] = 1;
+        _marked.push_back(id);
+
+    }
+
+    auto layout_tree::move(layout_id const id, measure::rectangle<float> const& bounds) -> bool {
+
+        if (same_bounds(_bounds[id], bounds)) return false;
+
+        _bounds[id] = bounds;
+
+        ++_statistics.nodes_moved;
+        if (!_has_moved[id]) {
+            _has_moved[id] = 1;
+            _moved.push_back(id);
+        }
+
+        return true;
+
+    }
+
+    auto layout_tree::lay_out_children(layout_id const id, std::vector<layout_id>& pending) -> void {
+
+        auto box = _bounds[id];
+        auto alignment = get_alignment_factor(_alignment[id]);
+
+        // Boxes are absolute, so a child that moved takes everything inside it along.
+        auto place = [&](layout_id const child, measure::rectangle<float> const& bounds) {
+            if (move(child, bounds) && _first_child[child] != none) pending.push_back(child);
+        };
+
+        // Across a row or column, or along either axis of a stack.
+        auto place_across = [alignment](layout_length const& length, float const start, float const extent, float const margin_before, float const margin_after) {
+
+            auto available = extent - margin_before - margin_after;
+            auto size = length.is_flexible ? std::max(available, 0.0f) : length.value;
+
+            return std::pair { start + margin_before + (available - size) * alignment, size };
+
+        };
+
+        if (_direction[id] == layout_direction::stack) {
+
+            for (auto child = _first_child[id]; child != none; child = _next_sibling[child]) {
+
+                auto& margin = _margin[child];
+                auto [x, width] = place_across(_width[child], box.origin.x, box.dimension.width, margin.left, margin.right);
+                auto [y, height] = place_across(_height[child], box.origin.y, box.dimension.height, margin.top, margin.bottom);
+
+                place(child, { x, y, width, height });
+
+            }
+
+            return;
+
+        }
+
+        auto is_row = _direction[id] == layout_direction::row;
+        auto& main_lengths = is_row ? _width : _height;
+        auto& cross_lengths = is_row ? _height : _width;
+
+        auto main_start = is_row ? box.origin.x : box.origin.y;
+        auto main_extent = is_row ? box.dimension.width : box.dimension.height;
+        auto cross_start = is_row ? box.origin.y : box.origin.x;
+        auto cross_extent = is_row ? box.dimension.height : box.dimension.width;
+
+        // Fixed sizes, margins and spacing come off the top, flexible children split the rest.
+        auto spacing = _spacing[id];
+        auto fixed_total = 0.0f, flexible_total = 0.0f;
+        auto child_count = 0u;
+
+        for (auto child = _first_child[id]; child != none; child = _next_sibling[child]) {
+
+            auto& margin = _margin[child];
+            auto& length = main_lengths[child];
+
+            fixed_total += is_row ? margin.left + margin.right : margin.top + margin.bottom;
+            if (length.is_flexible) flexible_total += length.value;
+            else fixed_total += length.value;
+
+            ++child_count;
+
+        }
+
+        if (child_count > 1) fixed_total += spacing * static_cast<float>(child_count - 1);
+        auto leftover = std::max(main_extent - fixed_total, 0.0f);
+
+        auto pen = main_start;
+        for (auto child = _first_child[id]; child != none; child = _next_sibling[child]) {
+
+            auto& margin = _margin[child];
+            auto& length = main_lengths[child];
+
+            auto main_size = length.value;
+            if (length.is_flexible) main_size = flexible_total > 0.0f ? leftover * length.value / flexible_total : 0.0f;
+
+            auto main_position = pen + (is_row ? margin.left : margin.top);
+            pen = main_position + main_size + (is_row ? margin.right : margin.bottom) + spacing;
+
+            if (is_row) {
+                auto [y, height] = place_across(cross_lengths[child], cross_start, cross_extent, margin.top, margin.bottom);
+                place(child, { main_position, y, main_size, height });
+            }
+            else {
+                auto [x, width] = place_across(cross_lengths[child], cross_start, cross_extent, margin.left, margin.right);
+                place(child, { x, main_position, width, main_size });
+            }
+
+        }
+
+    }
+
+}
@@ -0,0 +1,140 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <utility/measure.hpp>
+
+// Retained layout of the chrome, rows, columns and stacks of fixed and flexible boxes. Nodes live in
+// parallel arrays indexed by id, the few fields a pass reads sit next to each other for every node.
+// Changing a node only marks the container that places it, an update lays out the marked containers and
+// walks down into children that actually moved, so a resize costs what it moves and nothing else.
+// Boxes are in root coordinates (DIPs), everything that moved since the last clear is reported.
+
+namespace chrome::gui {
+
+    using layout_id = std::uint32_t;
+
+    // Rows and columns place their children one after another along x or y, a stack puts all of them
+    // on top of each other.
+    enum struct layout_direction : std::uint8_t {
+        row,
+        column,
+        stack
+    };
+
+    // Where a child ends up across the container when it doesn't fill it (along both axes in a stack).
+    enum struct layout_alignment : std::uint8_t {
+        start,
+        center,
+        end
+    };
+
+    // A fixed amount of DIPs or a flexible share. Along a row or column, flexible children split whatever
+    // their fixed siblings leave by weight. Across it, and in a stack, they fill the container.
+    // Fixed sizes are never cut down, a container too small for them lets them stick out.
+    struct layout_length {
+        float value = 1.0f;
+        bool is_flexible = true;
+    };
+
+    constexpr auto fixed_length(float const dips) { return layout_length { dips, false }; }
+    constexpr auto flexible_length(float const weight = 1.0f) { return layout_length { weight, true }; }
+
+    // Space kept around a node inside its container, negative margins overlap the neighbours.
+    struct layout_margin {
+        float left = 0.0f;
+        float top = 0.0f;
+        float right = 0.0f;
+        float bottom = 0.0f;
+    };
+
+    struct layout_statistics {
+        std::uint64_t containers_laid_out = 0;
+        std::uint64_t nodes_moved = 0;
+    };
+
+    struct layout_tree {
+
+        static constexpr layout_id root = 0;
+        static constexpr layout_id none = ~layout_id { 0 };
+
+        layout_tree();
+
+        layout_tree(layout_tree const&) = delete;
+        layout_tree(layout_tree&&) = default;
+        layout_tree& operator=(layout_tree const&) = delete;
+        layout_tree& operator=(layout_tree&&) = default;
+
+        ~layout_tree() = default;
+
+        // Goes after its existing siblings, ids are handed out in order and never removed.
+        auto add(layout_id const parent = root, layout_direction const direction = layout_direction::stack) -> layout_id;
+
+        // The root isn't placed by anything, it's given its box.
+        auto set_root_bounds(measure::rectangle<float> const& bounds) -> void;
+
+        // How the node is placed, these mark its container.
+        auto set_width(layout_id const id, layout_length const width) -> void;
+        auto set_height(layout_id const id, layout_length const height) -> void;
+        auto set_margin(layout_id const id, layout_margin const& margin) -> void;
+
+        // How the node places its children, these mark the node itself.
+        auto set_direction(layout_id const id, layout_direction const direction) -> void;
+        auto set_alignment(layout_id const id, layout_alignment const alignment) -> void;
+        auto set_spacing(layout_id const id, float const spacing) -> void;
+
+        // Lays out whatever was marked since the last update, nothing if nothing was.
+        auto update() -> void;
+
+        auto get_bounds(layout_id const id) const -> measure::rectangle<float> const& { return _bounds[id]; }
+        auto get_parent(layout_id const id) const { return _parent[id]; }
+        auto size() const { return _parent.size(); }
+
+        // Nodes whose box changed since the last clear, in the order they first moved.
+        auto get_moved() const -> std::vector<layout_id> const& { return _moved; }
+        auto clear_changes() -> void;
+
+        auto get_statistics() const -> layout_statistics const& { return _statistics; }
+
+    private:
+
+        auto mark(layout_id const id) -> void;
+        auto move(layout_id const id, measure::rectangle<float> const& bounds) -> bool;
+
+        // Places the children of a container, the ones that moved and have children of their own are pushed.
+        auto lay_out_children(layout_id const id, std::vector<layout_id>& pending) -> void;
+
+        // Tree structure.
+        std::vector<layout_id> _parent;
+        std::vector<layout_id> _first_child;
+        std::vector<layout_id> _last_child;
+        std::vector<layout_id> _next_sibling;
+        std::vector<std::uint32_t> _depth;
+
+        // Constraints.
+        std::vector<layout_direction> _direction;
+        std::vector<layout_alignment> _alignment;
+        std::vector<float> _spacing;
+        std::vector<layout_length> _width;
+        std::vector<layout_length> _height;
+        std::vector<layout_margin> _margin;
+
+        // Results.
+        std::vector<measure::rectangle<float>> _bounds;
+
+        // Containers waiting for the next update, and what moved since the last clear.
+        std::vector<std::uint8_t> _is_marked;
+        std::vector<layout_id> _marked;
+        std::vector<std::uint8_t> _has_moved;
+        std::vector<layout_id> _moved;
+
+        std::vector<layout_id> _pending;
+        layout_statistics _statistics;
+
+    };
+
+}
@@ -0,0 +1,147 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+// Throttles full redraws while the user drags a window edge. Size changes in between are shown by
+// presenting the last frame again, stretched or clipped to the new size, which costs a commit and nothing else.
+// Keeps track of how long a size change waits to be drawn and how long commits block, so both can be tuned.
+
+namespace chrome::gui {
+
+    template <typename Duration>
+    struct timing_statistics {
+
+        std::uint64_t count = 0;
+        Duration total = Duration::zero();
+        Duration maximum = Duration::zero();
+
+        auto add(Duration const sample) -> void {
+            ++count;
+            total += sample;
+            if (sample > maximum) maximum = sample;
+        }
+
+        auto get_average() const -> Duration {
+            return count > 0 ? total / static_cast<typename Duration::rep>(count) : Duration::zero();
+        }
+
+    };
+
+    template <typename Duration>
+    struct live_resize_statistics {
+
+        std::uint64_t size_changes = 0;
+        std::uint64_t redraws = 0;
+        std::uint64_t presentations = 0; // Last frame shown again instead of a redraw.
+
+        timing_statistics<Duration> latency;        // From a size change to the redraw showing it.
+        timing_statistics<Duration> commit_wait;    // Blocked until the compositor took a frame.
+
+    };
+
+    template <typename Clock = std::chrono::steady_clock>
+    struct basic_live_resize {
+
+        using time_point = typename Clock::time_point;
+        using duration = typename Clock::duration;
+        using statistics = live_resize_statistics<duration>;
+
+        basic_live_resize(Clock clock = {}, duration const redraw_interval = default_redraw_interval())
+        : _clock(std::move(clock)), _redraw_interval(redraw_interval) {}
+
+        // Fast enough to keep up with the cursor, slow enough to leave room for the compositor.
+        static constexpr auto default_redraw_interval() {
+            return std::chrono::duration_cast<duration>(std::chrono::duration<double>(1.0 / 30.0));
+        }
+
+        auto set_redraw_interval(duration const redraw_interval) -> void {
+            if (redraw_interval >= duration::zero()) _redraw_interval = redraw_interval;
+        }
+
+        // Bracket the modal size loop, outside of it every size change is redrawn right away.
+        auto begin() -> void {
+            _is_active = true;
+            _has_redrawn = false;
+        }
+
+        auto end() -> void {
+            _is_active = false;
+        }
+
+        auto handle_size_change() -> void {
+            ++_statistics.size_changes;
+            if (_is_pending) return;
+
+            _pending_since = _clock.now();
+            _is_pending = true;
+        }
+
+        // Asked at paint, false means presenting the last frame is enough for now.
+        auto should_redraw() const -> bool {
+
+            if (!_is_active || !_has_redrawn) return true;
+            return _clock.now() - _last_redraw >= _redraw_interval;
+
+        }
+
+        // When the redraw held back by should_redraw is due, nothing if there's none.
+        auto get_redraw_deadline() const -> std::optional<time_point> {
+
+            if (!_is_active || !_is_pending || !_has_redrawn) return std::nullopt;
+            return _last_redraw + _redraw_interval;
+
+        }
+
+        auto complete_redraw(duration const commit_wait) -> void {
+
+            auto now = _clock.now();
+
+            ++_statistics.redraws;
+            _statistics.commit_wait.add(commit_wait);
+            if (_is_pending) _statistics.latency.add(now - _pending_since);
+
+            _is_pending = false;
+            _has_redrawn = true;
+            _last_redraw = now;
+
+        }
+
+        auto complete_presentation(duration const commit_wait) -> void {
+            ++_statistics.presentations;
+            _statistics.commit_wait.add(commit_wait);
+        }
+
+        auto is_active() const { return _is_active; }
+        auto has_pending_redraw() const { return _is_pending; }
+        auto get_redraw_interval() const { return _redraw_interval; }
+
+        auto& get_statistics() const { return _statistics; }
+        auto reset_statistics() -> void { _statistics = {}; }
+
+        auto& get_clock() { return _clock; }
+
+    private:
+
+        Clock _clock;
+        duration _redraw_interval;
+
+        // Only meaningful while the matching flag is set.
+        time_point _last_redraw {};
+        time_point _pending_since {};
+
+        bool _is_active = false;
+        bool _has_redrawn = false;
+        bool _is_pending = false;
+        statistics _statistics;
+
+    };
+
+    using live_resize = basic_live_resize<>;
+
+}
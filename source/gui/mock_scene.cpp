@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include <graphics/software_renderer.hpp>
+#include <gui/mock_scene.hpp>
+#include <utility/profiler.hpp>
+
+namespace chrome::gui {
+
+    mock_scene::mock_scene()
+    : _tab_title_font(graphics::intern_font_family("Segoe UI")),
+      _text_fitter([](std::string_view, graphics::font_weight) { return graphics::software_renderer::get_font_advances(); }) {
+
+        _tab_raster         = std::make_unique<resource::image>("media/tab_raster.png");
+        _new_tab_symbol     = std::make_unique<resource::image>("media/new_tab_symbol.png");
+
+        build_layout();
+
+    }
+
+    auto mock_scene::record(
+        graphics::command_list& commands, measure::rectangle<float> const& client_area,
+        float const client_area_offset
+    ) -> void {
+
+        update_layout(client_area, client_area_offset);
+
+        for (auto index = 0u; index < layer_count; ++index) {
+
+            auto layer = static_cast<mock_layer>(index);
+            auto& bounds = _layout.get_bounds(_nodes.layers[index]);
+
+            commands.push_transform(graphics::transform::translation(bounds.origin.x, bounds.origin.y));
+            record_layer(layer, commands, bounds.dimension);
+            commands.pop_transform();
+
+        }
+
+    }
+
+    auto mock_scene::add_layers(graphics::layer_tree& layers) -> void {
+
+        _layer_ids[static_cast<std::size_t>(mock_layer::content)] = layers.add("content");
+        _layer_ids[static_cast<std::size_t>(mock_layer::sidebar)] = layers.add("sidebar", graphics::layer_tree::root, true);
+        _layer_ids[static_cast<std::size_t>(mock_layer::toolbar)] = layers.add("toolbar");
+        _layer_ids[static_cast<std::size_t>(mock_layer::tab_strip)] = layers.add("tab_strip");
+
+    }
+
+    auto mock_scene::layout(
+        graphics::layer_tree& layers, measure::rectangle<float> const& client_area,
+        float const client_area_offset, float const scaling
+    ) -> void {
+
+        update_layout(client_area, client_area_offset);
+
+        auto snap = [scaling](float value) { return std::round(value * scaling) / scaling; };
+
+        for (auto index = 0u; index < layer_count; ++index) {
+
+            auto& bounds = _layout.get_bounds(_nodes.layers[index]);
+            auto left = snap(bounds.origin.x), top = snap(bounds.origin.y);
+
+            layers.set_bounds(_layer_ids[index], { left, top, snap(bounds.right()) - left, snap(bounds.bottom()) - top });
+
+        }
+
+        // Whatever moved inside a layer without resizing it is only picked up by recording the layer again.
+        for (auto moved : _layout.get_moved()) {
+            for (auto node = moved; node != layout_tree::none; node = _layout.get_parent(node)) {
+
+                auto layer = std::find(_nodes.layers.begin(), _nodes.layers.end(), node);
+                if (layer == _nodes.layers.end()) continue;
+
+                if (node != moved) layers.invalidate_content(_layer_ids[layer - _nodes.layers.begin()]);
+                break;
+
+            }
+        }
+
+        _layout.clear_changes();
+
+    }
+
+    auto mock_scene::record_layers(graphics::layer_tree& layers) const -> void {
+
+        for (auto index = 0u; index < layer_count; ++index) {
+
+            auto& layer = layers.get(_layer_ids[index]);
+            if (!layer.content_changed) continue;
+
+            auto commands = std::make_shared<graphics::command_list>();
+            record_layer(static_cast<mock_layer>(index), *commands, layer.content_size);
+            layer.commands = std::move(commands);
+
+        }
+
+    }
+
+    auto mock_scene::add_hit_regions(hit_test_map& map, float const client_area_offset, float const scaling) const -> void {
+
+        // The tabs hang from the bottom of the strip and don't depend on anything else, so wherever they were
+        // last laid out they're at the same place relative to it, even before the window's first layout.
+        auto add = [&](layout_id const node, mock_element element) {
+
+            auto [origin, dimension] = get_local_bounds(node, mock_layer::tab_strip);
+            auto& [width, height] = dimension;
+            auto x = origin.x;
+            auto y = origin.y + client_area_offset - _layout.get_bounds(_nodes.layers[static_cast<std::size_t>(mock_layer::tab_strip)]).dimension.height;
+
+            auto left = std::floor(x * scaling), top = std::floor(y * scaling);
+            map.add_interactive({
+                static_cast<std::int32_t>(left), static_cast<std::int32_t>(top),
+                static_cast<std::int32_t>(std::ceil((x + width) * scaling) - left),
+                static_cast<std::int32_t>(std::ceil((y + height) * scaling) - top)
+            }, static_cast<std::uint32_t>(element));
+
+        };
+
+        // Same places paint_mock_tabs draws at. The active tab is drawn last, so it goes on top.
+        add(_nodes.inactive_tab, mock_element::inactive_tab);
+        add(_nodes.new_tab_button, mock_element::new_tab_button);
+        add(_nodes.active_tab, mock_element::active_tab);
+
+    }
+
+    auto mock_scene::set_font_advance_provider(graphics::text_fitter::advance_provider provider) -> void {
+        _text_fitter.set_advance_provider(std::move(provider));
+    }
+
+    auto mock_scene::build_layout() -> void {
+
+        auto& [layers, body, active_tab, active_title, inactive_tab, inactive_title, new_tab_button, omnibox] = _nodes;
+        auto layer_node = [&](mock_layer const layer) -> layout_id& { return layers[static_cast<std::size_t>(layer)]; };
+
+        // The tab strip fills the extended frame, the toolbar and the page go below it.
+        _layout.set_direction(layout_tree::root, layout_direction::column);
+
+        auto tab_strip = layer_node(mock_layer::tab_strip) = _layout.add(layout_tree::root, layout_direction::row);
+        auto toolbar = layer_node(mock_layer::toolbar) = _layout.add(layout_tree::root, layout_direction::column);
+        body = _layout.add(layout_tree::root, layout_direction::stack);
+
+        _layout.set_height(tab_strip, fixed_length(0.0f));
+        _layout.set_height(toolbar, fixed_length(toolbar_height));
+
+        // The sidebar covers the left of the page.
+        layer_node(mock_layer::content) = _layout.add(body);
+        layer_node(mock_layer::sidebar) = _layout.add(body);
+        _layout.set_width(layer_node(mock_layer::sidebar), fixed_length(sidebar_width));
+
+        // Tabs sit on the bottom edge, half size images. The second one tucks under the slanted edge of the
+        // first, the new tab button goes right after the last. Titles leave room for the icon and the close button.
+        _layout.set_alignment(tab_strip, layout_alignment::end);
+
+        active_tab = _layout.add(tab_strip);
+        inactive_tab = _layout.add(tab_strip);
+        new_tab_button = _layout.add(tab_strip);
+
+        for (auto tab : { active_tab, inactive_tab }) {
+            _layout.set_width(tab, fixed_length(231.0f));
+            _layout.set_height(tab, fixed_length(28.0f));
+        }
+
+        _layout.set_margin(active_tab, { 10.0f, 0.0f, -12.0f, 0.0f });
+
+        active_title = _layout.add(active_tab);
+        inactive_title = _layout.add(inactive_tab);
+        for (auto title : { active_title, inactive_title }) _layout.set_margin(title, { 38.0f, 4.0f, 33.0f, 0.0f });
+
+        _layout.set_width(new_tab_button, fixed_length(16.0f));
+        _layout.set_height(new_tab_button, fixed_length(16.0f));
+        _layout.set_margin(new_tab_button, { 0.0f, 0.0f, 0.0f, 6.0f });
+
+        // The omnibox spans the toolbar.
+        omnibox = _layout.add(toolbar);
+        _layout.set_height(omnibox, fixed_length(32.0f));
+        _layout.set_margin(omnibox, { 14.0f, 9.0f, 14.0f, 0.0f });
+
+        _layout.update();
+        _layout.clear_changes();
+
+    }
+
+    auto mock_scene::update_layout(measure::rectangle<float> const& client_area, float const client_area_offset) -> void {
+
+        auto& [origin, dimension] = client_area;
+
+        _layout.set_height(_nodes.layers[static_cast<std::size_t>(mock_layer::tab_strip)], fixed_length(client_area_offset));
+        _layout.set_root_bounds({ origin.x, 0.0f, dimension.width, client_area_offset + dimension.height });
+        _layout.update();
+
+    }
+
+    auto mock_scene::get_local_bounds(layout_id const node, mock_layer const layer) const -> measure::rectangle<float> {
+
+        auto bounds = _layout.get_bounds(node);
+        auto& layer_bounds = _layout.get_bounds(_nodes.layers[static_cast<std::size_t>(layer)]);
+
+        bounds.origin.x -= layer_bounds.origin.x;
+        bounds.origin.y -= layer_bounds.origin.y;
+
+        return bounds;
+
+    }
+
+    auto mock_scene::record_layer(mock_layer const layer, graphics::command_list& commands, measure::size<float> const& size) const -> void {
+
+        switch (layer) {
+            case mock_layer::content:   paint_mock_content(commands, size); break;
+            case mock_layer::sidebar:   paint_mock_sidebar(commands, size); break;
+            case mock_layer::toolbar:   paint_mock_toolbar(commands, size); break;
+            case mock_layer::tab_strip: paint_mock_tabs(commands, size); break;
+        }
+
+    }
+
+    auto mock_scene::paint_mock_tabs(graphics::command_list& commands, measure::size<float> const& size) const -> void {
+
+        CHROME_PROFILE_ZONE("paint_mock_tabs");
+
+        auto draw_image = [&](resource::image* image, layout_id const node, float const opacity) {
+            commands.draw_image(image, 0.5f, get_local_bounds(node, mock_layer::tab_strip).origin, opacity);
+        };
+
+        auto draw_title = [&](std::string_view title, layout_id const node, float const alpha) {
+
+            auto [origin, dimension] = get_local_bounds(node, mock_layer::tab_strip);
+            auto& fitted = _text_fitter.fit(title, _tab_title_font, tab_title_font_size, dimension.width);
+
+            commands.draw_text(
+                fitted.text, origin, graphics::get_font_family(_tab_title_font), tab_title_font_size,
+                measure::color{ 0.4f, 0.4f, 0.4f, alpha }
+            );
+
+        };
+
+        draw_image(_tab_raster.get(), _nodes.inactive_tab, 0.6f);
+        draw_image(_new_tab_symbol.get(), _nodes.new_tab_button, 1.0f);
+
+        // The bottom edge of the extended frame.
+        commands.draw_line(
+            measure::point<float> { 0.0f, size.height - 1.0f + 0.5f},
+            measure::point<float> { size.width, size.height - 1.0f + 0.5f},
+            1.0f, measure::color{ 0.77f, 0.77f, 0.77f, 1.0f }
+        );
+
+        draw_image(_tab_raster.get(), _nodes.active_tab, 1.0f);
+
+        draw_title("Expand the frame into the title bar with DwmExtendFrameIntoClientArea", _nodes.active_title, 1.0f);
+        draw_title("Recompute the window region when the window is resized", _nodes.inactive_title, 0.6f);
+
+    }
+
+    auto mock_scene::paint_mock_toolbar(graphics::command_list& commands, measure::size<float> const& size) const -> void {
+
+        CHROME_PROFILE_ZONE("paint_mock_toolbar");
+
+        // Paint the toolbar into our baseline color.
+        commands.fill_rectangle(measure::rectangle<float> { 0.0f, 0.0f, size.width, size.height }, measure::color{ 0.96f, 0.96f, 0.96f });
+
+        commands.draw_line(
+            measure::point<float> { 0.0f, 50.5f},
+            measure::point<float> { size.width, 50.5f},
+            1.0f, measure::color{ 0.82f, 0.82f, 0.82f, 1.0f }
+        );
+
+        commands.draw_line(
+            measure::point<float> { 0.0f, 54.5f},
+            measure::point<float> { size.width, 54.5f},
+            1.0f, measure::color{ 0.82f, 0.82f, 0.82f, 1.0f }
+        );
+
+        // The omnibox, a one DIP border around it.
+        auto [origin, dimension] = get_local_bounds(_nodes.omnibox, mock_layer::toolbar);
+
+        commands.fill_rectangle(
+            measure::rectangle<float> { origin, dimension }, measure::color{ 0.9f, 0.9f, 0.9f }
+        );
+
+        commands.fill_rectangle(
+            measure::rectangle<float> {
+                origin.x + 1.0f, origin.y + 1.0f, dimension.width - 2.0f, dimension.height - 2.0f
+            }, measure::color{ 1.0f, 1.0f, 1.0f }
+        );
+
+    }
+
+    auto mock_scene::paint_mock_sidebar(graphics::command_list& commands, measure::size<float> const& size) const -> void {
+
+        CHROME_PROFILE_ZONE("paint_mock_sidebar");
+
+        commands.fill_rectangle(
+            measure::rectangle<float> { 0.0f, 0.0f, size.width, size.height }, measure::color{ 0.92f, 0.92f, 0.92f }
+        );
+
+    }
+
+    auto mock_scene::paint_mock_content(graphics::command_list& commands, measure::size<float> const& size) const -> void {
+
+        CHROME_PROFILE_ZONE("paint_mock_content");
+
+        commands.fill_rectangle(
+            measure::rectangle<float> { 0.0f, 0.0f, size.width, size.height }, measure::color{ 1.0f, 1.0f, 1.0f }
+        );
+
+    }
+
+}
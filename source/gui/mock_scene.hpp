@@ -0,0 +1,129 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include <utility/measure.hpp>
+#include <graphics/command_list.hpp>
+#include <graphics/image.hpp>
+#include <graphics/layer_tree.hpp>
+#include <graphics/text_fitting.hpp>
+#include <gui/hit_test_map.hpp>
+#include <gui/layout_tree.hpp>
+
+// The mockup drawn into the window, kept free of platform code so the exact same frame can be
+// recorded by the window and by headless tools running the software renderer.
+
+namespace chrome::gui {
+
+    // Ids of the interactive parts of the mockup, as reported by the hit-test map.
+    enum struct mock_element : std::uint32_t {
+        none,
+        active_tab,
+        inactive_tab,
+        new_tab_button
+    };
+
+    // Parts of the mockup painted into their own layers, back to front.
+    enum struct mock_layer : std::uint32_t {
+        content,
+        sidebar,
+        toolbar,
+        tab_strip
+    };
+
+    struct mock_scene {
+
+        mock_scene();
+
+        mock_scene(mock_scene const&) = delete;
+        mock_scene(mock_scene&&) = default;
+        mock_scene& operator=(mock_scene const&) = delete;
+        mock_scene& operator=(mock_scene&&) = default;
+
+        ~mock_scene() = default;
+
+        // Client area is in DIPs and starts below the extended frame, which sits at client_area_offset.
+        // Records every layer into a single list, for targets without composition (headless tools).
+        auto record(
+            graphics::command_list& commands, measure::rectangle<float> const& client_area,
+            float const client_area_offset
+        ) -> void;
+
+        // Creates the mockup's layers below the root, call once per tree.
+        auto add_layers(graphics::layer_tree& layers) -> void;
+
+        // Positions the layers for a client area (same coordinates as record), changes nothing if it didn't change.
+        // Edges are snapped to whole pixels at the given scaling, so neighbouring layers don't leave seams.
+        // Layers with parts that moved inside them are recorded again.
+        auto layout(
+            graphics::layer_tree& layers, measure::rectangle<float> const& client_area,
+            float const client_area_offset, float const scaling = 1.0f
+        ) -> void;
+
+        // Records the layers whose content changed, at their content size.
+        auto record_layers(graphics::layer_tree& layers) const -> void;
+
+        // Tab titles are fitted with the software renderer's advances until told otherwise, the window hands in
+        // real font metrics once it has a device. Invalidate the tab strip afterwards.
+        auto set_font_advance_provider(graphics::text_fitter::advance_provider provider) -> void;
+
+        auto get_layer_id(mock_layer const layer) const { return _layer_ids[static_cast<std::size_t>(layer)]; }
+
+        // The tabs and the new tab button sit in the caption, registering them keeps them from dragging the window.
+        // The map is in client pixels.
+        auto add_hit_regions(hit_test_map& map, float const client_area_offset, float const scaling) const -> void;
+
+        auto get_tab_raster() const { return _tab_raster.get(); }
+        auto get_new_tab_symbol() const { return _new_tab_symbol.get(); }
+
+    private:
+
+        static constexpr auto layer_count = 4u;
+        static constexpr auto toolbar_height = 55.0f;
+        static constexpr auto sidebar_width = 400.0f;
+        static constexpr auto tab_title_font_size = 14.0f;
+
+        // Parts drawn inside the layers, placed by the layout along with the layers themselves.
+        struct layout_nodes {
+            std::array<layout_id, layer_count> layers {};
+            layout_id body = 0;
+            layout_id active_tab = 0, active_title = 0;
+            layout_id inactive_tab = 0, inactive_title = 0;
+            layout_id new_tab_button = 0;
+            layout_id omnibox = 0;
+        };
+
+        auto build_layout() -> void;
+
+        // Lays the mockup out in surface DIPs, the extended frame included.
+        auto update_layout(measure::rectangle<float> const& client_area, float const client_area_offset) -> void;
+
+        // A part relative to the layer it's drawn into.
+        auto get_local_bounds(layout_id const node, mock_layer const layer) const -> measure::rectangle<float>;
+
+        // Everything is drawn in layer local DIPs, filling size.
+        auto record_layer(mock_layer const layer, graphics::command_list& commands, measure::size<float> const& size) const -> void;
+
+        auto paint_mock_tabs(graphics::command_list& commands, measure::size<float> const& size) const -> void;
+        auto paint_mock_toolbar(graphics::command_list& commands, measure::size<float> const& size) const -> void;
+        auto paint_mock_sidebar(graphics::command_list& commands, measure::size<float> const& size) const -> void;
+        auto paint_mock_content(graphics::command_list& commands, measure::size<float> const& size) const -> void;
+
+        std::unique_ptr<resource::image> _tab_raster;
+        std::unique_ptr<resource::image> _new_tab_symbol;
+
+        std::array<graphics::layer_id, layer_count> _layer_ids {};
+
+        layout_tree _layout;
+        layout_nodes _nodes;
+
+        graphics::font_id _tab_title_font;
+        mutable graphics::text_fitter _text_fitter;
+
+    };
+
+}
@@ -0,0 +1,108 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <utility>
+
+// Runs the render work off the UI thread, so a slow draw or commit never holds up input. It sleeps until
+// woken (frames queued, images decoded) and then runs the work once, wakes arriving in the meantime fold
+// into the next run. The work itself finds out what there is to do, usually by draining frame queues.
+
+namespace chrome::gui {
+
+    struct render_thread {
+
+        explicit render_thread(std::function<void()> work) : _work(std::move(work)), _thread([this] { run(); }) {}
+
+        render_thread(render_thread const&) = delete;
+        render_thread(render_thread&&) = delete;
+        render_thread& operator=(render_thread const&) = delete;
+        render_thread& operator=(render_thread&&) = delete;
+
+        // A run in progress finishes, nothing after it starts.
+        ~render_thread() {
+
+            _stopping.store(true, std::memory_order_release);
+            _requested.fetch_add(1, std::memory_order_acq_rel);
+            _requested.notify_one();
+
+            _thread.join();
+
+        }
+
+        // From any thread, never blocks.
+        auto wake() -> void {
+            _requested.fetch_add(1, std::memory_order_acq_rel);
+            _requested.notify_one();
+        }
+
+        // Blocks until a run started after the call has completed, e.g. to have a frame on screen together with
+        // a new window size. Never from the render thread itself.
+        auto flush() -> void {
+
+            auto target = _requested.fetch_add(1, std::memory_order_acq_rel) + 1;
+            _requested.notify_one();
+
+            for (auto completed = _completed.load(std::memory_order_acquire); completed < target; completed = _completed.load(std::memory_order_acquire))
+                _completed.wait(completed, std::memory_order_acquire);
+
+        }
+
+        // Whatever the work threw is kept and rethrown here, on the thread that owns the render thread.
+        auto rethrow_failure() -> void {
+            if (_has_failed.load(std::memory_order_acquire)) std::rethrow_exception(_failure);
+        }
+
+        auto get_run_count() const { return _run_count.load(std::memory_order_relaxed); }
+
+    private:
+
+        auto run() -> void {
+
+            std::uint64_t handled = 0;
+
+            while (true) {
+
+                _requested.wait(handled, std::memory_order_acquire);
+                auto requested = _requested.load(std::memory_order_acquire);
+                if (_stopping.load(std::memory_order_acquire)) return;
+
+                try { _work(); }
+                catch (...) {
+                    if (!_has_failed.load(std::memory_order_relaxed)) {
+                        _failure = std::current_exception();
+                        _has_failed.store(true, std::memory_order_release);
+                    }
+                }
+
+                _run_count.fetch_add(1, std::memory_order_relaxed);
+
+                handled = requested;
+                _completed.store(requested, std::memory_order_release);
+                _completed.notify_all();
+
+            }
+
+        }
+
+        std::function<void()> _work;
+
+        std::atomic<std::uint64_t> _requested { 0 };
+        std::atomic<std::uint64_t> _completed { 0 };
+        std::atomic<std::uint64_t> _run_count { 0 };
+        std::atomic<bool> _stopping { false };
+
+        std::atomic<bool> _has_failed { false };
+        std::exception_ptr _failure;
+
+        std::thread _thread; // Last, so everything it uses is up before it starts.
+
+    };
+
+}
@@ -1,11 +1,31 @@
 #include <gui/window.hpp>
+#include <chrono>
 #include <cmath>
+#include <fstream>
+
+#include <graphics/frame_capture.hpp>
 
 #include <utility/string_conversion.hpp>
 #include <gui/window_helper.hpp>
+#include <utility/profiler.hpp>
 
 namespace chrome::gui {
 
+    namespace {
+        // Fires the redraw a throttled live resize held back, in case the drag stops before the next size change.
+        constexpr auto live_resize_timer = UINT_PTR { 1 };
+    }
+
+    auto merge_frames(window_frame& latest, window_frame&& superseded) -> void {
+
+        if (!superseded.layers) return;
+
+        // A resized presentation shows whatever was rendered last, which now includes the superseded layers.
+        if (latest.layers) latest.layers->absorb_changes(*superseded.layers);
+        else latest.layers = std::move(superseded.layers);
+
+    }
+
     auto CALLBACK process_message(HWND window_handle, UINT message, WPARAM wparam, LPARAM lparam) -> LRESULT {
 
         LRESULT result;
@@ -48,23 +68,37 @@ namespace chrome::gui {
         // Determine whether the cursor is near interactive points of the window
         else if ((message == WM_NCHITTEST)) {
 
-            result = helper::compute_sector_of_window(window_handle, wparam, lparam, window->_margins.cyTopHeight);
+            auto cursor = measure::point<std::int32_t> {
+                GET_X_LPARAM(lparam) - window->_client_origin.x, GET_Y_LPARAM(lparam) - window->_client_origin.y
+            };
+
+            result = helper::to_hit_test_code(window->_hit_test_map.hit_test(cursor));
             if (result != HTNOWHERE) return result;
 
         }
 
         else if (message == WM_PAINT) window->paint();
-        else if (message == WM_SIZE) window->handle_resize();
+        else if (message == WM_SIZE) window->handle_resize(wparam);
+        else if (message == WM_MOVE) window->handle_move();
+        else if (message == WM_ENTERSIZEMOVE) window->begin_live_resize();
+        else if (message == WM_EXITSIZEMOVE) window->end_live_resize();
+        else if (message == WM_TIMER && wparam == live_resize_timer) {
+            KillTimer(window_handle, live_resize_timer);
+            InvalidateRect(window_handle, nullptr, FALSE);
+        }
+        else if (message == WM_SHOWWINDOW) window->update_visibility(static_cast<bool>(wparam));
 
-        else if (message == WM_DESTROY) PostQuitMessage(0);
+        // The application drops closed windows once the message is handled, and quits after the last one.
+        else if (message == WM_DESTROY) window->_is_closed = true;
 
         return DefWindowProcW(window_handle, message, wparam, lparam);
 
     }
 
-    window::window(std::string title, measure::rectangle<float> const& frame) {
+    window::window(std::string title, measure::rectangle<float> const& frame, frame_scheduler& scheduler) {
 
         _title = std::move(title);
+        _frame_scheduler = &scheduler;
 
         WNDCLASSEX window_class {
 
@@ -76,10 +110,10 @@ namespace chrome::gui {
 
         RegisterClassEx(&window_class);
 
-        auto wide_title = utility::convert_utf8_to_utf16(_title);
+        utility::utf16_buffer<> wide_title { _title };
 
         _system_window_handle = CreateWindowExW(
-            WS_EX_NOREDIRECTIONBITMAP, window_class.lpszClassName, wide_title.c_str(), 
+            WS_EX_NOREDIRECTIONBITMAP, window_class.lpszClassName, utility::as_wide(wide_title), 
             WS_OVERLAPPEDWINDOW, 10, 10, 100, 100, nullptr, nullptr, window_class.hInstance, this
         );
 
@@ -102,12 +136,38 @@ namespace chrome::gui {
         auto hr = DwmExtendFrameIntoClientArea(_system_window_handle, &_margins);
         if (FAILED(hr)) throw std::runtime_error { "DWM failed to extend frame into the client area." };
         _client_area_offset_dip = static_cast<float>(_margins.cyTopHeight) / _user_scaling;
+        rebuild_hit_test_map();
+        _mock_scene.add_layers(_layers);
+
+    }
 
-        _tab_raster         = std::make_unique<resource::image>("media/tab_raster.png");
-        _new_tab_symbol     = std::make_unique<resource::image>("media/new_tab_symbol.png");
+    auto window::attach_renderer(graphics::render_device& device, render_thread& thread) -> void {
+
+        // The render thread may be drawing other windows with the device meanwhile.
+        auto device_lock = device.lock();
+
+        _device = &device;
+        _render_thread = &thread;
+        _renderer = std::make_unique<graphics::renderer>(device);
+
+        // Shared between windows, only the first one to ask decodes and uploads anything.
+        _device->prefetch(*_mock_scene.get_tab_raster());
+        _device->prefetch(*_mock_scene.get_new_tab_symbol());
+
+        // Always on screen, so never worth evicting.
+        _device->pin(*_mock_scene.get_tab_raster());
+        _device->pin(*_mock_scene.get_new_tab_symbol());
+
+        // Tab titles are fitted with the fonts they're drawn with from now on. Recording doesn't hold the lock,
+        // so the provider takes it for the few DWrite calls it makes.
+        _mock_scene.set_font_advance_provider([target_device = _device](std::string_view font_family, graphics::font_weight weight) {
+            auto provider_lock = target_device->lock();
+            return target_device->get_font_advances(font_family, weight);
+        });
+        _layers.invalidate_content(_mock_scene.get_layer_id(mock_layer::tab_strip));
 
-        _renderer = std::make_unique<graphics::renderer>();
         _renderer->attach_to_window(_system_window_handle);
+        _frame_scheduler->request_frame();
 
     }
 
@@ -119,9 +179,30 @@ namespace chrome::gui {
         ShowWindow(_system_window_handle, SW_HIDE);
     }
 
+    auto window::invalidate() -> void {
+
+        _layers.invalidate(graphics::layer_tree::root);
+        _frame_scheduler->request_frame();
+
+    }
+
+    auto window::invalidate(measure::rectangle<float> const& area) -> void {
+
+        _layers.invalidate(area);
+        _frame_scheduler->request_frame();
+
+    }
+
+    auto window::update() -> void {
+        paint();
+    }
+
     auto window::paint() -> void {
 
-        _renderer->begin_draw();
+        // Windows come up while the devices are still being created, nothing to draw with before that.
+        if (!_renderer) return;
+
+        CHROME_PROFILE_FRAME("paint");
 
         RECT client_rectangle;
         GetClientRect(_system_window_handle, &client_rectangle);
@@ -134,94 +215,204 @@ namespace chrome::gui {
 
         client_area *= 1.0f / _user_scaling;
 
-        _renderer->push_transform(D2D1::Matrix3x2F::Translation(0.0f, _client_area_offset_dip));
+        auto& [width, height] = client_area.dimension;
+        auto resized = width != _layout_size.width || height != _layout_size.height;
+
+        // Dragging faster than the redraw rate shows the last frame at the new size until a redraw is due.
+        if (resized && !_live_resize.should_redraw()) {
+
+            auto is_live_resizing = _live_resize.is_active();
+            auto accepted = submit([&] {
+                return window_frame { std::nullopt, _layout_size, client_area.dimension, true, is_live_resizing };
+            });
 
-        // Paint the whole client area into our baseline color.
-        _renderer->fill_rectangle(client_area, measure::color{ 0.96f, 0.96f, 0.96f });
+            if (accepted) {
+                _is_rendering_live_resize = is_live_resizing;
+                _live_resize.complete_presentation(wait_for_commit());
+            }
+
+            if (auto deadline = _live_resize.get_redraw_deadline()) {
+                auto delay = std::chrono::ceil<std::chrono::milliseconds>(*deadline - std::chrono::steady_clock::now()).count();
+                SetTimer(_system_window_handle, live_resize_timer, delay > USER_TIMER_MINIMUM ? static_cast<UINT>(delay) : USER_TIMER_MINIMUM, nullptr);
+            }
 
-        paint_mock_tabs(client_area);
-        paint_mock_toolbar(client_area);
-        paint_mock_sidebar(client_area);
+            return;
 
-        _renderer->end_draw();
+        }
+
+        // Static layers that only shrink keep their content, the rest is recorded again.
+        if (resized) {
+            CHROME_PROFILE_ZONE("layout");
+            _mock_scene.layout(_layers, client_area, _client_area_offset_dip, _user_scaling);
+            _layout_size = client_area.dimension;
+        }
+
+        {
+            CHROME_PROFILE_ZONE("record");
+            _mock_scene.record_layers(_layers);
+        }
+
+        // Decoded images are uploaded by the render thread, a bounded amount per frame. Whichever window
+        // it rendered them for, every window that drew without them has to draw again.
+        if (_upload_generation != _device->get_upload_generation()) {
+            _upload_generation = _device->get_upload_generation();
+            _layers.invalidate(graphics::layer_tree::root);
+        }
+
+        // DComp retains every layer, so a paint without changes (uncovering, restoring) has nothing to do.
+        auto is_live_resizing = _live_resize.is_active();
+        if (!_layers.has_changes() && is_live_resizing == _is_rendering_live_resize) return;
+
+        // The changes stay in the layers until a frame carrying them is accepted, the next one picks them up.
+        auto accepted = submit([&] {
+            return window_frame { _layers, _layout_size, client_area.dimension, false, is_live_resizing };
+        });
+
+        if (!accepted) return;
+
+        _layers.clear_changes();
+        _is_rendering_live_resize = is_live_resizing;
+
+        // A new size is waited on, so the frame lands together with the window instead of trailing it.
+        if (resized) _live_resize.complete_redraw(wait_for_commit());
 
     }
 
-    auto window::paint_mock_tabs(measure::rectangle<float> const& window_rectangle) -> void {
+    auto window::render() -> bool {
 
-        _renderer->draw_image(_tab_raster.get(), 0.5f, measure::point<float> {229.f, -28.0f}, 0.6f);
-        _renderer->draw_image(_new_tab_symbol.get(), 0.5f, measure::point<float> {460.f, -22.0f}, 1.0f);
+        if (!_renderer) return false;
 
-        _renderer->draw_line(
-            measure::point<float> { window_rectangle.origin.x, -1.0f + 0.5f},
-            measure::point<float> { window_rectangle.dimension.width, -1.0f + 0.5f},
-            1.0f, measure::color{ 0.77f, 0.77f, 0.77f, 1.0f }
-        );
+        auto frame = _frame_queue.acquire_latest(merge_frames);
+        if (!frame) return false;
 
-        _renderer->draw_image(_tab_raster.get(), 0.5f, measure::point<float> {10.0f, -28.0f}, 1.0f);
+        // Surfaces only grow while live resizing, so it starts ahead of drawing and ends after it.
+        if (frame->is_live_resizing) _renderer->set_live_resize(true);
+        if (frame->layers) _renderer->render_layers(*frame->layers);
+        if (frame->layers && !_capture_path_prefix.empty()) capture_frame(*frame->layers, frame->client_size);
+        if (frame->is_presented_resized) _renderer->present_resized(frame->layout_size, frame->client_size);
+        if (!frame->is_live_resizing && _renderer->is_live_resizing()) _renderer->set_live_resize(false);
 
-        _renderer->draw_text(
-            "Expand the frame into t...", measure::point<float>{ 48.f, -24.f },
-            "Segoe UI", 14.0f, measure::color{ 0.4f, 0.4f, 0.4f, 1.0f }
-        );
+        if (_first_frame_ticks.load(std::memory_order_relaxed) == 0)
+            _first_frame_ticks.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
 
-        _renderer->draw_text(
-            "Recompute the window...", measure::point<float>{ 221.f + 48.f, -24.f },
-            "Segoe UI", 14.0f, measure::color{ 0.4f, 0.4f, 0.4f, 0.6f }
-        );
+        return true;
 
     }
 
-    auto window::paint_mock_toolbar(measure::rectangle<float> const& window_rectangle) -> void {
+    auto window::capture_frames(std::string const& directory, std::string const& prefix) -> void {
+        _capture_path_prefix = directory + "/" + prefix;
+    }
 
-        _renderer->draw_line(
-            measure::point<float> { window_rectangle.origin.x, 50.5f},
-            measure::point<float> { window_rectangle.dimension.width, 50.5f},
-            1.0f, measure::color{ 0.82f, 0.82f, 0.82f, 1.0f }
-        );
+    auto window::capture_frame(graphics::layer_tree const& layers, measure::size<float> const& client_size) -> void {
 
-        _renderer->draw_line(
-            measure::point<float> { window_rectangle.origin.x, 54.5f},
-            measure::point<float> { window_rectangle.dimension.width, 54.5f},
-            1.0f, measure::color{ 0.82f, 0.82f, 0.82f, 1.0f }
-        );
+        CHROME_PROFILE_ZONE("capture_frame");
 
-        _renderer->fill_rectangle(
-            measure::rectangle<float> {
-                window_rectangle.origin.x, 55.0f,
-                window_rectangle.dimension.width - window_rectangle.origin.x, 
-                window_rectangle.dimension.height - 55.0f
-            }, measure::color{ 1.0f, 1.0f, 1.0f }
-        );
+        // The size the renderer's surfaces are drawn at, the layers themselves are in DIPs.
+        auto surface_size = measure::size<std::uint32_t> {
+            static_cast<std::uint32_t>(std::ceil(client_size.width * _user_scaling)),
+            static_cast<std::uint32_t>(std::ceil(client_size.height * _user_scaling))
+        };
 
-        _renderer->fill_rectangle(
-            measure::rectangle<float> {
-                14.0f, 9.0f, window_rectangle.dimension.width - 28.0f, 32.0f
-            }, measure::color{ 0.9f, 0.9f, 0.9f }
-        );
+        // Throws like any other render thread failure, a capture missing frames would be misleading.
+        std::ofstream output { _capture_path_prefix + "_" + std::to_string(_captured_frames++) + ".chromeframe", std::ios::binary };
+        graphics::write_frame_capture(output, layers, surface_size, 96.0f * _user_scaling, [this](resource::image const& image) {
+            return _device->get_image_size(image);
+        });
 
-        _renderer->fill_rectangle(
-            measure::rectangle<float> {
-                15.0f,  10.0f, window_rectangle.dimension.width - 30.0f, 30.0f
-            }, measure::color{ 1.0f, 1.0f, 1.0f }
-        );
+    }
+
+    auto window::get_first_frame_time() const -> std::optional<std::chrono::steady_clock::time_point> {
+
+        auto ticks = _first_frame_ticks.load(std::memory_order_relaxed);
+        if (ticks == 0) return std::nullopt;
+
+        return std::chrono::steady_clock::time_point { std::chrono::steady_clock::duration { ticks } };
 
     }
 
+    auto window::wait_for_commit() -> std::chrono::steady_clock::duration {
 
-    auto window::paint_mock_sidebar(measure::rectangle<float> const& window_rectangle) -> void {
+        // Rendering and committing happen on the render thread, which waits for the compositor after every commit.
+        auto start = std::chrono::steady_clock::now();
+        _render_thread->flush();
 
-        _renderer->fill_rectangle(
-            measure::rectangle<float> {
-                window_rectangle.origin.x, 55.0f,
-                window_rectangle.origin.x + 400.0f, 
-                window_rectangle.dimension.height
-            }, measure::color{ 0.92f, 0.92f, 0.92f }
-        );
+        return std::chrono::steady_clock::now() - start;
+
+    }
+
+    auto window::begin_live_resize() -> void {
+
+        // The renderer picks it up with the next frame.
+        _live_resize.begin();
+
+    }
+
+    auto window::end_live_resize() -> void {
+
+        KillTimer(_system_window_handle, live_resize_timer);
+        _live_resize.end();
+
+        // Whatever was only presented stretched gets its real redraw, surfaces go back to their content size.
+        _frame_scheduler->request_frame();
+
+    }
+
+    auto window::update_visibility(bool const shown) -> void {
+
+        // Cloaked windows (other virtual desktop, suspended apps) are as good as hidden.
+        BOOL cloaked = FALSE;
+        DwmGetWindowAttribute(_system_window_handle, DWMWA_CLOAKED, &cloaked, sizeof(cloaked));
+
+        _frame_scheduler->set_visible(shown && !IsIconic(_system_window_handle) && !cloaked);
+
+    }
+
+    auto window::handle_resize(WPARAM resize_type) -> void {
+
+        update_visibility(resize_type != SIZE_MINIMIZED);
+        if (resize_type == SIZE_MINIMIZED) return;
+
+        rebuild_hit_test_map();
+        if (!_renderer) return;
+
+        _live_resize.handle_size_change();
+
+        // Layers are laid out again at paint, only the ones the new size affects get redrawn.
+        _frame_scheduler->request_frame();
 
     }
 
-    auto window::handle_resize() -> void {
-        if(_renderer) _renderer->resize_buffers();
+    auto window::handle_move() -> void {
+
+        // Moving changes nothing relative to the window, only where its client area sits on screen.
+        POINT client_origin { 0, 0 };
+        ClientToScreen(_system_window_handle, &client_origin);
+        _client_origin = { client_origin.x, client_origin.y };
+
+    }
+
+    auto window::rebuild_hit_test_map() -> void {
+
+        // WM_SIZE already arrives during CreateWindowExW, the constructor builds the map once it's done.
+        if (_system_window_handle == nullptr) return;
+
+        handle_move();
+
+        RECT window_rectangle;
+        GetWindowRect(_system_window_handle, &window_rectangle);
+
+        auto bounds = measure::rectangle<std::int32_t> {
+            window_rectangle.left - _client_origin.x, window_rectangle.top - _client_origin.y,
+            window_rectangle.right - window_rectangle.left, window_rectangle.bottom - window_rectangle.top
+        };
+
+        auto const resize_border = 10;
+
+        _hit_test_map.reset(bounds);
+        _hit_test_map.add_resize_borders(resize_border);
+        _hit_test_map.add_caption({ bounds.origin.x, bounds.origin.y, bounds.dimension.width, _margins.cyTopHeight });
+        _mock_scene.add_hit_regions(_hit_test_map, _client_area_offset_dip, _user_scaling);
+        _hit_test_map.build();
+
     }
 }
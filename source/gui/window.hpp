@@ -2,52 +2,156 @@
 // MIT license | Read LICENSE.txt for details.
 
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <optional>
 #include <string>
+#include <utility>
 #include <Windows.h>
 #include <dwmapi.h>
 
 #include <utility/measure.hpp>
+#include <graphics/render_device.hpp>
 #include <graphics/renderer.hpp>
+#include <graphics/command_list.hpp>
 #include <graphics/image.hpp>
+#include <graphics/layer_tree.hpp>
+#include <gui/mock_scene.hpp>
+#include <gui/frame_scheduler.hpp>
+#include <gui/frame_queue.hpp>
+#include <gui/render_thread.hpp>
+#include <gui/live_resize.hpp>
+#include <gui/hit_test_map.hpp>
 
 namespace chrome::gui {
 
+    // Everything the render thread needs to bring a window's visuals up to date, described on the UI thread.
+    struct window_frame {
+        std::optional<graphics::layer_tree> layers;         // With the changes since the last frame, none when only presenting resized.
+        measure::size<float> layout_size { 0.0f, 0.0f };    // What the layers were laid out for.
+        measure::size<float> client_size { 0.0f, 0.0f };
+        bool is_presented_resized = false;                  // The last frame stretched to the client size.
+        bool is_live_resizing = false;
+    };
+
+    // Folds a frame the render thread never got to into the one replacing it.
+    auto merge_frames(window_frame& latest, window_frame&& superseded) -> void;
+
     struct window {
 
         friend auto CALLBACK process_message(HWND, UINT, WPARAM, LPARAM) -> LRESULT;
 
-        window(std::string title, measure::rectangle<float> const& frame);
+        // Creates and lays out the system window only, it draws nothing until a renderer is attached.
+        window(std::string title, measure::rectangle<float> const& frame, frame_scheduler& scheduler);
 
         window(window const&) = delete;
-        window(window&&) = default;
+        window(window&&) = delete;
 
         window& operator=(window const&) = delete;
-        window& operator=(window&&) = default;
+        window& operator=(window&&) = delete;
 
         ~window() = default;
 
+        // The device and the render thread are shared with the application's other windows and have to outlive this one.
+        auto attach_renderer(graphics::render_device& device, render_thread& thread) -> void;
+
+        // Every frame the render thread draws from then on is written to <directory>/<prefix>_<n>.chromeframe,
+        // for chrome_replay. Has to be set before the renderer is attached.
+        auto capture_frames(std::string const& directory, std::string const& prefix) -> void;
+
         auto show_window() -> void;
         auto hide_window() -> void;
 
+        // Marks the whole client area, or a part of it in DIPs, for repainting on the next scheduled frame.
+        auto invalidate() -> void;
+        auto invalidate(measure::rectangle<float> const& area) -> void;
+
+        // Paints whatever got invalidated, called by the loop when the scheduler hands out a frame.
+        // Painting only lays out and records, the frame goes to the render thread.
+        auto update() -> void;
+
+        // Render thread, with the device locked. Renders the latest queued frame, returns false if there was none.
+        auto render() -> bool;
+
+        // When the first frame was rendered, for the startup timeline.
+        auto get_first_frame_time() const -> std::optional<std::chrono::steady_clock::time_point>;
+
+        // Frames handed to the render thread, pushed back by it and dropped because it fell behind.
+        auto get_frame_statistics() const { return _frame_queue.get_statistics(); }
+
+        // Destroyed by the user, the application drops it.
+        auto is_closed() const { return _is_closed; }
+
+        // Redraws, stretched presentations, size change latency and commit waits, accumulated across resizes.
+        auto& get_live_resize_statistics() const { return _live_resize.get_statistics(); }
+
     private:
 
         auto paint() -> void;
-        auto paint_mock_tabs(measure::rectangle<float> const& client_rectangle) -> void;
-        auto paint_mock_toolbar(measure::rectangle<float> const& client_rectangle) -> void;
-        auto paint_mock_sidebar(measure::rectangle<float> const& client_rectangle) -> void;
 
-        auto handle_resize() -> void;
+        // False if the render thread is behind, the frame isn't even described and another paint is requested.
+        template <typename Describe>
+        auto submit(Describe&& describe) -> bool {
+
+            if (!_frame_queue.try_submit(std::forward<Describe>(describe))) {
+                _frame_scheduler->request_frame();
+                return false;
+            }
+
+            _render_thread->wake();
+            return true;
+
+        }
+
+        auto wait_for_commit() -> std::chrono::steady_clock::duration;
+
+        auto capture_frame(graphics::layer_tree const& layers, measure::size<float> const& client_size) -> void;
+
+        // Bracket the modal size loop (WM_ENTERSIZEMOVE, WM_EXITSIZEMOVE).
+        auto begin_live_resize() -> void;
+        auto end_live_resize() -> void;
+
+        auto handle_resize(WPARAM resize_type) -> void;
+        auto handle_move() -> void;
+
+        // Registers borders, caption and the scene's interactive parts, in client pixels.
+        auto rebuild_hit_test_map() -> void;
+        auto update_visibility(bool const shown) -> void;
 
         HWND _system_window_handle = nullptr;
         MARGINS _margins {};
         std::string _title;
+        frame_scheduler* _frame_scheduler = nullptr;
+        bool _is_closed = false;
         float _user_scaling = 96.0f;
         float _client_area_offset_dip = 0.0f;
         
+        graphics::render_device* _device = nullptr;
+        render_thread* _render_thread = nullptr;
+        std::uint64_t _upload_generation = 0; // Of the device, when this window last drew.
+        bool _is_rendering_live_resize = false; // As last submitted.
+
+        // Only ever touched by the render thread once attached.
         std::unique_ptr<graphics::renderer> _renderer;
+        std::atomic<std::chrono::steady_clock::rep> _first_frame_ticks { 0 };
+        std::string _capture_path_prefix; // Empty unless capturing.
+        std::uint64_t _captured_frames = 0;
+
+        frame_queue<window_frame> _frame_queue;
+
+        // Every part of the mockup lives in its own layer, laid out again when the client area changes.
+        // Invalidations accumulate in the layers and are consumed by paint.
+        graphics::layer_tree _layers;
+        measure::size<float> _layout_size { 0.0f, 0.0f };
+
+        // Throttles redraws while an edge is dragged, in between the last frame is presented at the new size.
+        live_resize _live_resize;
+
+        mock_scene _mock_scene;
 
-        std::unique_ptr<resource::image> _tab_raster;
-        std::unique_ptr<resource::image> _new_tab_symbol;
+        // Rebuilt on resize, WM_NCHITTEST only subtracts the cached client origin (in screen pixels) and looks up.
+        hit_test_map _hit_test_map;
+        measure::point<std::int32_t> _client_origin { 0, 0 };
 
     };
 
@@ -11,42 +11,28 @@
 #include <vssym32.h>
 #include <Uxtheme.h>
 
-namespace chrome::gui::helper {
-
-    // Simplest variant, just to get you started.
-    auto compute_sector_of_window(HWND window_handle, WPARAM, LPARAM lparam, int caption_height) -> LRESULT {
-
-        // Acquire the window rect
-        RECT window_rectangle;
-        GetWindowRect(window_handle, &window_rectangle);
-
-        auto offset = 10;
-
-        POINT cursor_position{
-            GET_X_LPARAM(lparam),
-            GET_Y_LPARAM(lparam)
-        };
+#include <gui/hit_test_map.hpp>
 
-        if (cursor_position.y < window_rectangle.top + offset && cursor_position.x < window_rectangle.left + offset) return HTTOPLEFT;
-        if (cursor_position.y < window_rectangle.top + offset && cursor_position.x > window_rectangle.right - offset) return HTTOPRIGHT;
-        if (cursor_position.y > window_rectangle.bottom - offset && cursor_position.x > window_rectangle.right - offset) return HTBOTTOMRIGHT;
-        if (cursor_position.y > window_rectangle.bottom - offset && cursor_position.x < window_rectangle.left + offset) return HTBOTTOMLEFT;
-
-        if (cursor_position.x > window_rectangle.left && cursor_position.x < window_rectangle.right) {
-            if (cursor_position.y < window_rectangle.top + offset) return HTTOP;
-            else if (cursor_position.y > window_rectangle.bottom - offset) return HTBOTTOM;
-        }
-        if (cursor_position.y > window_rectangle.top && cursor_position.y < window_rectangle.bottom) {
-            if (cursor_position.x < window_rectangle.left + offset) return HTLEFT;
-            else if (cursor_position.x > window_rectangle.right - offset) return HTRIGHT;
-        }
+namespace chrome::gui::helper {
 
-        if (cursor_position.x > window_rectangle.left && cursor_position.x < window_rectangle.right) {
-            if (cursor_position.y < window_rectangle.top + caption_height) return HTCAPTION;
+    // Interactive chrome gets client clicks, everything else maps its sector onto the matching HT* code.
+    auto to_hit_test_code(hit_test_result const& hit) -> LRESULT {
+
+        if (hit.kind == hit_region_kind::interactive) return HTCLIENT;
+
+        switch (hit.sector) {
+            case window_sector::caption: return HTCAPTION;
+            case window_sector::left: return HTLEFT;
+            case window_sector::right: return HTRIGHT;
+            case window_sector::top: return HTTOP;
+            case window_sector::bottom: return HTBOTTOM;
+            case window_sector::top_left: return HTTOPLEFT;
+            case window_sector::top_right: return HTTOPRIGHT;
+            case window_sector::bottom_left: return HTBOTTOMLEFT;
+            case window_sector::bottom_right: return HTBOTTOMRIGHT;
+            default: return HTNOWHERE;
         }
 
-        return HTNOWHERE;
-
     }
 
     auto compute_standard_caption_height_for_window(HWND window_handle) {
@@ -0,0 +1,53 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdint>
+
+#include <utility/measure.hpp>
+
+// Portable part of WM_NCHITTEST, the window helper maps sectors to HT* codes.
+
+namespace chrome::gui {
+
+    enum struct window_sector : std::uint8_t {
+        nowhere,
+        caption,
+        left, right, top, bottom,
+        top_left, top_right, bottom_left, bottom_right
+    };
+
+    // Window and cursor in the same (screen) coordinates, border is how far in from the edge resizing reaches.
+    inline auto classify_window_sector(
+        measure::rectangle<std::int32_t> const& window, measure::point<std::int32_t> const& cursor,
+        std::int32_t const border, std::int32_t const caption_height
+    ) -> window_sector {
+
+        auto left = window.origin.x, top = window.origin.y;
+        auto right = window.right(), bottom = window.bottom();
+        auto [x, y] = cursor;
+
+        if (y < top + border && x < left + border) return window_sector::top_left;
+        if (y < top + border && x > right - border) return window_sector::top_right;
+        if (y > bottom - border && x > right - border) return window_sector::bottom_right;
+        if (y > bottom - border && x < left + border) return window_sector::bottom_left;
+
+        if (x > left && x < right) {
+            if (y < top + border) return window_sector::top;
+            else if (y > bottom - border) return window_sector::bottom;
+        }
+        if (y > top && y < bottom) {
+            if (x < left + border) return window_sector::left;
+            else if (x > right - border) return window_sector::right;
+        }
+
+        if (x > left && x < right) {
+            if (y < top + caption_height) return window_sector::caption;
+        }
+
+        return window_sector::nowhere;
+
+    }
+
+}
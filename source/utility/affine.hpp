@@ -0,0 +1,220 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CHROME_AFFINE_SSE2
+#endif
+
+#include <utility/measure.hpp>
+
+namespace measure {
+
+    // 3x2 affine matrix, laid out the same way D2D1::Matrix3x2F is (row vectors), so it converts
+    // member for member. Kept an aggregate and trivially copyable so it can live inside recorded
+    // command buffers and be built at compile time.
+    struct affine2d {
+
+        float m11, m12;
+        float m21, m22;
+        float dx, dy;
+
+        static constexpr auto identity() -> affine2d {
+            return { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+        }
+
+        static constexpr auto translation(float const x, float const y) -> affine2d {
+            return { 1.0f, 0.0f, 0.0f, 1.0f, x, y };
+        }
+
+        static constexpr auto scale(float const x, float const y) -> affine2d {
+            return { x, 0.0f, 0.0f, y, 0.0f, 0.0f };
+        }
+
+        // Angle in radians, clockwise in a y-down space.
+        static auto rotation(float const angle) -> affine2d {
+            auto sine = std::sin(angle), cosine = std::cos(angle);
+            return { cosine, sine, -sine, cosine, 0.0f, 0.0f };
+        }
+
+        constexpr auto transform_point(point<float> const& point) const {
+            return measure::point<float> {
+                point.x * m11 + point.y * m21 + dx,
+                point.x * m12 + point.y * m22 + dy
+            };
+        }
+
+        // Only rotation and scale, for directions and sizes.
+        constexpr auto transform_vector(point<float> const& vector) const {
+            return point<float> { vector.x * m11 + vector.y * m21, vector.x * m12 + vector.y * m22 };
+        }
+
+        // Largest factor anything gets stretched by, a rough "how big does it end up on screen".
+        auto get_scale() const {
+            auto x_scale = std::hypot(m11, m12), y_scale = std::hypot(m21, m22);
+            return x_scale > y_scale ? x_scale : y_scale;
+        }
+
+        // Rectangles stay rectangles, no rotation or shear.
+        constexpr auto is_axis_aligned() const {
+            return m12 == 0.0f && m21 == 0.0f;
+        }
+
+        // Same semantics as D2D, lhs is applied first.
+        friend constexpr auto operator*(affine2d const& lhs, affine2d const& rhs) -> affine2d {
+
+#if defined(CHROME_AFFINE_SSE2)
+            if (!std::is_constant_evaluated()) {
+
+                // Both linear rows at once: [l11 l11 l21 l21] * [r11 r12 r11 r12] + [l12 l12 l22 l22] * [r21 r22 r21 r22].
+                auto l = _mm_loadu_ps(&lhs.m11);
+                auto r = _mm_loadu_ps(&rhs.m11);
+                auto r_row1 = _mm_movelh_ps(r, r);
+                auto r_row2 = _mm_movehl_ps(r, r);
+
+                auto linear = _mm_add_ps(
+                    _mm_mul_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(2, 2, 0, 0)), r_row1),
+                    _mm_mul_ps(_mm_shuffle_ps(l, l, _MM_SHUFFLE(3, 3, 1, 1)), r_row2)
+                );
+
+                auto translation = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(lhs.dx), r_row1), _mm_mul_ps(_mm_set1_ps(lhs.dy), r_row2)),
+                    _mm_setr_ps(rhs.dx, rhs.dy, 0.0f, 0.0f)
+                );
+
+                affine2d result;
+                _mm_storeu_ps(&result.m11, linear);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(&result.dx), _mm_castps_si128(translation));
+                return result;
+
+            }
+#endif
+
+            return {
+                lhs.m11 * rhs.m11 + lhs.m12 * rhs.m21,
+                lhs.m11 * rhs.m12 + lhs.m12 * rhs.m22,
+                lhs.m21 * rhs.m11 + lhs.m22 * rhs.m21,
+                lhs.m21 * rhs.m12 + lhs.m22 * rhs.m22,
+                lhs.dx * rhs.m11 + lhs.dy * rhs.m21 + rhs.dx,
+                lhs.dx * rhs.m12 + lhs.dy * rhs.m22 + rhs.dy
+            };
+
+        }
+
+    };
+
+    // Axis aligned box around the transformed rectangle, exact as long as the transform is axis aligned.
+    constexpr auto transform_bounds(affine2d const& transform, rectangle<float> const& area) {
+
+        auto& [origin, dimension] = area;
+        auto x0 = origin.x, y0 = origin.y;
+        auto x1 = origin.x + dimension.width, y1 = origin.y + dimension.height;
+
+        // Each corner coordinate is the sum of one term per input axis, so extremes add up independently.
+        auto min_max = [](float const a, float const b, float& lower, float& upper) {
+            if (a < b) { lower += a; upper += b; }
+            else { lower += b; upper += a; }
+        };
+
+        auto left = transform.dx, right = transform.dx;
+        auto top = transform.dy, bottom = transform.dy;
+
+        min_max(x0 * transform.m11, x1 * transform.m11, left, right);
+        min_max(y0 * transform.m21, y1 * transform.m21, left, right);
+        min_max(x0 * transform.m12, x1 * transform.m12, top, bottom);
+        min_max(y0 * transform.m22, y1 * transform.m22, top, bottom);
+
+        return rectangle<float> { left, top, right - left, bottom - top };
+
+    }
+
+    // Batched variants, source and destination may be the same array.
+    inline auto transform_points(affine2d const& transform, point<float> const* source, point<float>* destination, std::size_t const count) -> void {
+
+        static_assert(sizeof(point<float>) == 2 * sizeof(float), "Points are expected to be tightly packed.");
+
+        std::size_t i = 0;
+
+#if defined(CHROME_AFFINE_SSE2)
+        // Two points per register, [x0 y0 x1 y1].
+        auto row1 = _mm_setr_ps(transform.m11, transform.m12, transform.m11, transform.m12);
+        auto row2 = _mm_setr_ps(transform.m21, transform.m22, transform.m21, transform.m22);
+        auto offset = _mm_setr_ps(transform.dx, transform.dy, transform.dx, transform.dy);
+
+        auto map = [&](__m128 const points) {
+            auto x = _mm_shuffle_ps(points, points, _MM_SHUFFLE(2, 2, 0, 0));
+            auto y = _mm_shuffle_ps(points, points, _MM_SHUFFLE(3, 3, 1, 1));
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, row1), _mm_mul_ps(y, row2)), offset);
+        };
+
+        // Two registers per iteration, so the shuffles of one overlap the arithmetic of the other.
+        for (; i + 4 <= count; i += 4) {
+
+            auto low = _mm_loadu_ps(&source[i].x), high = _mm_loadu_ps(&source[i + 2].x);
+            _mm_storeu_ps(&destination[i].x, map(low));
+            _mm_storeu_ps(&destination[i + 2].x, map(high));
+
+        }
+
+        if (i + 2 <= count) { _mm_storeu_ps(&destination[i].x, map(_mm_loadu_ps(&source[i].x))); i += 2; }
+#endif
+
+        for (; i < count; ++i) destination[i] = transform.transform_point(source[i]);
+
+    }
+
+    inline auto transform_bounds(affine2d const& transform, rectangle<float> const* source, rectangle<float>* destination, std::size_t const count) -> void {
+
+        static_assert(sizeof(rectangle<float>) == 4 * sizeof(float), "Rectangles are expected to be tightly packed.");
+
+        std::size_t i = 0;
+
+#if defined(CHROME_AFFINE_SSE2)
+        // Four rectangles at a time, transposed so every register holds one field of all four.
+        auto m11 = _mm_set1_ps(transform.m11), m12 = _mm_set1_ps(transform.m12);
+        auto m21 = _mm_set1_ps(transform.m21), m22 = _mm_set1_ps(transform.m22);
+        auto dx = _mm_set1_ps(transform.dx), dy = _mm_set1_ps(transform.dy);
+
+        for (; i + 4 <= count; i += 4) {
+
+            auto x = _mm_loadu_ps(&source[i].origin.x);
+            auto y = _mm_loadu_ps(&source[i + 1].origin.x);
+            auto width = _mm_loadu_ps(&source[i + 2].origin.x);
+            auto height = _mm_loadu_ps(&source[i + 3].origin.x);
+            _MM_TRANSPOSE4_PS(x, y, width, height);
+
+            auto right = _mm_add_ps(x, width), bottom = _mm_add_ps(y, height);
+
+            // Same as the scalar version, the extremes of every term add up independently.
+            auto x_a = _mm_mul_ps(x, m11), x_b = _mm_mul_ps(right, m11);
+            auto y_a = _mm_mul_ps(y, m21), y_b = _mm_mul_ps(bottom, m21);
+            auto left = _mm_add_ps(_mm_add_ps(_mm_min_ps(x_a, x_b), _mm_min_ps(y_a, y_b)), dx);
+            auto new_right = _mm_add_ps(_mm_add_ps(_mm_max_ps(x_a, x_b), _mm_max_ps(y_a, y_b)), dx);
+
+            x_a = _mm_mul_ps(x, m12); x_b = _mm_mul_ps(right, m12);
+            y_a = _mm_mul_ps(y, m22); y_b = _mm_mul_ps(bottom, m22);
+            auto top = _mm_add_ps(_mm_add_ps(_mm_min_ps(x_a, x_b), _mm_min_ps(y_a, y_b)), dy);
+            auto new_bottom = _mm_add_ps(_mm_add_ps(_mm_max_ps(x_a, x_b), _mm_max_ps(y_a, y_b)), dy);
+
+            auto new_width = _mm_sub_ps(new_right, left), new_height = _mm_sub_ps(new_bottom, top);
+            _MM_TRANSPOSE4_PS(left, top, new_width, new_height);
+
+            _mm_storeu_ps(&destination[i].origin.x, left);
+            _mm_storeu_ps(&destination[i + 1].origin.x, top);
+            _mm_storeu_ps(&destination[i + 2].origin.x, new_width);
+            _mm_storeu_ps(&destination[i + 3].origin.x, new_height);
+
+        }
+#endif
+
+        for (; i < count; ++i) destination[i] = transform_bounds(transform, source[i]);
+
+    }
+
+}
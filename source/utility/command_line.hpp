@@ -0,0 +1,27 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+namespace utility {
+
+    // Parses the positive number after prefix, if the argument starts with it. Leaves value alone otherwise.
+    inline auto parse_number_argument(std::string_view const argument, std::string_view const prefix, int& value) {
+
+        if (argument.substr(0, prefix.size()) != prefix) return false;
+
+        auto number = std::string { argument.substr(prefix.size()) };
+        char* end = nullptr;
+        auto parsed = std::strtol(number.c_str(), &end, 10);
+        if (number.empty() || *end != '\0' || parsed <= 0) return false;
+
+        value = static_cast<int>(parsed);
+        return true;
+
+    }
+
+}
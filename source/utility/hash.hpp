@@ -0,0 +1,39 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace utility {
+
+    // FNV-1a, good enough for short keys like labels and font family names.
+    inline auto hash_bytes(void const* data, std::size_t const size, std::uint64_t hash = 14695981039346656037ull) {
+
+        auto bytes = static_cast<unsigned char const*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+
+    }
+
+    inline auto hash_string(std::string_view const string, std::uint64_t const seed = 14695981039346656037ull) {
+        return hash_bytes(string.data(), string.size(), seed);
+    }
+
+    template <typename T>
+    inline auto hash_value(T const& value, std::uint64_t const seed = 14695981039346656037ull) {
+        return hash_bytes(&value, sizeof(T), seed);
+    }
+
+    inline auto hash_combine(std::size_t const seed, std::size_t const value) -> std::size_t {
+        return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+
+}
@@ -0,0 +1,146 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace utility {
+
+    struct cache_statistics {
+        std::uint64_t hits = 0, misses = 0, evictions = 0;
+    };
+
+    // Fixed capacity map that evicts the least recently used entry.
+    // Hash and Equal can be transparent, in which case lookups don't have to build an owning key
+    // (e.g. looking up with string views into a cache keyed by strings).
+    template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<>>
+    struct lru_cache {
+
+        explicit lru_cache(std::size_t const capacity) : _capacity(capacity > 0 ? capacity : 1) {
+            _index.reserve(_capacity);
+        }
+
+        lru_cache(lru_cache const&) = delete;
+        lru_cache(lru_cache&&) = default;
+        lru_cache& operator=(lru_cache const&) = delete;
+        lru_cache& operator=(lru_cache&&) = default;
+
+        ~lru_cache() = default;
+
+        // Returns nullptr on a miss, a hit makes the entry the most recently used one.
+        template <typename LookupKey>
+        auto find(LookupKey const& key) -> Value* {
+
+            auto lookup_iterator = _index.find(key);
+
+            if (lookup_iterator == _index.end()) { ++_statistics.misses; return nullptr; }
+
+            ++_statistics.hits;
+            _entries.splice(_entries.begin(), _entries, lookup_iterator->second);
+
+            return &lookup_iterator->second->second;
+
+        }
+
+        auto insert(Key key, Value value) -> Value& {
+
+            auto lookup_iterator = _index.find(key);
+
+            if (lookup_iterator != _index.end()) {
+                _entries.splice(_entries.begin(), _entries, lookup_iterator->second);
+                return lookup_iterator->second->second = std::move(value);
+            }
+
+            if (_entries.size() >= _capacity) evict_one();
+
+            _entries.emplace_front(std::move(key), std::move(value));
+            _index.emplace(key_reference { &_entries.front().first }, _entries.begin());
+
+            return _entries.front().second;
+
+        }
+
+        // Creator is only invoked on a miss, it has to return something Key can be built from first and the value second.
+        template <typename LookupKey, typename Create>
+        auto get_or_create(LookupKey const& key, Create&& create) -> Value& {
+
+            if (auto value = find(key)) return *value;
+
+            auto [owning_key, value] = create();
+            return insert(std::move(owning_key), std::move(value));
+
+        }
+
+        template <typename LookupKey>
+        auto erase(LookupKey const& key) -> bool {
+
+            auto lookup_iterator = _index.find(key);
+            if (lookup_iterator == _index.end()) return false;
+
+            auto entry = lookup_iterator->second;
+            _index.erase(lookup_iterator);
+            _entries.erase(entry);
+
+            return true;
+
+        }
+
+        auto clear() -> void {
+            _index.clear();
+            _entries.clear();
+        }
+
+        auto set_capacity(std::size_t const capacity) -> void {
+            _capacity = capacity > 0 ? capacity : 1;
+            while (_entries.size() > _capacity) evict_one();
+        }
+
+        auto size() const { return _entries.size(); }
+        auto capacity() const { return _capacity; }
+
+        auto& get_statistics() const { return _statistics; }
+        auto reset_statistics() -> void { _statistics = {}; }
+
+    private:
+
+        using entry_list = std::list<std::pair<Key, Value>>;
+
+        // The index refers to keys stored in the list nodes, which never move.
+        struct key_reference { Key const* key; };
+
+        struct reference_hash {
+            using is_transparent = void;
+            auto operator()(key_reference const& reference) const { return Hash {}(*reference.key); }
+            template <typename LookupKey> auto operator()(LookupKey const& key) const { return Hash {}(key); }
+        };
+
+        struct reference_equal {
+            using is_transparent = void;
+            auto operator()(key_reference const& lhs, key_reference const& rhs) const -> bool { return Equal {}(*lhs.key, *rhs.key); }
+            template <typename LookupKey> auto operator()(key_reference const& lhs, LookupKey const& rhs) const -> bool { return Equal {}(*lhs.key, rhs); }
+            template <typename LookupKey> auto operator()(LookupKey const& lhs, key_reference const& rhs) const -> bool { return Equal {}(lhs, *rhs.key); }
+        };
+
+        auto evict_one() -> void {
+
+            auto& least_recent = _entries.back();
+            _index.erase(key_reference { &least_recent.first });
+            _entries.pop_back();
+            ++_statistics.evictions;
+
+        }
+
+        entry_list _entries;
+        std::unordered_map<key_reference, typename entry_list::iterator, reference_hash, reference_equal> _index;
+        std::size_t _capacity;
+        cache_statistics _statistics;
+
+    };
+
+}
@@ -12,7 +12,7 @@ namespace measure {
         T x, y;
 
         point() = default;
-        point(T const x, T const y) : x(x), y(y) {}
+        constexpr point(T const x, T const y) : x(x), y(y) {}
 
         auto& operator*=(T rhs) {
             this->x *= rhs; this->y *= rhs;
@@ -30,7 +30,7 @@ namespace measure {
         T width, height;
 
         size() = default;
-        size(T const width, T const height) 
+        constexpr size(T const width, T const height) 
         : width(width), height(height) {}
 
         auto& operator*=(T rhs) {
@@ -51,10 +51,10 @@ namespace measure {
 
         rectangle() = default;
 
-        rectangle(T const x, T const y, T const w, T const h)
+        constexpr rectangle(T const x, T const y, T const w, T const h)
         : origin{ x, y }, dimension{ w, h } {}
 
-        rectangle(point<T> const& origin, size<T> const& dimension)
+        constexpr rectangle(point<T> const& origin, size<T> const& dimension)
         : origin{ origin }, dimension{ dimension } {}
 
         auto& operator*=(T rhs) {
@@ -66,8 +66,60 @@ namespace measure {
             return lhs *= rhs;
         }
 
+        auto right() const { return origin.x + dimension.width; }
+        auto bottom() const { return origin.y + dimension.height; }
+        auto area() const { return dimension.width * dimension.height; }
+
+        auto is_empty() const {
+            return !(dimension.width > T{}) || !(dimension.height > T{});
+        }
+
+        auto contains(point<T> const& point) const {
+            return point.x >= origin.x && point.x < right() && point.y >= origin.y && point.y < bottom();
+        }
+
+        auto contains(rectangle<T> const& other) const {
+            return other.origin.x >= origin.x && other.right() <= right()
+                && other.origin.y >= origin.y && other.bottom() <= bottom();
+        }
+
+        auto intersects(rectangle<T> const& other) const {
+            return other.origin.x < right() && origin.x < other.right()
+                && other.origin.y < bottom() && origin.y < other.bottom();
+        }
+
     };
 
+    // Overlapping part of both rectangles, empty if they don't intersect.
+    template<typename T>
+    auto intersect(rectangle<T> const& lhs, rectangle<T> const& rhs) {
+
+        auto left = lhs.origin.x > rhs.origin.x ? lhs.origin.x : rhs.origin.x;
+        auto top = lhs.origin.y > rhs.origin.y ? lhs.origin.y : rhs.origin.y;
+        auto right = lhs.right() < rhs.right() ? lhs.right() : rhs.right();
+        auto bottom = lhs.bottom() < rhs.bottom() ? lhs.bottom() : rhs.bottom();
+
+        if (!(right > left) || !(bottom > top)) return rectangle<T> { left, top, T{}, T{} };
+        return rectangle<T> { left, top, right - left, bottom - top };
+
+    }
+
+    // Smallest rectangle enclosing both, empty rectangles are ignored.
+    template<typename T>
+    auto unite(rectangle<T> const& lhs, rectangle<T> const& rhs) {
+
+        if (lhs.is_empty()) return rhs;
+        if (rhs.is_empty()) return lhs;
+
+        auto left = lhs.origin.x < rhs.origin.x ? lhs.origin.x : rhs.origin.x;
+        auto top = lhs.origin.y < rhs.origin.y ? lhs.origin.y : rhs.origin.y;
+        auto right = lhs.right() > rhs.right() ? lhs.right() : rhs.right();
+        auto bottom = lhs.bottom() > rhs.bottom() ? lhs.bottom() : rhs.bottom();
+
+        return rectangle<T> { left, top, right - left, bottom - top };
+
+    }
+
     struct color {
         float r, g, b, a;
 
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <cstdio>
+
+#include <utility/profiler.hpp>
+
+namespace utility::profiler {
+
+    namespace {
+
+        std::atomic<bool> enabled { true };
+
+        struct registry {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<thread_buffer>> buffers;
+        };
+
+        auto get_registry() -> registry& {
+            static registry instance;
+            return instance;
+        }
+
+        auto get_origin() {
+            static auto origin = std::chrono::steady_clock::now();
+            return origin;
+        }
+
+        auto write_escaped(std::ostream& output, char const* text) -> void {
+
+            for (; *text != '\0'; ++text) {
+                if (*text == '"' || *text == '\\') output << '\\';
+                if (static_cast<unsigned char>(*text) >= 0x20) output << *text;
+            }
+
+        }
+
+        auto write_microseconds(std::ostream& output, std::int64_t const nanoseconds) -> void {
+
+            char formatted[32];
+            std::snprintf(formatted, sizeof(formatted), "%.3f", static_cast<double>(nanoseconds) / 1000.0);
+            output << formatted;
+
+        }
+
+    }
+
+    auto set_enabled(bool const is_enabled) -> void {
+        enabled.store(is_enabled, std::memory_order_relaxed);
+    }
+
+    auto is_enabled() -> bool {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    auto now() -> std::int64_t {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - get_origin()).count();
+    }
+
+    auto get_thread_buffer() -> thread_buffer& {
+
+        thread_local auto buffer = [] {
+
+            auto created = std::make_shared<thread_buffer>();
+            auto& [mutex, buffers] = get_registry();
+
+            std::lock_guard lock { mutex };
+            created->thread_index = static_cast<std::uint32_t>(buffers.size());
+            buffers.push_back(created);
+
+            return created;
+
+        }();
+
+        return *buffer;
+
+    }
+
+    auto record_zone(char const* name, std::int64_t const start, std::int64_t const end) -> void {
+        get_thread_buffer().events.push({ name, start, end - start, event_type::zone });
+    }
+
+    auto add_counter(char const* name, std::int64_t const delta) -> void {
+
+        if (!is_enabled()) return;
+
+        // A handful of names per thread, a linear scan beats hashing.
+        auto& counters = get_thread_buffer().counters;
+        for (auto& [counter_name, value] : counters) {
+            if (counter_name == name) { value += delta; return; }
+        }
+
+        counters.emplace_back(name, delta);
+
+    }
+
+    frame::~frame() {
+
+        if (!_name) return;
+
+        auto end = now();
+        auto& buffer = get_thread_buffer();
+        buffer.events.push({ _name, _start, end - _start, event_type::frame });
+
+        // Names stay registered, so counting the next frame doesn't allocate.
+        for (auto& [name, value] : buffer.counters) {
+            buffer.events.push({ name, end, value, event_type::counter });
+            value = 0;
+        }
+
+    }
+
+    auto frame_histogram::add(std::int64_t const duration) -> void {
+
+        auto bucket = static_cast<std::size_t>(std::max<std::int64_t>(duration, 0) / bucket_width);
+        if (bucket < bucket_count) ++_buckets[bucket];
+        else ++_overflow;
+
+        ++_count;
+        _total += duration;
+        _maximum = std::max(_maximum, duration);
+
+    }
+
+    auto frame_histogram::get_percentile(double const percentile) const -> std::int64_t {
+
+        if (_count == 0) return 0;
+
+        auto target = static_cast<std::uint64_t>(std::clamp(percentile, 0.0, 1.0) * static_cast<double>(_count));
+        target = std::max<std::uint64_t>(target, 1);
+
+        std::uint64_t seen = 0;
+        for (std::size_t bucket = 0; bucket < bucket_count; ++bucket) {
+            seen += _buckets[bucket];
+            if (seen >= target) return static_cast<std::int64_t>(bucket + 1) * bucket_width;
+        }
+
+        return _maximum;
+
+    }
+
+    auto collector::collect() -> void {
+
+        auto& [mutex, buffers] = get_registry();
+        std::lock_guard lock { mutex };
+
+        for (auto& buffer : buffers) {
+            buffer->events.drain([this, thread_index = buffer->thread_index](event const& drained) {
+                _events.push_back({ drained, thread_index });
+                if (drained.type == event_type::frame) _frame_times.add(drained.value);
+            });
+        }
+
+    }
+
+    auto collector::clear() -> void {
+        _events.clear();
+        _frame_times = {};
+    }
+
+    auto collector::get_dropped() const -> std::uint64_t {
+
+        auto& [mutex, buffers] = get_registry();
+        std::lock_guard lock { mutex };
+
+        std::uint64_t dropped = 0;
+        for (auto& buffer : buffers) dropped += buffer->events.get_dropped();
+
+        return dropped;
+
+    }
+
+    auto collector::export_chrome_trace(std::ostream& output) const -> void {
+
+        output << "{\"traceEvents\":[";
+
+        auto first = true;
+        for (auto& [recorded, thread_index] : _events) {
+
+            output << (first ? "\n" : ",\n");
+            first = false;
+
+            output << "{\"name\":\"";
+            write_escaped(output, recorded.name);
+            output << "\",\"pid\":1,\"tid\":" << thread_index << ",\"ts\":";
+            write_microseconds(output, recorded.start);
+
+            if (recorded.type == event_type::counter) {
+                output << ",\"ph\":\"C\",\"args\":{\"value\":" << recorded.value << "}}";
+                continue;
+            }
+
+            output << ",\"ph\":\"X\",\"dur\":";
+            write_microseconds(output, recorded.value);
+            if (recorded.type == event_type::frame) output << ",\"cat\":\"frame\"";
+            output << "}";
+
+        }
+
+        output << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    }
+
+}
@@ -0,0 +1,208 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Frame profiler. Zones, counters and frames are pushed into a lock-free ring owned by the thread that
+// records them, a collector drains every ring from whichever thread it runs on and exports the lot in the
+// Chrome trace event format (chrome://tracing, Perfetto). Names have to be string literals, only the
+// pointer is stored.
+//
+// The CHROME_PROFILE_* macros compile to nothing unless CHROME_ENABLE_PROFILER is defined, when they are
+// compiled in recording can still be switched off at runtime for the cost of a relaxed load.
+
+namespace utility::profiler {
+
+    enum struct event_type : std::uint8_t { zone, counter, frame };
+
+    struct event {
+        char const* name;
+        std::int64_t start;     // Nanoseconds since the profiler came up.
+        std::int64_t value;     // Duration in nanoseconds for zones and frames, the count for counters.
+        event_type type;
+    };
+
+    // Single producer, single consumer. Full rings drop new events rather than blocking the producer.
+    template <std::size_t Capacity>
+    struct event_ring {
+
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two.");
+
+        auto push(event const& pushed) -> bool {
+
+            auto head = _head.load(std::memory_order_relaxed);
+            if (head - _tail.load(std::memory_order_acquire) == Capacity) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            _events[head & (Capacity - 1)] = pushed;
+            _head.store(head + 1, std::memory_order_release);
+
+            return true;
+
+        }
+
+        template <typename Consume>
+        auto drain(Consume&& consume) -> std::size_t {
+
+            auto tail = _tail.load(std::memory_order_relaxed);
+            auto head = _head.load(std::memory_order_acquire);
+
+            for (auto i = tail; i != head; ++i) consume(_events[i & (Capacity - 1)]);
+            _tail.store(head, std::memory_order_release);
+
+            return static_cast<std::size_t>(head - tail);
+
+        }
+
+        auto get_dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+    private:
+
+        // Producer and consumer indices on their own cache lines, so they don't bounce between cores.
+        alignas(64) std::atomic<std::uint64_t> _head { 0 };
+        alignas(64) std::atomic<std::uint64_t> _tail { 0 };
+        std::atomic<std::uint64_t> _dropped { 0 };
+
+        std::array<event, Capacity> _events;
+
+    };
+
+    constexpr std::size_t ring_capacity = 16384;
+
+    // Counters add up per thread and go out as one event each when the thread's frame ends.
+    struct thread_buffer {
+
+        std::uint32_t thread_index = 0;
+        event_ring<ring_capacity> events;
+
+        std::vector<std::pair<char const*, std::int64_t>> counters;
+
+    };
+
+    auto set_enabled(bool const enabled) -> void;
+    auto is_enabled() -> bool;
+
+    auto now() -> std::int64_t;
+
+    // Registered on first use, kept around after the thread exits so nothing it recorded gets lost.
+    auto get_thread_buffer() -> thread_buffer&;
+
+    auto record_zone(char const* name, std::int64_t const start, std::int64_t const end) -> void;
+    auto add_counter(char const* name, std::int64_t const delta) -> void;
+
+    struct zone {
+
+        explicit zone(char const* name) : _name(is_enabled() ? name : nullptr), _start(_name ? now() : 0) {}
+
+        zone(zone const&) = delete;
+        zone(zone&&) = delete;
+        zone& operator=(zone const&) = delete;
+        zone& operator=(zone&&) = delete;
+
+        ~zone() { if (_name) record_zone(_name, _start, now()); }
+
+    private:
+
+        char const* _name;
+        std::int64_t _start;
+
+    };
+
+    // A zone that also ends the thread's frame: counted into the frame time histogram and flushing its counters.
+    struct frame {
+
+        explicit frame(char const* name) : _name(is_enabled() ? name : nullptr), _start(_name ? now() : 0) {}
+
+        frame(frame const&) = delete;
+        frame(frame&&) = delete;
+        frame& operator=(frame const&) = delete;
+        frame& operator=(frame&&) = delete;
+
+        ~frame();
+
+    private:
+
+        char const* _name;
+        std::int64_t _start;
+
+    };
+
+    // Fixed width buckets, anything past the last one lands in the overflow.
+    struct frame_histogram {
+
+        static constexpr std::int64_t bucket_width = 250'000; // 0.25ms
+        static constexpr std::size_t bucket_count = 256;
+
+        auto add(std::int64_t const duration) -> void;
+
+        // Upper bound of the bucket the percentile falls in, in nanoseconds.
+        auto get_percentile(double const percentile) const -> std::int64_t;
+
+        auto get_count() const { return _count; }
+        auto get_maximum() const { return _maximum; }
+        auto get_average() const { return _count > 0 ? _total / static_cast<std::int64_t>(_count) : 0; }
+        auto& get_buckets() const { return _buckets; }
+        auto get_overflow() const { return _overflow; }
+
+    private:
+
+        std::array<std::uint64_t, bucket_count> _buckets {};
+        std::uint64_t _overflow = 0;
+        std::uint64_t _count = 0;
+        std::int64_t _total = 0, _maximum = 0;
+
+    };
+
+    struct collected_event {
+        event recorded;
+        std::uint32_t thread_index;
+    };
+
+    // Drains every thread's ring into one timeline. Collect often enough that the rings don't fill up,
+    // once a frame is plenty.
+    struct collector {
+
+        auto collect() -> void;
+        auto clear() -> void;
+
+        auto& get_events() const { return _events; }
+        auto& get_frame_times() const { return _frame_times; }
+
+        // Events that didn't fit a ring, across all threads since startup.
+        auto get_dropped() const -> std::uint64_t;
+
+        auto export_chrome_trace(std::ostream& output) const -> void;
+
+    private:
+
+        std::vector<collected_event> _events;
+        frame_histogram _frame_times;
+
+    };
+
+}
+
+#define CHROME_PROFILE_CONCATENATE_IMPLEMENTATION(lhs, rhs) lhs##rhs
+#define CHROME_PROFILE_CONCATENATE(lhs, rhs) CHROME_PROFILE_CONCATENATE_IMPLEMENTATION(lhs, rhs)
+
+#if defined(CHROME_ENABLE_PROFILER)
+#define CHROME_PROFILE_ZONE(name) ::utility::profiler::zone CHROME_PROFILE_CONCATENATE(profile_zone_, __LINE__) { name }
+#define CHROME_PROFILE_FRAME(name) ::utility::profiler::frame CHROME_PROFILE_CONCATENATE(profile_frame_, __LINE__) { name }
+#define CHROME_PROFILE_COUNTER(name, delta) ::utility::profiler::add_counter(name, delta)
+#else
+#define CHROME_PROFILE_ZONE(name) static_cast<void>(0)
+#define CHROME_PROFILE_FRAME(name) static_cast<void>(0)
+#define CHROME_PROFILE_COUNTER(name, delta) static_cast<void>(0)
+#endif
@@ -0,0 +1,123 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <utility/measure.hpp>
+
+namespace measure {
+
+    // Set of rectangles describing an area, used for damage tracking.
+    // It's an approximation on purpose: the rectangle count is bounded and once it's exceeded
+    // the two rectangles whose union wastes the least area are merged. Overlaps are allowed,
+    // which only means some pixels get painted twice.
+    template<typename T>
+    struct region {
+
+        region(std::size_t const maximum_rectangles = 8)
+        : _maximum_rectangles(maximum_rectangles > 0 ? maximum_rectangles : 1) {
+            _rectangles.reserve(_maximum_rectangles + 1);
+        }
+
+        auto add(rectangle<T> area) -> void {
+
+            if (area.is_empty()) return;
+
+            for (auto& rectangle : _rectangles)
+                if (rectangle.contains(area)) return;
+
+            // Absorb whatever merges with the new area for free (union isn't bigger than the parts).
+            for (auto i = _rectangles.size(); i-- > 0;) {
+
+                auto& rectangle = _rectangles[i];
+                auto merged = unite(rectangle, area);
+                if (area.contains(rectangle) || merged.area() <= rectangle.area() + area.area()) {
+                    area = merged;
+                    _rectangles.erase(_rectangles.begin() + i);
+                }
+
+            }
+
+            _rectangles.push_back(area);
+            coalesce();
+
+        }
+
+        auto add(region const& other) -> void {
+            for (auto& rectangle : other._rectangles) add(rectangle);
+        }
+
+        // Clips the region to the given area, dropping whatever falls outside.
+        auto intersect(rectangle<T> const& area) -> void {
+
+            for (auto i = _rectangles.size(); i-- > 0;) {
+                _rectangles[i] = measure::intersect(_rectangles[i], area);
+                if (_rectangles[i].is_empty()) _rectangles.erase(_rectangles.begin() + i);
+            }
+
+        }
+
+        auto intersects(rectangle<T> const& area) const {
+
+            for (auto& rectangle : _rectangles)
+                if (rectangle.intersects(area)) return true;
+
+            return false;
+
+        }
+
+        auto get_bounds() const {
+
+            auto bounds = rectangle<T> { T{}, T{}, T{}, T{} };
+            for (auto& rectangle : _rectangles) bounds = unite(bounds, rectangle);
+            return bounds;
+
+        }
+
+        auto clear() -> void { _rectangles.clear(); }
+        auto empty() const { return _rectangles.empty(); }
+
+        auto& get_rectangles() const { return _rectangles; }
+
+    private:
+
+        auto coalesce() -> void {
+
+            while (_rectangles.size() > _maximum_rectangles) {
+
+                auto best_i = std::size_t { 0 }, best_j = std::size_t { 1 };
+                auto best_waste = T{};
+                auto first = true;
+
+                for (std::size_t i = 0; i < _rectangles.size(); ++i)
+                for (std::size_t j = i + 1; j < _rectangles.size(); ++j) {
+
+                    auto& a = _rectangles[i]; auto& b = _rectangles[j];
+                    auto waste = unite(a, b).area() - a.area() - b.area();
+
+                    if (first || waste < best_waste) {
+                        best_i = i; best_j = j; best_waste = waste; first = false;
+                    }
+
+                }
+
+                auto merged = unite(_rectangles[best_i], _rectangles[best_j]);
+                _rectangles.erase(_rectangles.begin() + best_j);
+                _rectangles.erase(_rectangles.begin() + best_i);
+
+                // Re-adding takes care of anything the merged rectangle now swallows.
+                add(merged);
+
+            }
+
+        }
+
+        std::vector<rectangle<T>> _rectangles;
+        std::size_t _maximum_rectangles;
+
+    };
+
+}
@@ -0,0 +1,70 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+namespace utility {
+
+    // Bounded lock-free queue between exactly one producer thread and one consumer thread, neither side ever blocks.
+    // Pushing into a full queue fails and leaves the value alone, what to do about it is up to the producer.
+    template <typename T, std::size_t Capacity>
+    struct spsc_queue {
+
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two.");
+
+        // Producer side.
+        auto try_push(T& value) -> bool {
+
+            auto head = _head.load(std::memory_order_relaxed);
+            if (head - _tail.load(std::memory_order_acquire) == Capacity) return false;
+
+            _slots[head & (Capacity - 1)] = std::move(value);
+            _head.store(head + 1, std::memory_order_release);
+
+            return true;
+
+        }
+
+        // Exact on the producer side, the consumer can only make room.
+        auto is_full() const {
+            return _head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_acquire) == Capacity;
+        }
+
+        // Consumer side.
+        auto try_pop() -> std::optional<T> {
+
+            auto tail = _tail.load(std::memory_order_relaxed);
+            if (tail == _head.load(std::memory_order_acquire)) return std::nullopt;
+
+            auto value = std::optional<T> { std::move(_slots[tail & (Capacity - 1)]) };
+            _tail.store(tail + 1, std::memory_order_release);
+
+            return value;
+
+        }
+
+        // Only a snapshot from any other thread.
+        auto get_size() const {
+            return static_cast<std::size_t>(_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire));
+        }
+
+        static constexpr auto get_capacity() { return Capacity; }
+
+    private:
+
+        // Each index on its own cache line, so producer and consumer don't bounce it between cores.
+        alignas(64) std::atomic<std::uint64_t> _head { 0 };
+        alignas(64) std::atomic<std::uint64_t> _tail { 0 };
+
+        std::array<T, Capacity> _slots {};
+
+    };
+
+}
@@ -0,0 +1,157 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace utility {
+
+    // Where startup time goes. Phases are recorded from any thread as they finish, milestones
+    // (window shown, first frame) as they're reached, both relative to when the timeline was created.
+    struct startup_timeline {
+
+        using clock = std::chrono::steady_clock;
+
+        struct phase {
+            std::string name;
+            clock::duration start, end;
+            std::uint32_t thread; // In order of first appearance, 0 is whoever recorded first.
+        };
+
+        struct milestone {
+            std::string name;
+            clock::duration time;
+        };
+
+        // Records the enclosing block as a phase when it goes out of scope.
+        struct scope {
+
+            scope(startup_timeline* timeline, std::string name)
+            : _timeline(timeline), _name(std::move(name)), _start(clock::now()) {}
+
+            scope(scope const&) = delete;
+            scope(scope&& other) noexcept
+            : _timeline(std::exchange(other._timeline, nullptr)), _name(std::move(other._name)), _start(other._start) {}
+
+            scope& operator=(scope const&) = delete;
+            scope& operator=(scope&&) = delete;
+
+            ~scope() { if (_timeline) _timeline->record(std::move(_name), _start, clock::now()); }
+
+        private:
+
+            startup_timeline* _timeline;
+            std::string _name;
+            clock::time_point _start;
+
+        };
+
+        explicit startup_timeline(clock::time_point const origin = clock::now()) : _origin(origin) {}
+
+        startup_timeline(startup_timeline const&) = delete;
+        startup_timeline(startup_timeline&&) = delete;
+        startup_timeline& operator=(startup_timeline const&) = delete;
+        startup_timeline& operator=(startup_timeline&&) = delete;
+
+        ~startup_timeline() = default;
+
+        [[nodiscard]] auto measure(std::string name) -> scope {
+            return { this, std::move(name) };
+        }
+
+        auto record(std::string name, clock::time_point const start, clock::time_point const end) -> void {
+
+            std::lock_guard lock { _mutex };
+            auto thread = get_thread_index();
+            _phases.push_back({ std::move(name), start - _origin, end - _origin, thread });
+
+        }
+
+        // Only the first time counts, reaching it again later isn't startup anymore.
+        auto mark(std::string name, clock::time_point const time = clock::now()) -> void {
+
+            std::lock_guard lock { _mutex };
+            for (auto& existing : _milestones) if (existing.name == name) return;
+            _milestones.push_back({ std::move(name), time - _origin });
+
+        }
+
+        auto get_milestone(std::string const& name) const -> std::optional<clock::duration> {
+
+            std::lock_guard lock { _mutex };
+            for (auto& existing : _milestones) if (existing.name == name) return existing.time;
+            return std::nullopt;
+
+        }
+
+        // Sorted by start, copied so other threads can keep recording.
+        auto get_phases() const -> std::vector<phase> {
+
+            std::vector<phase> phases;
+            {
+                std::lock_guard lock { _mutex };
+                phases = _phases;
+            }
+
+            std::stable_sort(phases.begin(), phases.end(), [](phase const& lhs, phase const& rhs) { return lhs.start < rhs.start; });
+            return phases;
+
+        }
+
+        // One line per phase and milestone, in milliseconds:
+        //   12.31 ..  40.02  27.71 ms  [1] render device
+        auto report() const -> std::string {
+
+            auto to_milliseconds = [](clock::duration const duration) {
+                return std::chrono::duration<double, std::milli>(duration).count();
+            };
+
+            std::string result;
+            char line[256];
+
+            for (auto& [name, start, end, thread] : get_phases()) {
+                std::snprintf(line, sizeof(line), "%8.2f .. %8.2f %8.2f ms  [%u] %s\n",
+                    to_milliseconds(start), to_milliseconds(end), to_milliseconds(end - start), thread, name.c_str());
+                result += line;
+            }
+
+            std::lock_guard lock { _mutex };
+            for (auto& [name, time] : _milestones) {
+                std::snprintf(line, sizeof(line), "%8.2f ms  %s\n", to_milliseconds(time), name.c_str());
+                result += line;
+            }
+
+            return result;
+
+        }
+
+        auto get_origin() const { return _origin; }
+
+    private:
+
+        auto get_thread_index() -> std::uint32_t {
+            auto [entry, inserted] = _threads.try_emplace(std::this_thread::get_id(), static_cast<std::uint32_t>(_threads.size()));
+            return entry->second;
+        }
+
+        clock::time_point _origin;
+
+        mutable std::mutex _mutex;
+        std::vector<phase> _phases;
+        std::vector<milestone> _milestones;
+        std::unordered_map<std::thread::id, std::uint32_t> _threads;
+
+    };
+
+}
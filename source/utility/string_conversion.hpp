@@ -3,20 +3,17 @@
 
 #pragma once
 
-#include <string>
-#include <Windows.h>
+#include <cstddef>
 
-namespace utility {
-
-    inline auto convert_utf8_to_utf16(std::string const& string) {
+#include <utility/utf8.hpp>
 
-        auto new_size = MultiByteToWideChar(CP_UTF8, 0, string.data(), static_cast<int>(string.size()), nullptr, 0);
-        
-        std::wstring utf16_string; utf16_string.resize(new_size);
-        MultiByteToWideChar(CP_UTF8, 0, string.data(), static_cast<int>(string.size()), utf16_string.data(), new_size);
-
-        return utf16_string;
+namespace utility {
 
+    // wchar_t is UTF-16 on Windows, so the portable buffers go to Win32 as they are.
+    template <std::size_t InlineCapacity>
+    inline auto as_wide(utf16_buffer<InlineCapacity> const& buffer) {
+        static_assert(sizeof(wchar_t) == sizeof(char16_t), "Only for platforms where wchar_t is UTF-16.");
+        return reinterpret_cast<wchar_t const*>(buffer.c_str());
     }
 
 }
\ No newline at end of file
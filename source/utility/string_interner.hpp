@@ -0,0 +1,69 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace utility {
+
+    using string_id = std::uint32_t;
+
+    // Hands out a small dense id per distinct string, for sets of names that keep coming back such as
+    // font families. Strings are never removed, ids and the views get returns stay valid for as long as
+    // the interner lives. Safe to use from several threads, recording and rendering happen on different ones.
+    struct string_interner {
+
+        string_interner() = default;
+
+        string_interner(string_interner const&) = delete;
+        string_interner(string_interner&&) = delete;
+        string_interner& operator=(string_interner const&) = delete;
+        string_interner& operator=(string_interner&&) = delete;
+
+        ~string_interner() = default;
+
+        auto intern(std::string_view string) -> string_id {
+
+            auto lock = std::lock_guard { _mutex };
+
+            if (auto lookup_iterator = _ids.find(string); lookup_iterator != _ids.end()) return lookup_iterator->second;
+
+            // A deque never moves what it holds, so the key can view the stored string.
+            auto id = static_cast<string_id>(_strings.size());
+            auto& stored = _strings.emplace_back(string);
+            _ids.emplace(stored, id);
+
+            return id;
+
+        }
+
+        auto get(string_id const id) const -> std::string_view {
+
+            auto lock = std::lock_guard { _mutex };
+            return _strings[id];
+
+        }
+
+        auto size() const -> std::size_t {
+
+            auto lock = std::lock_guard { _mutex };
+            return _strings.size();
+
+        }
+
+    private:
+
+        mutable std::mutex _mutex;
+        std::deque<std::string> _strings;
+        std::unordered_map<std::string_view, string_id> _ids;
+
+    };
+
+}
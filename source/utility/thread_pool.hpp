@@ -0,0 +1,93 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utility {
+
+    // Plain FIFO pool for background work such as image decoding.
+    // Pending tasks are dropped on destruction, running ones are waited for.
+    struct thread_pool {
+
+        explicit thread_pool(std::size_t thread_count = 0) {
+
+            if (thread_count == 0) thread_count = std::max(1u, std::thread::hardware_concurrency() / 2);
+
+            _threads.reserve(thread_count);
+            for (std::size_t i = 0; i < thread_count; ++i)
+                _threads.emplace_back([this] { work(); });
+
+        }
+
+        thread_pool(thread_pool const&) = delete;
+        thread_pool(thread_pool&&) = delete;
+        thread_pool& operator=(thread_pool const&) = delete;
+        thread_pool& operator=(thread_pool&&) = delete;
+
+        ~thread_pool() {
+
+            {
+                std::lock_guard lock { _mutex };
+                _stopping = true;
+                _tasks.clear();
+            }
+
+            _task_available.notify_all();
+            for (auto& thread : _threads) thread.join();
+
+        }
+
+        auto submit(std::function<void()> task) -> void {
+
+            {
+                std::lock_guard lock { _mutex };
+                _tasks.push_back(std::move(task));
+            }
+
+            _task_available.notify_one();
+
+        }
+
+        auto get_thread_count() const { return _threads.size(); }
+
+    private:
+
+        auto work() -> void {
+
+            while (true) {
+
+                std::function<void()> task;
+
+                {
+                    std::unique_lock lock { _mutex };
+                    _task_available.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+                    if (_stopping) return;
+
+                    task = std::move(_tasks.front());
+                    _tasks.pop_front();
+                }
+
+                task();
+
+            }
+
+        }
+
+        std::mutex _mutex;
+        std::condition_variable _task_available;
+        std::deque<std::function<void()>> _tasks;
+        std::vector<std::thread> _threads;
+        bool _stopping = false;
+
+    };
+
+}
@@ -0,0 +1,191 @@
+#include <array>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CHROME_UTF8_SSE2
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#include <utility/utf8.hpp>
+
+namespace utility {
+
+    namespace {
+
+        constexpr auto replacement_character = char16_t { 0xfffd };
+
+        auto count_trailing_zeros(std::uint32_t const value) {
+
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanForward(&index, value);
+            return static_cast<std::size_t>(index);
+#else
+            return static_cast<std::size_t>(__builtin_ctz(value));
+#endif
+
+        }
+
+        // What a lead byte says about its sequence. The range allowed for the second byte is what rules out
+        // overlong forms, surrogates and anything past U+10FFFF, as in table 3-7 of the Unicode standard.
+        struct lead_byte {
+            std::uint8_t trailing = 0; // Zero for bytes that can't start a sequence.
+            std::uint8_t payload_mask = 0;
+            std::uint8_t lower = 0x80, upper = 0xbf;
+            std::uint32_t continuation_mask = 0; // The top two bits of the third and fourth byte it needs, little endian.
+        };
+
+        constexpr auto lead_bytes = [] {
+
+            std::array<lead_byte, 256> table {};
+
+            for (auto lead = 0xc2; lead < 0xe0; ++lead) table[lead] = { 1, 0x1f, 0x80, 0xbf, 0 };
+            for (auto lead = 0xe0; lead < 0xf0; ++lead) table[lead] = { 2, 0x0f, 0x80, 0xbf, 0x00c00000u };
+            for (auto lead = 0xf0; lead < 0xf5; ++lead) table[lead] = { 3, 0x07, 0x80, 0xbf, 0xc0c00000u };
+
+            table[0xe0].lower = 0xa0;
+            table[0xed].upper = 0x9f;
+            table[0xf0].lower = 0x90;
+            table[0xf4].upper = 0x8f;
+
+            return table;
+
+        }();
+
+        // A single multibyte sequence starting at position, which points at a byte of 0x80 or more.
+        auto decode_sequence(unsigned char const* input, std::size_t const size, std::size_t& position, char16_t*& output, std::size_t& invalid_sequences) {
+
+            auto& lead = lead_bytes[input[position]];
+            std::size_t trailing = lead.trailing;
+
+            // Whatever was valid so far is replaced as a whole, the offending byte starts over.
+            auto replace = [&](std::size_t const length) {
+                *output++ = replacement_character;
+                ++invalid_sequences;
+                position += length;
+            };
+
+            // Stray continuation bytes and leads that can't start anything valid.
+            if (trailing == 0) return replace(1);
+
+            // With four bytes to read the sequence is put together without branching on its length, which
+            // is what mixed scripts would mispredict on. Anything invalid takes the careful way below.
+            if (size - position >= 4) {
+
+                std::uint32_t bytes;
+                std::memcpy(&bytes, input + position, sizeof(bytes));
+
+                auto second = (bytes >> 8) & 0xffu;
+                auto continuation_mask = lead.continuation_mask;
+
+                if (second >= lead.lower && second <= lead.upper && (bytes & continuation_mask) == (continuation_mask & 0x80808080u)) {
+
+                    auto code_point = ((bytes & lead.payload_mask) << 18) | ((bytes & 0x3f00u) << 4)
+                        | ((bytes >> 10) & 0xfc0u) | ((bytes >> 24) & 0x3fu);
+                    code_point >>= 6 * (3 - trailing);
+
+                    // Both units are always written, the second is overwritten by whatever follows if not needed.
+                    auto is_pair = code_point >= 0x10000;
+                    auto offset = code_point - 0x10000;
+                    output[0] = static_cast<char16_t>(is_pair ? 0xd800 + (offset >> 10) : code_point);
+                    output[1] = static_cast<char16_t>(0xdc00 + (offset & 0x3ffu));
+                    output += 1 + is_pair;
+
+                    position += trailing + 1;
+                    return;
+
+                }
+
+            }
+
+            auto available = size - position - 1;
+            auto second = available > 0 ? input[position + 1] : 0;
+            if (second < lead.lower || second > lead.upper) return replace(1);
+
+            std::uint32_t code_point = ((input[position] & lead.payload_mask) << 6) | (second & 0x3fu);
+
+            for (std::size_t i = 2; i <= trailing; ++i) {
+                if (i > available || (input[position + i] & 0xc0u) != 0x80u) return replace(i);
+                code_point = (code_point << 6) | (input[position + i] & 0x3fu);
+            }
+
+            position += trailing + 1;
+
+            if (code_point < 0x10000) { *output++ = static_cast<char16_t>(code_point); return; }
+
+            code_point -= 0x10000;
+            *output++ = static_cast<char16_t>(0xd800 + (code_point >> 10));
+            *output++ = static_cast<char16_t>(0xdc00 + (code_point & 0x3ffu));
+
+        }
+
+    }
+
+    auto transcode_utf8_to_utf16(std::string_view utf8, char16_t* output) -> transcode_result {
+
+        auto input = reinterpret_cast<unsigned char const*>(utf8.data());
+        auto size = utf8.size();
+        auto start = output;
+
+        std::size_t position = 0;
+        std::size_t invalid_sequences = 0;
+
+        while (position < size) {
+
+#if defined(CHROME_UTF8_SSE2)
+            // ASCII is widened by interleaving with zeros, the first non-ASCII byte is found from the sign bits.
+            auto zero = _mm_setzero_si128();
+            while (position + 16 <= size) {
+
+                auto bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(input + position));
+                auto non_ascii = static_cast<std::uint32_t>(_mm_movemask_epi8(bytes));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_unpacklo_epi8(bytes, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 8), _mm_unpackhi_epi8(bytes, zero));
+
+                // Storing all 16 is fine either way, the output has room for them and the units past the
+                // ASCII prefix are overwritten by what follows.
+                if (non_ascii != 0) {
+                    auto prefix = count_trailing_zeros(non_ascii);
+                    position += prefix;
+                    output += prefix;
+                    break;
+                }
+
+                position += 16;
+                output += 16;
+
+            }
+#else
+            // Eight bytes at a time is as far as plain integers go.
+            while (position + 8 <= size) {
+
+                std::uint64_t bytes;
+                std::memcpy(&bytes, input + position, sizeof(bytes));
+                if ((bytes & 0x8080808080808080ull) != 0) break;
+
+                for (std::size_t i = 0; i < 8; ++i) output[i] = input[position + i];
+                position += 8;
+                output += 8;
+
+            }
+#endif
+
+            // The tail, or whatever wasn't ASCII, a character at a time. Text that isn't ASCII comes in runs,
+            // so vectors are only tried again once one ends.
+            if (position == size) break;
+
+            if (input[position] < 0x80) { *output++ = input[position++]; continue; }
+            while (position < size && input[position] >= 0x80) decode_sequence(input, size, position, output, invalid_sequences);
+
+        }
+
+        return { static_cast<std::size_t>(output - start), invalid_sequences };
+
+    }
+
+}
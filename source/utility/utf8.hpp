@@ -0,0 +1,82 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+// Portable UTF-8 to UTF-16 transcoding, in place of MultiByteToWideChar. Malformed input is replaced the
+// way MultiByteToWideChar does it, one U+FFFD per maximal invalid subsequence, and counted so callers that
+// care can tell. Every UTF-8 byte turns into at most one UTF-16 unit, so an output with room for as many
+// units as there are input bytes never overflows and the length doesn't have to be worked out up front.
+
+namespace utility {
+
+    struct transcode_result {
+        std::size_t length = 0;             // UTF-16 units written.
+        std::size_t invalid_sequences = 0;  // Replaced with U+FFFD.
+    };
+
+    // Output needs room for utf8.size() units. Runs of ASCII are widened 16 bytes at a time.
+    auto transcode_utf8_to_utf16(std::string_view utf8, char16_t* output) -> transcode_result;
+
+    // Null terminated UTF-16 with inline storage for short strings, labels and font names never touch the heap.
+    // Longer strings go to a heap buffer that's kept for the next assign, so a reused buffer stops allocating too.
+    template <std::size_t InlineCapacity = 128>
+    struct utf16_buffer {
+
+        utf16_buffer() = default;
+        explicit utf16_buffer(std::string_view utf8) { assign(utf8); }
+
+        // Points into itself, so it stays where it was made.
+        utf16_buffer(utf16_buffer const&) = delete;
+        utf16_buffer(utf16_buffer&&) = delete;
+        utf16_buffer& operator=(utf16_buffer const&) = delete;
+        utf16_buffer& operator=(utf16_buffer&&) = delete;
+
+        ~utf16_buffer() = default;
+
+        auto assign(std::string_view utf8) -> transcode_result {
+
+            reserve(utf8.size() + 1);
+
+            auto result = transcode_utf8_to_utf16(utf8, _data);
+            _data[result.length] = u'\0';
+            _size = result.length;
+
+            return result;
+
+        }
+
+        auto c_str() const -> char16_t const* { return _data; }
+        auto size() const { return _size; }
+        auto view() const { return std::u16string_view { _data, _size }; }
+
+        auto is_inline() const { return _data == _inline; }
+
+    private:
+
+        auto reserve(std::size_t const capacity) -> void {
+
+            if (capacity <= _capacity) return;
+
+            // Not value initialized, everything read was written by the transcoder first.
+            _heap.reset(new char16_t[capacity]);
+            _data = _heap.get();
+            _capacity = capacity;
+
+        }
+
+        char16_t _inline[InlineCapacity];
+        std::unique_ptr<char16_t[]> _heap;
+
+        char16_t* _data = _inline;
+        std::size_t _size = 0;
+        std::size_t _capacity = InlineCapacity;
+
+    };
+
+}
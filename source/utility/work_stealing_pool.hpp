@@ -0,0 +1,188 @@
+// Copyright 2019 Domagoj "oberth" Panda
+// MIT license | Read LICENSE.txt for details.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace utility {
+
+    // Fork-join pool for data parallel work such as rasterizing tiles. Every worker starts out with an even,
+    // contiguous share of the indices and takes them front to back. Once done it steals the back half of
+    // whatever another worker has left, so uneven work (a tile full of text next to an empty one) evens out.
+    // The calling thread works along as worker 0. Tasks must not throw.
+    struct work_stealing_pool {
+
+        using task = std::function<void(std::size_t index, std::size_t worker)>;
+
+        // Counting the calling thread, zero for one per hardware thread.
+        explicit work_stealing_pool(std::size_t worker_count = 0) {
+
+            if (worker_count == 0) worker_count = std::max(1u, std::thread::hardware_concurrency());
+
+            _worker_count = worker_count;
+            _queues = std::make_unique<queue[]>(worker_count);
+
+            _threads.reserve(worker_count - 1);
+            for (std::size_t worker = 1; worker < worker_count; ++worker)
+                _threads.emplace_back([this, worker] { work(worker); });
+
+        }
+
+        work_stealing_pool(work_stealing_pool const&) = delete;
+        work_stealing_pool(work_stealing_pool&&) = delete;
+        work_stealing_pool& operator=(work_stealing_pool const&) = delete;
+        work_stealing_pool& operator=(work_stealing_pool&&) = delete;
+
+        ~work_stealing_pool() {
+
+            {
+                std::lock_guard lock { _mutex };
+                _stopping = true;
+            }
+
+            _job_available.notify_all();
+            for (auto& thread : _threads) thread.join();
+
+        }
+
+        // Runs the task for every index in [0, count) and returns once all of them are done.
+        // Which worker runs which index varies from run to run.
+        auto run(std::size_t const count, task const& function) -> void {
+
+            if (count == 0) return;
+
+            for (std::size_t worker = 0; worker < _worker_count; ++worker) {
+                std::lock_guard lock { _queues[worker].mutex };
+                _queues[worker].begin = count * worker / _worker_count;
+                _queues[worker].end = count * (worker + 1) / _worker_count;
+            }
+
+            {
+                std::lock_guard lock { _mutex };
+                _task = &function;
+                _busy_workers = _worker_count - 1;
+                ++_generation;
+            }
+
+            _job_available.notify_all();
+            execute(0);
+
+            // Helpers can still be in the middle of their last index.
+            std::unique_lock lock { _mutex };
+            _job_done.wait(lock, [this] { return _busy_workers == 0; });
+            _task = nullptr;
+
+        }
+
+        auto get_worker_count() const { return _worker_count; }
+
+        // Ranges taken from another worker, since the pool came up.
+        auto get_steal_count() const { return _steal_count.load(std::memory_order_relaxed); }
+
+    private:
+
+        struct alignas(64) queue {
+            std::mutex mutex;
+            std::size_t begin = 0, end = 0;
+        };
+
+        auto work(std::size_t const worker) -> void {
+
+            std::uint64_t generation = 0;
+
+            while (true) {
+
+                {
+                    std::unique_lock lock { _mutex };
+                    _job_available.wait(lock, [this, generation] { return _stopping || _generation != generation; });
+                    if (_stopping) return;
+                    generation = _generation;
+                }
+
+                execute(worker);
+
+                std::lock_guard lock { _mutex };
+                if (--_busy_workers == 0) _job_done.notify_one();
+
+            }
+
+        }
+
+        auto execute(std::size_t const worker) -> void {
+
+            while (auto index = take(worker)) (*_task)(*index, worker);
+
+        }
+
+        auto take(std::size_t const worker) -> std::optional<std::size_t> {
+
+            if (auto index = pop(worker)) return index;
+
+            // Starting after ourselves spreads thieves over different victims.
+            for (std::size_t offset = 1; offset < _worker_count; ++offset) {
+
+                auto& victim = _queues[(worker + offset) % _worker_count];
+                std::size_t begin, end;
+
+                {
+                    std::lock_guard lock { victim.mutex };
+                    if (victim.begin == victim.end) continue;
+
+                    auto stolen = (victim.end - victim.begin + 1) / 2;
+                    begin = victim.end - stolen;
+                    end = victim.end;
+                    victim.end = begin;
+                }
+
+                _steal_count.fetch_add(1, std::memory_order_relaxed);
+
+                // The first stolen index runs right away, the rest can be stolen in turn.
+                std::lock_guard lock { _queues[worker].mutex };
+                _queues[worker].begin = begin + 1;
+                _queues[worker].end = end;
+
+                return begin;
+
+            }
+
+            return std::nullopt;
+
+        }
+
+        auto pop(std::size_t const worker) -> std::optional<std::size_t> {
+
+            auto& own = _queues[worker];
+            std::lock_guard lock { own.mutex };
+
+            if (own.begin == own.end) return std::nullopt;
+            return own.begin++;
+
+        }
+
+        std::size_t _worker_count = 1;
+        std::unique_ptr<queue[]> _queues;
+        std::atomic<std::uint64_t> _steal_count { 0 };
+
+        std::mutex _mutex;
+        std::condition_variable _job_available, _job_done;
+        task const* _task = nullptr;
+        std::size_t _busy_workers = 0;
+        std::uint64_t _generation = 0;
+        bool _stopping = false;
+
+        std::vector<std::thread> _threads;
+
+    };
+
+}